@@ -13,6 +13,10 @@
 
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
 // Function pointer definition for the specifiable ADC value handler
 typedef void (*valueHandler_t)(uint32_t);
 
@@ -29,4 +33,13 @@ void adcTrigger(void);
 //          as it is executed on every ADC conversion interrupt
 void adcInit(valueHandler_t);
 
+
+// Interrupt handler for completion of ADC conversion.
+// Public so that tools/bench can time it.
+void adcIntHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*ADC_MODULE_H_*/
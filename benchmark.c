@@ -0,0 +1,238 @@
+// ************************************************************
+// benchmark.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Measure what the hot paths of the firmware cost per call on the
+// board.
+// Explaination: benchmarks[] lists each function with its setup. The
+// benchmarks work on their own copies of the state, trajectories and windows
+// so the real ones are not disturbed. Functions which can only work on the
+// live module state are not included: heightUpdate would replace the real
+// average, controlUpdate would move the real trajectories and measurements,
+// buttonsUpdate would count debounce samples which never happened, and the
+// interrupt handlers would count encoder edges and ADC samples. Their cost in
+// place is measured by the probes, see probe.h, and tools/bench benchmarks
+// them on the host, where the firmware's state is its own.
+// ************************************************************
+
+#include <stdarg.h>
+
+#include "benchmark.h"
+#include "control.h"
+#include "landingController.h"
+#include "trajectory.h"
+#include "windowStats.h"
+#include "lineFormat.h"
+#include "uartDisplay.h"
+#include "telemetry.h"
+#include "timerer.h"
+#include "probe.h"
+#include "utils/ustdlib.h"
+
+#define BENCHMARK_LINE_LENGTH 128
+#define NS_PER_MS 1000000
+
+typedef struct {
+    const char* name;
+    void (*setup)(void);  // 0 for none
+    void (*run)(uint32_t call);  // call counts from 0 to BENCHMARK_CALLS - 1
+} benchmark_t;
+
+static bool isRunning = false;
+static uint32_t next = 0;  // index of the next benchmark to run
+
+// inputs for the benchmarks
+static state_t benchState;
+static landing_controller_t benchLanding;
+static trajectory_t benchTrajectory;
+static window_stats_t benchWindow;
+static line_format_t benchFormat;
+static char benchLine[UART_LINE_LENGTH + 1];
+
+
+//
+// Benchmarks
+//
+
+
+static void setupState(void)
+{
+    benchState.heliMode = STATE_LANDED;
+    benchState.targetHeight = 0;
+    benchState.targetYaw = 0;
+}
+
+
+static void setupLanding(void)
+{
+    setupState();
+    landingControllerReset(&benchLanding);
+}
+
+
+static void runLandingControllerUpdate(uint32_t call)
+{
+    // yaw 1 degree past a whole rotation
+    landingControllerUpdate(&benchState, 10, 361 * PRECISION);
+}
+
+
+static void runLandingControllerIsStable(uint32_t call)
+{
+    // small wobble around the landing position
+    int32_t wobble = (call & 1) ? PRECISION / 4 : -PRECISION / 4;
+    landingControllerIsStable(&benchLanding, &benchState, 10, wobble, PRECISION / 2 + wobble);
+}
+
+
+static void setupTrajectory(void)
+{
+    trajectoryInit(&benchTrajectory, 30 * PRECISION, 60 * PRECISION);
+}
+
+
+static void runTrajectoryUpdate(uint32_t call)
+{
+    // a step which is never reached, so the reference is always moving
+    trajectoryUpdate(&benchTrajectory, 50 * PRECISION, 10);
+}
+
+
+static void setupWindowStats(void)
+{
+    windowStatsInit(&benchWindow, 300);
+}
+
+
+static void runWindowStatsAdd(uint32_t call)
+{
+    windowStatsAdd(&benchWindow, call * PRECISION, 10);
+}
+
+
+// the formatting done by uartPrintLineWithFormat(..), without queueing on the UART
+static void runUsnprintf(uint32_t call)
+{
+    usnprintf(benchLine, sizeof(benchLine), "ALT %d [%d] %%\n", 50, (int32_t)call);
+}
+
+
+static void setupLineFormat(void)
+{
+    lineFormatCompile(&benchFormat, "ALT %d [%d] %%\n");
+}
+
+
+static int formatCompiled(char* str, uint32_t size, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, size);
+    length = lineFormatApply(&benchFormat, str, size, args);
+    va_end(args);
+    return length;
+}
+
+
+// the formatting done by uartPrintLineWithCompiled(..), without queueing on the UART
+static void runLineFormatApply(uint32_t call)
+{
+    formatCompiled(benchLine, sizeof(benchLine), 50, (int32_t)call);
+}
+
+
+static const benchmark_t benchmarks[] = {
+    // name, setup, run
+    {"landingControllerUpdate", setupLanding, runLandingControllerUpdate},
+    {"landingControllerIsStable", setupLanding, runLandingControllerIsStable},
+    {"trajectoryUpdate", setupTrajectory, runTrajectoryUpdate},
+    {"windowStatsAdd", setupWindowStats, runWindowStatsAdd},
+    {"usnprintf", 0, runUsnprintf},
+    {"lineFormatApply", setupLineFormat, runLineFormatApply}
+    // add benchmarks here
+};
+
+#define NUM_BENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+
+// Run the benchmarks, starting from the next call to benchmarkUpdate(..).
+void benchmarkStart(void)
+{
+    isRunning = true;
+    next = 0;
+}
+
+
+// The benchmarks one at a time, for tools/bench. Return the number of benchmarks
+// and the name of one, set one up, and make one call of it.
+uint32_t benchmarkNum(void)
+{
+    return NUM_BENCHMARKS;
+}
+
+
+const char* benchmarkName(uint32_t index)
+{
+    return benchmarks[index].name;
+}
+
+
+void benchmarkSetup(uint32_t index)
+{
+    if (benchmarks[index].setup) {
+        benchmarks[index].setup();
+    }
+}
+
+
+void benchmarkCall(uint32_t index, uint32_t call)
+{
+    benchmarks[index].run(call);
+}
+
+
+// Task to run one benchmark per call and send its result, until all have run.
+// Only put in the task table of the landed mode, since a run takes several ms
+// which the flying tasks can't spare.
+void benchmarkUpdate(state_t* state, uint32_t deltaTime)
+{
+    char line[BENCHMARK_LINE_LENGTH];
+    uint32_t call, min = UINT32_MAX, total = 0;
+
+    // wait for the previous result to be sent, so none are dropped, and don't put
+    // text into the middle of a binary stream or a trace dump
+    if (!isRunning || uartTxSpace() < BENCHMARK_LINE_LENGTH || !telemetryIsTextAllowed()) {
+        return;
+    }
+
+    const benchmark_t* benchmark = &benchmarks[next];
+    benchmarkSetup(next);
+
+    for (call = 0; call < BENCHMARK_CALLS; call++) {
+        uint32_t start = PROBE_CYCLES();
+        benchmark->run(call);
+        uint32_t cycles = PROBE_CYCLES() - start;
+
+        total += cycles;
+        if (cycles < min) {
+            min = cycles;
+        }
+    }
+
+    // the cycle counter counts the system clock, as the timer does
+    uint32_t mean = total / BENCHMARK_CALLS;
+    uint32_t ns = (uint64_t)mean * NS_PER_MS / timererMsToTicks(1);
+
+    usnprintf(line, sizeof(line),
+              "{\"bench\":\"%s\",\"calls\":%d,\"min\":%u,\"mean\":%u,\"ns\":%u}\r\n",
+              benchmark->name, BENCHMARK_CALLS, min, mean, ns);
+    uartSend(line);
+
+    next++;
+    if (next >= NUM_BENCHMARKS) {
+        isRunning = false;
+    }
+}
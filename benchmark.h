@@ -0,0 +1,55 @@
+// ************************************************************
+// benchmark.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Measure what the hot paths of the firmware cost per call on the
+// board.
+// Explaination: Each benchmark calls one function BENCHMARK_CALLS times with
+// realistic inputs and times every call with the DWT cycle counter
+// (PROBE_CYCLES()). The results are sent over UART as one JSON object per line:
+//   {"bench":"trajectoryUpdate","calls":64,"min":812,"mean":830,"ns":41500}
+// min and mean are in cycles, ns is the mean in nanoseconds. tools/benchCompare
+// compares the lines with those from a previous build to find regressions.
+// tools/bench runs the same benchmarks on the host, with those which need the
+// live module state.
+// ************************************************************
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stateInfo.h"
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define BENCHMARK_CALLS 64
+
+
+// Run the benchmarks, starting from the next call to benchmarkUpdate(..).
+void benchmarkStart(void);
+
+
+// Task to run one benchmark per call and send its result, until all have run.
+// Only put in the task table of the landed mode, since a run takes several ms
+// which the flying tasks can't spare.
+void benchmarkUpdate(state_t* state, uint32_t deltaTime);
+
+
+// The benchmarks one at a time, for tools/bench. Return the number of benchmarks
+// and the name of one, set one up, and make one call of it.
+uint32_t benchmarkNum(void);
+const char* benchmarkName(uint32_t index);
+void benchmarkSetup(uint32_t index);
+void benchmarkCall(uint32_t index, uint32_t call);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCHMARK_H_ */
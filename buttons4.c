@@ -17,124 +17,197 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "inc/hw_memmap.h"
-#include "inc/hw_types.h"
-#include "driverlib/gpio.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/debug.h"
-#include "inc/tm4c123gh6pm.h"  // Board specific defines (for PF0)
+#include "hal.h"
 #include "buttons4.h"
+#include "timerer.h"
+#include "recorder.h"
 
 
+// in butNames order
+static const bool but_normal[NUM_BUTS] = {UP_BUT_NORMAL, DOWN_BUT_NORMAL,
+    LEFT_BUT_NORMAL, RIGHT_BUT_NORMAL, SW1_NORMAL, SW2_NORMAL};
+static const bool but_repeats[NUM_BUTS] = {true, true, true, true, false, false};
+
 // Globals to module
-static bool but_state[NUM_BUTS];	// Corresponds to the electrical state
-static uint8_t but_count[NUM_BUTS];
-static bool but_flag[NUM_BUTS];
-static bool but_normal[NUM_BUTS];   // Corresponds to the electrical state
+static volatile bool but_state[NUM_BUTS];	// Corresponds to the electrical state
+static volatile bool but_flag[NUM_BUTS];
+static volatile bool but_unsettled[NUM_BUTS];  // an edge was ignored during the debounce time
+static volatile uint32_t but_changedAt[NUM_BUTS];  // timer ticks of the last accepted change
+static uint32_t but_nextRepeatAt[NUM_BUTS];  // ticks held before the next long push or repeat event
+static uint8_t but_repeatCount[NUM_BUTS];
+static void (*but_pushHandler[NUM_BUTS])(void);
+
+static uint32_t debounceTicks, longPushTicks, repeatTicks;
+
+// Queue of button events. Written by the interrupts (and buttonsUpdate with interrupts
+// masked), read by buttonsGetEvent.
+static button_event_t eventQueue[BUT_EVENT_QUEUE_SIZE];
+static volatile uint32_t eventHead = 0;
+static volatile uint32_t eventTail = 0;
+static volatile uint32_t eventsDropped = 0;
+
+
+// Add an event to the queue, or count it as dropped if the queue is full.
+// Must be called from an interrupt or with interrupts masked.
+static void pushEvent(uint8_t butName, uint8_t type, uint32_t time)
+{
+    uint32_t next = (eventHead + 1) % BUT_EVENT_QUEUE_SIZE;
+
+    if (next == eventTail) {
+        eventsDropped++;
+        return;
+    }
+    eventQueue[eventHead].button = butName;
+    eventQueue[eventHead].type = type;
+    eventQueue[eventHead].time = time;
+    eventHead = next;
+}
+
+
+// Accept a new logical state for a button. Sets its flag and queues an event.
+// Must be called from an interrupt or with interrupts masked.
+static void acceptChange(uint8_t butName, bool value, uint32_t now)
+{
+    bool isPushed = value != but_normal[butName];
+
+    but_state[butName] = value;
+    but_flag[butName] = true;	   // Reset by call to checkButton()
+    but_changedAt[butName] = now;
+    but_unsettled[butName] = false;
+    but_nextRepeatAt[butName] = longPushTicks;
+    but_repeatCount[butName] = 0;
+    pushEvent(butName, isPushed ? BUT_EV_PUSHED : BUT_EV_RELEASED, now);
+
+    if (isPushed && but_pushHandler[butName]) {
+        but_pushHandler[butName]();
+    }
+}
+
+
+// buttonsIntHandler: Handles edges on any of the button pins. The first edge
+// after the debounce time is accepted straight away and later edges (bounces)
+// within the debounce time are ignored. If the pin settles in a different state
+// to the one accepted, buttonsUpdate picks it up once the debounce time is over.
+void buttonsIntHandler (void)
+{
+    uint32_t now = timererGetTicks();
+    uint32_t status = halButtonsIntStatus ();
+    uint32_t levels = halButtonsRead ();
+    int i;
+
+    for (i = 0; i < NUM_BUTS; i++)
+    {
+        if (!(status & (1 << i)))
+            continue;
+
+        // Read the pin; true means HIGH, false means LOW
+        bool value = (levels & (1 << i)) != 0;
+        recorderAddEvent(RECORDER_EV_BUTTON, i << 1 | value, now);  // every edge, bounces too
+        if (value == but_state[i])
+            continue;  // bounced back already
+
+        if (timererTicksSince (but_changedAt[i]) < debounceTicks)
+            but_unsettled[i] = true;
+        else
+            acceptChange (i, value, now);
+    }
+}
 
 
 // buttonsInit: Initialise the variables associated with the set of buttons
-// defined by the constants in the buttons2.h header file.
+// defined by the constants in the buttons4.h header file.
 void buttonsInit (void)
 {
 	int i;
 
-	// UP button (active HIGH)
-    SysCtlPeripheralEnable (UP_BUT_PERIPH);
-    GPIOPinTypeGPIOInput (UP_BUT_PORT_BASE, UP_BUT_PIN);
-    GPIOPadConfigSet (UP_BUT_PORT_BASE, UP_BUT_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPD);
-    but_normal[UP] = UP_BUT_NORMAL;
-	// DOWN button (active HIGH)
-    SysCtlPeripheralEnable (DOWN_BUT_PERIPH);
-    GPIOPinTypeGPIOInput (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN);
-    GPIOPadConfigSet (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPD);
-    but_normal[DOWN] = DOWN_BUT_NORMAL;
-    // LEFT button (active LOW)
-    SysCtlPeripheralEnable (LEFT_BUT_PERIPH);
-    GPIOPinTypeGPIOInput (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN);
-    GPIOPadConfigSet (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPU);
-    but_normal[LEFT] = LEFT_BUT_NORMAL;
-    // RIGHT button (active LOW)
-      // Note that PF0 is one of a handful of GPIO pins that need to be
-      // "unlocked" before they can be reconfigured.  This also requires
-      //      #include "inc/tm4c123gh6pm.h"
-    SysCtlPeripheralEnable (RIGHT_BUT_PERIPH);
-    //---Unlock PF0 for the right button:
-    GPIO_PORTF_LOCK_R = GPIO_LOCK_KEY;
-    GPIO_PORTF_CR_R |= GPIO_PIN_0; //PF0 unlocked
-    GPIO_PORTF_LOCK_R = GPIO_LOCK_M;
-    GPIOPinTypeGPIOInput (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN);
-    GPIOPadConfigSet (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPU);
-    but_normal[RIGHT] = RIGHT_BUT_NORMAL;
-    //#SW1 slde switch (active HIGH)
-    SysCtlPeripheralEnable (SW1_PERIPH);
-    GPIOPinTypeGPIOInput (SW1_PORT_BASE, SW1_PIN);
-    GPIOPadConfigSet (SW1_PORT_BASE, SW1_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPD);
-    but_normal[SW1] = SW1_NORMAL;
-    //#SW2 slde switch (active LOW)
-    SysCtlPeripheralEnable (SW2_PERIPH);
-    GPIOPinTypeGPIOInput (SW2_PORT_BASE, SW2_PIN);
-    GPIOPadConfigSet (SW2_PORT_BASE, SW2_PIN, GPIO_STRENGTH_2MA,
-       GPIO_PIN_TYPE_STD_WPU);
-    but_normal[SW2] = SW2_NORMAL;
+    debounceTicks = timererMsToTicks (BUT_DEBOUNCE_MS);
+    longPushTicks = timererMsToTicks (BUT_LONG_PUSH_MS);
+    repeatTicks = timererMsToTicks (BUT_REPEAT_MS);
 
     // init to whatever state the switch is in
 	for (i = 0; i < NUM_BUTS; i++)
 	{
 		but_state[i] = but_normal[i];
-		but_count[i] = 0;
 		but_flag[i] = false;
+		but_unsettled[i] = false;
+		but_changedAt[i] = timererGetTicks ();
+		but_pushHandler[i] = 0;
 	}
-	but_state[SW1] = (GPIOPinRead (SW1_PORT_BASE, SW1_PIN) == SW1_PIN);
-	but_state[SW2] = (GPIOPinRead (SW2_PORT_BASE, SW2_PIN) == SW2_PIN);
+	// configure the pins to interrupt on both edges, then read the switches,
+	// which may start in either position
+	halButtonsInit (buttonsIntHandler);
+	but_state[SW1] = (halButtonsRead () & (1 << SW1)) != 0;
+	but_state[SW2] = (halButtonsRead () & (1 << SW2)) != 0;
 }
 
 
-// buttonsUpdate: Function designed to be called regularly. It polls all
-// buttons once and updates variables associated with the buttons if
-// necessary.  It is efficient enough to be part of an ISR, e.g. from
-// a SysTick interrupt.
-// Debounce algorithm: A state machine is associated with each button.
-// A state change occurs only after NUM_BUT_POLLS consecutive polls have
-// read the pin in the opposite condition, before the state changes and
-// a flag is set.  Set NUM_BUT_POLLS according to the polling rate.
+// buttonsUpdate: Function designed to be called regularly by the task which
+// reads the buttons. Does no work for buttons which are settled and released.
+// Accepts the final state of buttons which were still bouncing at the end of
+// the debounce time, and queues long push and auto-repeat events for held
+// buttons.
 void buttonsUpdate (void)
 {
-	bool but_value[NUM_BUTS];
 	int i;
-	
-	// Read the pins; true means HIGH, false means LOW
-	but_value[UP] = (GPIOPinRead (UP_BUT_PORT_BASE, UP_BUT_PIN) == UP_BUT_PIN);
-	but_value[DOWN] = (GPIOPinRead (DOWN_BUT_PORT_BASE, DOWN_BUT_PIN) == DOWN_BUT_PIN);
-    but_value[LEFT] = (GPIOPinRead (LEFT_BUT_PORT_BASE, LEFT_BUT_PIN) == LEFT_BUT_PIN);
-    but_value[RIGHT] = (GPIOPinRead (RIGHT_BUT_PORT_BASE, RIGHT_BUT_PIN) == RIGHT_BUT_PIN);
-    //#
-    but_value[SW1] = (GPIOPinRead (SW1_PORT_BASE, SW1_PIN) == SW1_PIN);
-    but_value[SW2] = (GPIOPinRead (SW2_PORT_BASE, SW2_PIN) == SW2_PIN);
-    // Iterate through the buttons, updating button variables as required
+
 	for (i = 0; i < NUM_BUTS; i++)
 	{
-        if (but_value[i] != but_state[i])
+        if (but_unsettled[i] && timererTicksSince (but_changedAt[i]) >= debounceTicks)
         {
-        	but_count[i]++;
-        	if (but_count[i] >= NUM_BUT_POLLS)
-        	{
-        		but_state[i] = but_value[i];
-        		but_flag[i] = true;	   // Reset by call to checkButton()
-        		but_count[i] = 0;
-        	}
+            bool value = (halButtonsRead () & (1 << i)) != 0;
+            bool prevIntState = halInterruptsDisable ();
+            but_unsettled[i] = false;
+            if (value != but_state[i])
+                acceptChange (i, value, timererGetTicks ());
+            if (!prevIntState)
+                halInterruptsEnable ();
+        }
+
+        if (but_repeats[i] && but_state[i] != but_normal[i])
+        {
+            uint32_t held = timererTicksSince (but_changedAt[i]);
+            if (held >= but_nextRepeatAt[i])
+            {
+                bool prevIntState = halInterruptsDisable ();
+                pushEvent (i, but_repeatCount[i] ? BUT_EV_REPEATED : BUT_EV_LONG_PUSHED, timererGetTicks ());
+                if (!prevIntState)
+                    halInterruptsEnable ();
+                if (but_repeatCount[i] < UINT8_MAX)
+                    but_repeatCount[i]++;
+                but_nextRepeatAt[i] += repeatTicks;
+            }
         }
-        else
-        	but_count[i] = 0;
 	}
 }
 
 
+// buttonsGetEvent: Take the oldest button event from the queue. Returns false
+// if there are no events.
+bool buttonsGetEvent (button_event_t *event)
+{
+    if (eventTail == eventHead)
+        return false;
+    *event = eventQueue[eventTail];
+    eventTail = (eventTail + 1) % BUT_EVENT_QUEUE_SIZE;
+    return true;
+}
+
+
+// buttonsSetPushHandler: Call handler from the interrupt as soon as the button
+// is pushed. For actions which can't wait for a task, such as a reset.
+void buttonsSetPushHandler (uint8_t butName, void (*handler)(void))
+{
+    but_pushHandler[butName] = handler;
+}
+
+
+// buttonsEventsDropped: Return the number of events lost because the queue was full.
+uint32_t buttonsEventsDropped (void)
+{
+    return eventsDropped;
+}
+
+
 // buttonsCheck: Function returns the new button logical state if the button
 // logical state (PUSHED or RELEASED) has changed since the last call,
 // otherwise returns NO_CHANGE.
@@ -152,9 +225,16 @@ uint8_t buttonsCheck (uint8_t butName)
 }
 
 
-// ignore a change in state which may have occured for this button.
+// ignore a change in state which may have occured for this button, including
+// any of its events still in the queue.
 void buttonsIgnore(uint8_t butName)
 {
+    uint32_t i;
+
     but_flag[butName] = false;
+    for (i = eventTail; i != eventHead; i = (i + 1) % BUT_EVENT_QUEUE_SIZE) {
+        if (eventQueue[i].button == butName) {
+            eventQueue[i].button = NUM_BUTS;  // matches no button
+        }
+    }
 }
-
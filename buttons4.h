@@ -22,51 +22,38 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
 // Constants
 enum butNames {UP = 0, DOWN, LEFT, RIGHT, SW1, SW2, NUM_BUTS}; //# add SW1 add SW2
 enum butStates {RELEASED = 0, PUSHED, NO_CHANGE};
-
-// UP button
-#define UP_BUT_PERIPH  SYSCTL_PERIPH_GPIOE
-#define UP_BUT_PORT_BASE  GPIO_PORTE_BASE
-#define UP_BUT_PIN  GPIO_PIN_0
-#define UP_BUT_NORMAL  false
-
-// DOWN button
-#define DOWN_BUT_PERIPH  SYSCTL_PERIPH_GPIOD
-#define DOWN_BUT_PORT_BASE  GPIO_PORTD_BASE
-#define DOWN_BUT_PIN  GPIO_PIN_2
-#define DOWN_BUT_NORMAL  false
-
-// LEFT button
-#define LEFT_BUT_PERIPH  SYSCTL_PERIPH_GPIOF
-#define LEFT_BUT_PORT_BASE  GPIO_PORTF_BASE
-#define LEFT_BUT_PIN  GPIO_PIN_4
-#define LEFT_BUT_NORMAL  true
-
-// RIGHT button
-#define RIGHT_BUT_PERIPH  SYSCTL_PERIPH_GPIOF
-#define RIGHT_BUT_PORT_BASE  GPIO_PORTF_BASE
-#define RIGHT_BUT_PIN  GPIO_PIN_0
-#define RIGHT_BUT_NORMAL  true
-
-// SW1 slider switch
-#define SW1_PERIPH  SYSCTL_PERIPH_GPIOA
-#define SW1_PORT_BASE  GPIO_PORTA_BASE
-#define SW1_PIN  GPIO_PIN_7
-#define SW1_NORMAL  false
-
-// SW2 slider switch
-#define SW2_PERIPH  SYSCTL_PERIPH_GPIOA
-#define SW2_PORT_BASE  GPIO_PORTA_BASE
-#define SW2_PIN GPIO_PIN_6
-#define SW2_NORMAL true
-
-#define NUM_BUT_POLLS 3
-// Debounce algorithm: A state machine is associated with each button.
-// A state change occurs only after NUM_BUT_POLLS consecutive polls have
-// read the pin in the opposite condition, before the state changes and
-// a flag is set.  Set NUM_BUT_POLLS according to the polling rate.
+enum butEvents {BUT_EV_RELEASED = 0, BUT_EV_PUSHED, BUT_EV_LONG_PUSHED, BUT_EV_REPEATED};
+
+// A change to a button, queued by the interrupts in the order they happen
+typedef struct {
+    uint8_t button;  // one of butNames
+    uint8_t type;  // one of butEvents
+    uint32_t time;  // timer ticks when the event happened, see timererTicksSince
+} button_event_t;
+
+// The electrical state of each button when released. The pins are in halTiva.c.
+#define UP_BUT_NORMAL  false  // PE0
+#define DOWN_BUT_NORMAL  false  // PD2
+#define LEFT_BUT_NORMAL  true  // PF4
+#define RIGHT_BUT_NORMAL  true  // PF0
+#define SW1_NORMAL  false  // PA7, slider switch
+#define SW2_NORMAL  true  // PA6, slider switch
+
+#define BUT_DEBOUNCE_MS 20
+#define BUT_LONG_PUSH_MS 500  // held this long before a long push event
+#define BUT_REPEAT_MS 200  // then a repeat event this often (UP, DOWN, LEFT and RIGHT only)
+#define BUT_EVENT_QUEUE_SIZE 16
+// Debounce algorithm: Each pin interrupts on both edges. The first edge
+// after BUT_DEBOUNCE_MS of stability changes the state straight away,
+// sets a flag and queues an event. Edges within BUT_DEBOUNCE_MS of a
+// change are ignored, and the pin is read again once the time is over.
 
 
 // buttonsInit: Initialise the variables associated with the set of buttons
@@ -74,13 +61,28 @@ enum butStates {RELEASED = 0, PUSHED, NO_CHANGE};
 void buttonsInit (void);
 
 
-// updateButtons: Function designed to be called regularly. It polls all
-// buttons once and updates variables associated with the buttons if
-// necessary.  It is efficient enough to be part of an ISR, e.g. from
-// a SysTick interrupt.
+// buttonsUpdate: Function designed to be called regularly by the task which
+// reads the buttons. Does no work for buttons which are settled and released.
+// Accepts the final state of buttons which were still bouncing at the end of
+// the debounce time, and queues long push and auto-repeat events for held
+// buttons.
 void buttonsUpdate (void);
 
 
+// buttonsGetEvent: Take the oldest button event from the queue. Returns false
+// if there are no events.
+bool buttonsGetEvent (button_event_t *event);
+
+
+// buttonsSetPushHandler: Call handler from the interrupt as soon as the button
+// is pushed. For actions which can't wait for a task, such as a reset.
+void buttonsSetPushHandler (uint8_t butName, void (*handler)(void));
+
+
+// buttonsEventsDropped: Return the number of events lost because the queue was full.
+uint32_t buttonsEventsDropped (void);
+
+
 // checkButton: Function returns the new button state if the button state
 // (PUSHED or RELEASED) has changed since the last call, otherwise returns
 // NO_CHANGE.  The argument butName should be one of constants in the
@@ -88,7 +90,12 @@ void buttonsUpdate (void);
 uint8_t buttonsCheck (uint8_t butName);
 
 
-// ignore a change in state which may have occured for this button.
+// ignore a change in state which may have occured for this button, including
+// any of its events still in the queue.
 void buttonsIgnore(uint8_t butName);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*BUTTONS_H_*/
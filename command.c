@@ -0,0 +1,371 @@
+// ************************************************************
+// command.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Accept setpoint, mode and parameter commands over UART.
+// Explaination: Lines received on UART0 are parsed by a low priority task.
+// Accepted commands are held until the next control tick, when they are all
+// applied together by commandApply(..).
+// ************************************************************
+
+#include "command.h"
+#include "control.h"
+#include "uartDisplay.h"
+#include "telemetry.h"
+#include "benchmark.h"
+#include "probe.h"
+#include "trace.h"
+#include "report.h"
+#include "kernel.h"
+
+#define COMMAND_LINE_LENGTH 24  // longer lines are rejected
+#define COMMAND_MAX_CHARS_PER_UPDATE 32  // bound the time spent in each call
+#define COMMAND_MAX_HEIGHT 100  // %
+#define COMMAND_MAX_YAW 360  // degrees either way from the reference
+#define COMMAND_MAX_GAIN (10 * PRECISION)
+#define COMMAND_MAX_RECOVER_FRAMES 10000  // 100 s at the 100 Hz frame rate
+
+#define UPPER(c) ((c) >= 'a' && (c) <= 'z' ? (c) - 'a' + 'A' : (c))
+
+// Kinds of command, one per line
+typedef enum {
+    COMMAND_HEIGHT = 0,
+    COMMAND_YAW,
+    COMMAND_MODE,
+    COMMAND_GAIN,
+    COMMAND_PARAM,
+    COMMAND_SHED,
+    COMMAND_BENCHMARK,
+    COMMAND_DUMP,
+    COMMAND_TELEMETRY
+} command_type_t;
+
+// A parsed line, which only takes effect once the whole line is known to be valid
+typedef struct {
+    command_type_t type;
+    int32_t index;  // channel of a gain, which parameter, or the shed level
+    int32_t gain;  // control_gain_t
+    int32_t value;
+    char option;  // the letter after M, D or T
+} command_t;
+
+// Changes waiting for the next control tick
+typedef struct {
+    bool hasHeight;
+    int32_t targetHeight;
+    bool hasYaw;
+    int32_t targetYaw;
+    uint32_t gainMask[2];  // bit per control_gain_t, for the height and yaw channels
+    int32_t gains[2][CONTROL_NUM_GAINS];
+    uint32_t paramMask;  // bit per control_param_t
+    int32_t params[CONTROL_NUM_PARAMS];
+} pending_t;
+
+// largest value of each parameter, in control_param_t order. None can be negative.
+static const int32_t paramLimits[CONTROL_NUM_PARAMS] = {
+    100,  // main offset in %
+    10 * PRECISION,  // grav offset
+    10 * PRECISION  // torque constant
+};
+
+static pending_t pending;
+static command_mode_t modeRequest = COMMAND_MODE_NONE;
+static char line[COMMAND_LINE_LENGTH + 1];  // +1 for \0
+static uint32_t lineLength = 0;
+static bool isLineTooLong = false;
+
+
+// Skip spaces then read the next non space character. Returns '\0' at the end of the line.
+static char nextToken(const char** cursor)
+{
+    while (**cursor == ' ') {
+        (*cursor)++;
+    }
+    char c = **cursor;
+    if (c) {
+        (*cursor)++;
+    }
+    return UPPER(c);
+}
+
+
+// Skip spaces then read a signed decimal integer. Returns false if there is none
+// or it doesn't fit in an int32_t.
+static bool nextInt(const char** cursor, int32_t* value)
+{
+    bool isNegative = false;
+    int32_t n = 0;
+
+    while (**cursor == ' ') {
+        (*cursor)++;
+    }
+    if (**cursor == '-') {
+        isNegative = true;
+        (*cursor)++;
+    }
+    if (**cursor < '0' || **cursor > '9') {
+        return false;
+    }
+    while (**cursor >= '0' && **cursor <= '9') {
+        int32_t digit = **cursor - '0';
+        if (n > (INT32_MAX - digit) / 10) {
+            return false;
+        }
+        n = n * 10 + digit;
+        (*cursor)++;
+    }
+    *value = isNegative ? -n : n;
+    return true;
+}
+
+
+// Parse one complete line into command. Returns false if the line is not a valid
+// command, with nothing changed.
+static bool parseLine(const char* cursor, command_t* command)
+{
+    switch (nextToken(&cursor)) {
+    case 'H':
+        command->type = COMMAND_HEIGHT;
+        if (!nextInt(&cursor, &command->value) || command->value < 0 || command->value > COMMAND_MAX_HEIGHT)
+            return false;
+        break;
+
+    case 'Y':
+        command->type = COMMAND_YAW;
+        if (!nextInt(&cursor, &command->value) || command->value < -COMMAND_MAX_YAW || command->value > COMMAND_MAX_YAW)
+            return false;
+        break;
+
+    case 'M':
+        command->type = COMMAND_MODE;
+        command->option = nextToken(&cursor);
+        if (command->option != 'F' && command->option != 'L')
+            return false;
+        break;
+
+    case 'G':
+        command->type = COMMAND_GAIN;
+        switch (nextToken(&cursor)) {
+        case 'H':
+            command->index = 0;
+            break;
+        case 'Y':
+            command->index = 1;
+            break;
+        default:
+            return false;
+        }
+        switch (nextToken(&cursor)) {
+        case 'P':
+            command->gain = CONTROL_KP;
+            break;
+        case 'D':
+            command->gain = CONTROL_KD;
+            break;
+        case 'I':
+            command->gain = CONTROL_KI;
+            break;
+        default:
+            return false;
+        }
+        if (!nextInt(&cursor, &command->value) || command->value < 0 || command->value > COMMAND_MAX_GAIN)
+            return false;
+        break;
+
+    case 'P':
+        command->type = COMMAND_PARAM;
+        if (!nextInt(&cursor, &command->index) || command->index < 0 || command->index >= CONTROL_NUM_PARAMS)
+            return false;
+        if (!nextInt(&cursor, &command->value) || command->value < 0 || command->value > paramLimits[command->index])
+            return false;
+        break;
+
+    case 'S':
+        command->type = COMMAND_SHED;
+        if (!nextInt(&cursor, &command->index) || command->index < 0 || command->index > KERNEL_MAX_SHED_LEVEL)
+            return false;
+        if (!nextInt(&cursor, &command->value) || command->value < 1 || command->value > COMMAND_MAX_RECOVER_FRAMES)
+            return false;
+        break;
+
+    case 'B':
+        command->type = COMMAND_BENCHMARK;
+        break;
+
+    case 'D':
+        command->type = COMMAND_DUMP;
+        command->option = nextToken(&cursor);
+        if (command->option != '\0' && command->option != 'P' && command->option != 'T' &&
+                command->option != 'S' && command->option != 'L')
+            return false;
+        break;
+
+    case 'T':
+        command->type = COMMAND_TELEMETRY;
+        command->option = nextToken(&cursor);
+        if (command->option != 'T' && command->option != 'B' && command->option != 'R')
+            return false;
+        break;
+
+    default:
+        return false;
+    }
+
+    // reject trailing characters
+    return nextToken(&cursor) == '\0';
+}
+
+
+// Store the change asked for by a valid command, or carry it out straight away if
+// it does not affect the controllers.
+static void storeCommand(const command_t* command)
+{
+    switch (command->type) {
+    case COMMAND_HEIGHT:
+        pending.targetHeight = command->value;
+        pending.hasHeight = true;
+        break;
+
+    case COMMAND_YAW:
+        pending.targetYaw = command->value;
+        pending.hasYaw = true;
+        break;
+
+    case COMMAND_MODE:
+        modeRequest = command->option == 'F' ? COMMAND_MODE_FLY : COMMAND_MODE_LAND;
+        break;
+
+    case COMMAND_GAIN:
+        pending.gains[command->index][command->gain] = command->value;
+        pending.gainMask[command->index] |= 1 << command->gain;
+        break;
+
+    case COMMAND_PARAM:
+        pending.params[command->index] = command->value;
+        pending.paramMask |= 1 << command->index;
+        break;
+
+    case COMMAND_SHED:
+        kernelSetShedPolicy(command->index, command->value);
+        break;
+
+    case COMMAND_BENCHMARK:
+        benchmarkStart();
+        break;
+
+    case COMMAND_DUMP:
+        switch (command->option) {
+        case 'T':
+            traceDumpStart();
+            break;
+        case 'S':
+            reportStart();
+            break;
+        case 'L':
+            reportLogStart();
+            break;
+        default:
+            probeDumpStart();
+            break;
+        }
+        break;
+
+    case COMMAND_TELEMETRY:
+        switch (command->option) {
+        case 'B':
+            telemetrySetMode(TELEMETRY_BINARY);
+            break;
+        case 'R':
+            telemetrySetMode(TELEMETRY_RECORD);
+            break;
+        default:
+            telemetrySetMode(TELEMETRY_TEXT);
+            break;
+        }
+        break;
+    }
+}
+
+
+// Task to parse any received characters. Does a bounded amount of work per call
+// and never waits for input.
+void commandUpdate(state_t* state, uint32_t deltaTime)
+{
+    char c;
+    int count = 0;
+
+    while (count++ < COMMAND_MAX_CHARS_PER_UPDATE && uartReadChar(&c)) {
+        if (c != '\n' && c != '\r') {
+            // store the character, or remember to reject the line if there is no room
+            if (lineLength < COMMAND_LINE_LENGTH) {
+                line[lineLength++] = c;
+            } else {
+                isLineTooLong = true;
+            }
+            continue;
+        }
+
+        if (lineLength == 0 && !isLineTooLong) {
+            continue;  // blank line or the second half of \r\n
+        }
+
+        line[lineLength] = '\0';
+        command_t command;
+        bool isAccepted = !isLineTooLong && parseLine(line, &command);
+        if (isAccepted) {
+            storeCommand(&command);
+        }
+        lineLength = 0;
+        isLineTooLong = false;
+
+        // don't put text into the middle of a binary stream or a trace dump
+        if (telemetryIsTextAllowed()) {
+            uartSend(isAccepted ? "OK\r\n" : "ERR\r\n");
+        }
+    }
+}
+
+
+// Apply all commands received since the last call. Call once per control tick,
+// before the controllers run, so that they see a consistent set of changes.
+void commandApply(state_t* state)
+{
+    int channel, i;
+
+    // targets are owned by the landing and calibration sequences in the other modes
+    if (state->heliMode == STATE_FLYING) {
+        if (pending.hasHeight)
+            state->targetHeight = pending.targetHeight;
+        if (pending.hasYaw)
+            state->targetYaw = pending.targetYaw;
+    }
+    pending.hasHeight = false;
+    pending.hasYaw = false;
+
+    for (channel = 0; channel < 2; channel++) {
+        for (i = 0; i < CONTROL_NUM_GAINS; i++) {
+            if (pending.gainMask[channel] & (1 << i)) {
+                controlSetGain(channel ? CONTROL_YAW : CONTROL_HEIGHT, (control_gain_t)i, pending.gains[channel][i]);
+            }
+        }
+        pending.gainMask[channel] = 0;
+    }
+
+    for (i = 0; i < CONTROL_NUM_PARAMS; i++) {
+        if (pending.paramMask & (1 << i)) {
+            controlSetParam((control_param_t)i, pending.params[i]);
+        }
+    }
+    pending.paramMask = 0;
+}
+
+
+// Return the latest mode change requested and clear it.
+command_mode_t commandTakeModeRequest(void)
+{
+    command_mode_t request = modeRequest;
+    modeRequest = COMMAND_MODE_NONE;
+    return request;
+}
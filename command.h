@@ -0,0 +1,59 @@
+// ************************************************************
+// command.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Accept setpoint, mode and parameter commands over UART.
+// Explaination: Lines received on UART0 are parsed by a low priority task.
+// Accepted commands are held until the next control tick, when they are all
+// applied together by commandApply(..). One command per line:
+//   H <percent>              target height 0 to 100 (flying mode only)
+//   Y <degrees>              target yaw -360 to 360 (flying mode only)
+//   M F | M L                request take off (fly) or landing
+//   G <H|Y> <P|D|I> <value>  PID gain of the height or yaw channel, 0 to 10 * PRECISION
+//   P <index> <value>        controller parameter, see control_param_t and paramLimits
+//   T <T|B|R>                text, binary telemetry or sensor recording
+//   S <level> <frames>       load shedding: highest shed level 0 to 3 (0 turns it
+//                            off), and quiet frames 1 to 10000 before shedding less,
+//                            see kernelSetShedPolicy(..)
+//   B                        run the benchmarks once landed, see benchmark.h
+//   D [P|T|S|L]              dump the probe timings (default), the trace, the module
+//                            statistics or the flight mode log, see probe.h, trace.h and report.h
+// Each line is answered with OK or ERR while in text telemetry mode, except
+// during a trace dump, which has the UART to itself. A line answered with ERR
+// changes nothing.
+// ************************************************************
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stateInfo.h"
+
+
+// Mode changes which can be requested over UART.
+typedef enum {
+    COMMAND_MODE_NONE = 0,
+    COMMAND_MODE_FLY,
+    COMMAND_MODE_LAND
+} command_mode_t;
+
+
+// Task to parse any received characters. Does a bounded amount of work per call
+// and never waits for input.
+void commandUpdate(state_t* state, uint32_t deltaTime);
+
+
+// Apply all commands received since the last call. Call once per control tick,
+// before the controllers run, so that they see a consistent set of changes.
+void commandApply(state_t* state);
+
+
+// Return the latest mode change requested and clear it.
+command_mode_t commandTakeModeRequest(void);
+
+
+#endif /* COMMAND_H_ */
@@ -13,20 +13,29 @@
 // ************************************************************
 
 #include "control.h"
+#include "pid.h"
 #include "pwmModule.h"
 #include "height.h"
 #include "yaw.h"
+#include "quadratureEncoder.h"
 #include "landingController.h"  // advance landing behaviour
+#include "trajectory.h"
+#include "trace.h"
 
 #define MS_TO_SEC 1000  // number of ms in one s
-#define CONTROL_INTE_LIMIT (PRECISION * 200)  // set to 200% max compensation
 #define CONTROL_DECREMENT_PER_CYCLE (CONTROL_DESCEND_SPEED * PRECISION / MS_TO_SEC)
-#define SIGN(n) ((n) < 0 ? -1 : 1)
+
+// limits on how fast the references move to a new target (scaled by PRECISION)
+#define HEIGHT_MAX_VELOCITY (30 * PRECISION)  // % per second
+#define HEIGHT_MAX_ACCELERATION (60 * PRECISION)  // % per second squared
+#define YAW_MAX_VELOCITY (90 * PRECISION)  // deg per second
+#define YAW_MAX_ACCELERATION (180 * PRECISION)  // deg per second squared
 
 typedef void (*control_channel_update_func_t)(state_t*, uint32_t);  // pointer to handler function
 
 static int32_t outputs[CONTROL_NUM_CHANNELS] = {0};  // values to send to motors
 static bool enabled[CONTROL_NUM_CHANNELS] = {0};  // specify which channels have control
+static control_finished_handler_t finishedHandler = 0;  // told when a channel auto-disables
 
 // functions which get called to update each channel
 void updateHeightChannel(state_t* state, uint32_t deltaTime);
@@ -45,12 +54,13 @@ static const control_channel_update_func_t chanelUpdateFuncs[CONTROL_NUM_CHANNEL
 };
 
 // configurable constants (scaled by PRECISION)
-enum gains_e {KP=0, KD, KI};
-static const int32_t mainGains[] = {1500, 600, 400};  // in PID order
-static const int32_t tailGains[] = {1200, 800, 500};
-static const int32_t mainTorqueConst = 800;  // ratio of main rotor speed to tail rotor speed
-static const int32_t mainOffset = 33;  // temporary until calibration added
-static const int32_t gravOffset = 200;  // ratio of height to down force
+static int32_t mainGains[CONTROL_NUM_GAINS] = {1500, 600, 400};  // in PID order
+static int32_t tailGains[CONTROL_NUM_GAINS] = {1200, 800, 500};
+static int32_t params[CONTROL_NUM_PARAMS] = {
+    33,  // main offset in % (not scaled), temporary until calibration added
+    200,  // grav offset, ratio of height to down force
+    800  // torque constant, ratio of main rotor speed to tail rotor speed
+};
 
 // measured parameters (scaled by PRECISION)
 static int32_t height, previousHeight = 0, verticalVelocity;
@@ -58,6 +68,15 @@ static int32_t yaw, previousYaw = 0, angularVelocity = 0;
 
 static int32_t inte_y = 0, inte_h = 0;  // for integral calculations
 
+// when the measurements used in this update were taken, in timer ticks
+static uint32_t heightTime, yawTime;
+static bool isYawNew;  // an edge has been counted since the last update
+
+// references which move smoothly to the targets
+static trajectory_t heightReference, yawReference;
+
+static landing_controller_t landing;  // used by the descending channel
+
 
 // A helper function. Limit the value n between two lower and upper
 // values (inclusive). Return the limited value.
@@ -71,10 +90,23 @@ int32_t clamp(int32_t n, int32_t lower, int32_t upper)
 }
 
 
+// Copy the sensor to actuator latency of one rotor into latency, measured since the
+// motors were last turned on, up to when the PWM generator latches the width. The main
+// rotor is driven by the height, which includes the delay of the height average. The
+// tail rotor is driven by the yaw, measured from the last encoder edge when there
+// has been one since the update before.
+void controlGetLatency(control_duty_t rotor, control_latency_t* latency)
+{
+    pwmGetLatency(rotor == CONTROL_DUTY_MAIN ? MAIN_ROTOR : TAIL_ROTOR, latency);
+}
+
+
 // Initalise PWM outputs and motors
 void controlInit(void)
 {
     pwmInit();
+    trajectoryInit(&heightReference, HEIGHT_MAX_VELOCITY, HEIGHT_MAX_ACCELERATION);
+    trajectoryInit(&yawReference, YAW_MAX_VELOCITY, YAW_MAX_ACCELERATION);
 }
 
 
@@ -103,6 +135,19 @@ void controlEnable(state_t* state, control_channel_t channel)
         // start calibration
         yawCalibrate();
         break;
+    case CONTROL_DESCENDING:
+        landingControllerReset(&landing);
+        outputs[channel] = 0;
+        break;
+    case CONTROL_HEIGHT:
+        // start moving from where we are
+        trajectoryReset(&heightReference, heightAsPercentage(PRECISION));
+        outputs[channel] = 0;
+        break;
+    case CONTROL_YAW:
+        trajectoryReset(&yawReference, yawGetDegrees(PRECISION));
+        outputs[channel] = 0;
+        break;
     default:
         outputs[channel] = 0;
     }
@@ -125,6 +170,24 @@ void controlDisable(state_t* state, control_channel_t channel)
 }
 
 
+// Set a function to be called from controlUpdate(..) when a channel disables itself
+// because its job is done. Pass 0 for no handler.
+void controlSetFinishedHandler(control_finished_handler_t handler)
+{
+    finishedHandler = handler;
+}
+
+
+// Disable a channel which has finished its job and tell the finished handler.
+static void controlFinish(state_t* state, control_channel_t channel)
+{
+    controlDisable(state, channel);
+    if (finishedHandler) {
+        finishedHandler(state, channel);
+    }
+}
+
+
 // Return true if the specified control channel is currently enabled.
 // All channels are disabled by default.
 bool controlIsEnabled(control_channel_t channel)
@@ -133,6 +196,45 @@ bool controlIsEnabled(control_channel_t channel)
 }
 
 
+// Set one gain of the PID controller for the CONTROL_HEIGHT or CONTROL_YAW channel.
+// The gain is scaled by PRECISION. Returns false if the channel has no PID controller.
+bool controlSetGain(control_channel_t channel, control_gain_t gain, int32_t value)
+{
+    switch (channel) {
+    case CONTROL_HEIGHT:
+        mainGains[gain] = value;
+        return true;
+    case CONTROL_YAW:
+        tailGains[gain] = value;
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+// Return one gain of the PID controller for the CONTROL_HEIGHT or CONTROL_YAW channel,
+// scaled by PRECISION. Returns 0 if the channel has no PID controller.
+int32_t controlGetGain(control_channel_t channel, control_gain_t gain)
+{
+    switch (channel) {
+    case CONTROL_HEIGHT:
+        return mainGains[gain];
+    case CONTROL_YAW:
+        return tailGains[gain];
+    default:
+        return 0;
+    }
+}
+
+
+// Set one of the tunable controller constants. See control_param_t for the scaling.
+void controlSetParam(control_param_t param, int32_t value)
+{
+    params[param] = value;
+}
+
+
 // Checks which channels are active and applies the associated controls to the
 // main and tail pwm rotor output for the helicopter. If all channels are disabled,
 // then the pwm output is also disabled. Takes a state object contiaining the target
@@ -144,14 +246,21 @@ void controlUpdate(state_t* state, uint32_t deltaTime)
     // always calculate velocities here so that we don't get discontinuities
     // get height and velocity
     height = heightAsPercentage(PRECISION);
+    heightTime = heightGetSampleTime();
     verticalVelocity = (height - previousHeight) * PRECISION / deltaTime;
     previousHeight = height;
 
     // get yaw and angular velocity
     yaw = yawGetDegrees(PRECISION);
+    isYawNew = quadEncoderGetEdgeTime() != yawTime;
+    yawTime = quadEncoderGetEdgeTime();  // the count is as of the last edge
     angularVelocity = (yaw - previousYaw) * PRECISION / deltaTime;
     previousYaw = yaw;
 
+    // move the references towards the targets
+    trajectoryUpdate(&heightReference, state->targetHeight * PRECISION, deltaTime);
+    trajectoryUpdate(&yawReference, state->targetYaw * PRECISION, deltaTime);
+
     // call all channel update functions
     int i = 0;
     bool areAllDisabled = true;
@@ -171,6 +280,9 @@ void controlUpdate(state_t* state, uint32_t deltaTime)
         // turn on/off motors only when enabling/disabling all channels
         pwmSetOutputState(!areAllDisabled, MAIN_ROTOR);
         pwmSetOutputState(!areAllDisabled, TAIL_ROTOR);
+
+        // measure the latency of each flight separately
+        pwmResetLatency();
     }
 
     // calculate the duty cycle for each motor
@@ -190,13 +302,19 @@ void controlUpdate(state_t* state, uint32_t deltaTime)
 
         // Set motor speed
         // Since tail and main duty are clamped, it is safe to cast to uint32_t types
-        pwmSetDuty((uint32_t)mainDuty, PRECISION, MAIN_ROTOR);
-        pwmSetDuty((uint32_t)tailDuty, PRECISION, TAIL_ROTOR);
+        pwmSetDutyFrom((uint32_t)mainDuty, PRECISION, MAIN_ROTOR, heightTime, HEIGHT_FILTER_DELAY_US);
+        if (isYawNew) {
+            pwmSetDutyFrom((uint32_t)tailDuty, PRECISION, TAIL_ROTOR, yawTime, 0);
+        } else {
+            pwmSetDuty((uint32_t)tailDuty, PRECISION, TAIL_ROTOR);  // nothing new to measure
+        }
     }
 
     // update state so that other tasks know what is going on
     state->outputMainDuty = mainDuty / PRECISION;
     state->outputTailDuty = tailDuty / PRECISION;
+    TRACE(TRACE_OUTPUT, CONTROL_DUTY_MAIN, state->outputMainDuty);
+    TRACE(TRACE_OUTPUT, CONTROL_DUTY_TAIL, state->outputTailDuty);
 }
 
 
@@ -212,30 +330,14 @@ void updateHeightChannel(state_t* state, uint32_t deltaTime)
 {
     // calculate inital offset + a factor which varies with height.
     // this correction model was obtained experimentally.
-    outputs[CONTROL_HEIGHT] = mainOffset * PRECISION + height * gravOffset / PRECISION;
-
-    // difference between the target and actual height value
-    int32_t error = state->targetHeight * PRECISION - height;
-
-    // proportonal component = Kp * error
-    int32_t prop = mainGains[KP] * error / PRECISION;
-    outputs[CONTROL_HEIGHT] += prop;
-
-    // derivitive component = Kd * d/dt(error) = Kd * (d/dt(target) - d/dt(verticalVelocity))
-    // since d/dt(target) can be assumed 0 where the target is stationary, we get the
-    // below simplification. Although the target is not always stationary, this is a good
-    // appoximation.
-    int32_t deri = mainGains[KD] * (0 - verticalVelocity) / PRECISION;
-    outputs[CONTROL_HEIGHT] += deri;
-
-    // cumulative component = Ki * sum(error) from t0 to t. Hence, we sum. However, a bound
-    // is put on the cumulative component to stop overflow.
-    inte_h += mainGains[KI] * (int32_t)deltaTime * error / MS_TO_SEC / PRECISION;
-    if (abs(inte_h) > CONTROL_INTE_LIMIT) {
-        // limit to the max integral value (as a +ve or -ve value) with the correct sign
-        inte_h = SIGN(inte_h) * CONTROL_INTE_LIMIT;
-    }
-    outputs[CONTROL_HEIGHT] += inte_h;
+    outputs[CONTROL_HEIGHT] = params[CONTROL_PARAM_MAIN_OFFSET] * PRECISION + height * params[CONTROL_PARAM_GRAV_OFFSET] / PRECISION;
+
+    // difference between the reference and actual height value. The derivative acts on
+    // d/dt(reference) - verticalVelocity, where d/dt(reference) is the velocity of the
+    // trajectory, used as feedforward.
+    int32_t error = heightReference.position - height;
+    outputs[CONTROL_HEIGHT] += pidUpdate(mainGains, &inte_h, error,
+                                         heightReference.velocity - verticalVelocity, deltaTime);
 }
 
 
@@ -246,31 +348,14 @@ void updateYawChannel(state_t* state, uint32_t deltaTime)
     // couple to main rotor speed since changes in speed effect the tail rotor.
     // the value of mainDuty will be one update cycle behind.
     // although state->outputMainDuty is not multiplied by PRECISION, it doesn't
-    // matter since mainTorqueConst has a factor of PRECSION in it.
-    outputs[CONTROL_YAW] = mainTorqueConst * state->outputMainDuty;
-
-    // difference between the target and actual yaw value
-    int32_t error = state->targetYaw * PRECISION - yaw;
-
-    // proportonal component = Kp * error
-    int32_t prop = tailGains[KP] * error / PRECISION;
-    outputs[CONTROL_YAW] += prop;
-
-    // derivitive component = Kd * d/dt(error) = Kd * (d/dt(target) - d/dt(angularVelocity))
-    // since d/dt(target) can be assumed 0 where the target is stationary, we get the
-    // below simplification. Although the target is not always stationary, this is a good
-    // appoximation
-    int32_t deri = tailGains[KD] * (0 - angularVelocity) / PRECISION;
-    outputs[CONTROL_YAW] += deri;
-
-    // cumulative component = Ki * sum(error) from t0 to t. Hence, we sum. However, a bound
-    // is put on the cumulative component to stop overflow.
-    inte_y += tailGains[KI] * (int32_t)deltaTime * error / MS_TO_SEC / PRECISION;
-    if (abs(inte_y) > CONTROL_INTE_LIMIT) {
-        // limit to the max integral value and preserve
-        inte_y = SIGN(inte_y) * CONTROL_INTE_LIMIT;
-    }
-    outputs[CONTROL_YAW] += inte_y;
+    // matter since the torque constant has a factor of PRECSION in it.
+    outputs[CONTROL_YAW] = params[CONTROL_PARAM_TORQUE_CONST] * state->outputMainDuty;
+
+    // difference between the reference and actual yaw value, with the trajectory's
+    // velocity fed forward as in the height channel
+    int32_t error = yawReference.position - yaw;
+    outputs[CONTROL_YAW] += pidUpdate(tailGains, &inte_y, error,
+                                      yawReference.velocity - angularVelocity, deltaTime);
 }
 
 
@@ -280,8 +365,8 @@ void updateYawChannel(state_t* state, uint32_t deltaTime)
 // once either: stability is reached, or the stability checker times out.
 void updateDescendingChannel(state_t* state, uint32_t deltaTime)
 {
-    if (landingControllerIsStable(state, deltaTime, yaw, height)) {
-        controlDisable(state, CONTROL_DESCENDING);
+    if (landingControllerIsStable(&landing, state, deltaTime, yaw, height)) {
+        controlFinish(state, CONTROL_DESCENDING);
     } else {
         landingControllerUpdate(state, deltaTime, yaw);
     }
@@ -295,7 +380,7 @@ void updateDescendingChannel(state_t* state, uint32_t deltaTime)
 // main duty reaches its minimum value.
 void updatePowerDownChannel(state_t* state, uint32_t deltaTime) {
     if (outputs[CONTROL_POWER_DOWN] <= CONTROL_MIN_DUTY * PRECISION) {
-        controlDisable(state, CONTROL_POWER_DOWN);
+        controlFinish(state, CONTROL_POWER_DOWN);
     } else if (outputs[CONTROL_POWER_DOWN] >= CONTROL_DECREMENT_PER_CYCLE * deltaTime) { // prevent overflow
         outputs[CONTROL_POWER_DOWN] -= CONTROL_DECREMENT_PER_CYCLE * deltaTime;
     } else {
@@ -308,8 +393,11 @@ void updatePowerDownChannel(state_t* state, uint32_t deltaTime) {
 void updateYawCalibrate(state_t* state, uint32_t deltaTime) {
 
     if (yawIsCalibrated()) {
-        controlDisable(state, CONTROL_CALIBRATE_YAW);
+        controlFinish(state, CONTROL_CALIBRATE_YAW);
         state->targetYaw = 0;
+
+        // the yaw was reset to zero at the reference, so the reference must jump with it
+        trajectoryReset(&yawReference, yawGetDegrees(PRECISION));
     } else {
         state->targetYaw += 1;
     }
@@ -19,6 +19,11 @@
 #include <stdbool.h>
 
 #include "stateInfo.h"  // needs to know about state_t
+#include "pwmModule.h"
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
 
 #define PRECISION 1000  // zeros represent how many dp of precision to get with integer math
 #define CONTROL_MIN_DUTY 5  // % duty cycle for motors
@@ -40,6 +45,28 @@ typedef enum {
 } control_channel_t;
 
 
+// The gains of the PID controllers on the height and yaw channels.
+typedef enum {
+    CONTROL_KP = 0,
+    CONTROL_KD,
+    CONTROL_KI,
+
+    // Always equal to the number of gains above
+    CONTROL_NUM_GAINS
+} control_gain_t;
+
+
+// Other tunable controller constants.
+typedef enum {
+    CONTROL_PARAM_MAIN_OFFSET = 0,  // main duty needed to hover at zero height in % (not scaled)
+    CONTROL_PARAM_GRAV_OFFSET,  // ratio of height to down force, scaled by PRECISION
+    CONTROL_PARAM_TORQUE_CONST,  // ratio of main rotor speed to tail rotor speed, scaled by PRECISION
+
+    // Always equal to the number of parameters above
+    CONTROL_NUM_PARAMS
+} control_param_t;
+
+
 // Give access to the pwm duty cycles for displaying.
 typedef enum {
     CONTROL_DUTY_MAIN,
@@ -47,6 +74,14 @@ typedef enum {
 } control_duty_t;
 
 
+// Called when a channel disables itself, e.g. once the descent is complete.
+typedef void (*control_finished_handler_t)(state_t* state, control_channel_t channel);
+
+
+// How old the measurements behind the PWM duty cycles were when they were latched.
+typedef pwm_latency_t control_latency_t;
+
+
 // Initalise PWM outputs and motors
 void controlInit(void);
 
@@ -65,11 +100,38 @@ void controlEnable(state_t* state, control_channel_t channel);
 void controlDisable(state_t* state, control_channel_t channel);
 
 
+// Set a function to be called from controlUpdate(..) when a channel disables itself
+// because its job is done. Pass 0 for no handler.
+void controlSetFinishedHandler(control_finished_handler_t handler);
+
+
 // Return true if the specified control channel is currently enabled.
 // All channels are disabled by default.
 bool controlIsEnabled(control_channel_t channel);
 
 
+// Set one gain of the PID controller for the CONTROL_HEIGHT or CONTROL_YAW channel.
+// The gain is scaled by PRECISION. Returns false if the channel has no PID controller.
+bool controlSetGain(control_channel_t channel, control_gain_t gain, int32_t value);
+
+
+// Return one gain of the PID controller for the CONTROL_HEIGHT or CONTROL_YAW channel,
+// scaled by PRECISION. Returns 0 if the channel has no PID controller.
+int32_t controlGetGain(control_channel_t channel, control_gain_t gain);
+
+
+// Set one of the tunable controller constants. See control_param_t for the scaling.
+void controlSetParam(control_param_t param, int32_t value);
+
+
+// Copy the sensor to actuator latency of one rotor into latency, measured since the
+// motors were last turned on, up to when the PWM generator latches the width. The main
+// rotor is driven by the height, which includes the delay of the height average. The
+// tail rotor is driven by the yaw, measured from the last encoder edge when there
+// has been one since the update before.
+void controlGetLatency(control_duty_t rotor, control_latency_t* latency);
+
+
 // Checks which channels are active and applies the associated controls to the
 // main and tail pwm rotor output for the helicopter. If all channels are disabled,
 // then the pwm output is also disabled. Takes a state object contiaining the target
@@ -77,4 +139,8 @@ bool controlIsEnabled(control_channel_t channel);
 void controlUpdate(state_t* state, uint32_t deltaTime);
 
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* CONTROL_H_ */
@@ -11,19 +11,144 @@
 
 #include "display.h"
 #include "utils/ustdlib.h"
-#include "OrbitOLED/OrbitOLEDInterface.h"
+#include "hal.h"
+
+#define DISPLAY_MERGE_GAP 2  // unchanged chars between changes which are redrawn to save a draw call
+
+// The text wanted on the display and the text currently on it. Printing only updates the
+// wanted text, and displayFlush(..) later sends the characters which differ.
+static char frame[DISPLAY_NUM_LINES][DISPLAY_CHAR_WIDTH];
+static char shadow[DISPLAY_NUM_LINES][DISPLAY_CHAR_WIDTH];
+static uint32_t dirtyLines = 0;  // bit per line which may differ from the display
+static display_stats_t stats;
+
+
+// Store a full width line as the wanted text for lineNum. Nothing is sent to the display.
+static void displaySetLine(const char* str, uint32_t lineNum)
+{
+    if (lineNum >= DISPLAY_NUM_LINES) {
+        return;
+    }
+
+    stats.linesRequested++;
+    if (memcmp(frame[lineNum], str, DISPLAY_CHAR_WIDTH) != 0) {
+        memcpy(frame[lineNum], str, DISPLAY_CHAR_WIDTH);
+        dirtyLines |= 1 << lineNum;
+    }
+}
+
+
+// Send the characters of a line which differ from what is on the display, up to
+// maxChars characters. Runs of changed characters separated by short gaps are drawn
+// together. Returns the number of characters sent.
+static uint32_t displayFlushLine(uint32_t lineNum, uint32_t maxChars)
+{
+    char run[DISPLAY_CHAR_WIDTH + 1];  // for \0
+    const char* str = frame[lineNum];
+    uint32_t sent = 0;
+    uint32_t col = 0;
+
+    while (col < DISPLAY_CHAR_WIDTH && sent < maxChars) {
+        // find the next changed character
+        if (str[col] == shadow[lineNum][col]) {
+            col++;
+            continue;
+        }
+
+        // extend the run until DISPLAY_MERGE_GAP unchanged characters in a row are found,
+        // or the budget is used up
+        uint32_t start = col;
+        uint32_t end = col + 1;  // one past the last changed character
+        uint32_t limit = start + maxChars - sent;
+        uint32_t i;
+        for (i = end; i < DISPLAY_CHAR_WIDTH && i < limit && i < end + DISPLAY_MERGE_GAP + 1; i++) {
+            if (str[i] != shadow[lineNum][i]) {
+                end = i + 1;
+            }
+        }
+
+        for (i = start; i < end; i++) {
+            run[i - start] = str[i];
+            shadow[lineNum][i] = str[i];
+        }
+        run[end - start] = '\0';
+        halOledDraw(run, start, lineNum);
+
+        stats.drawCalls++;
+        stats.charsDrawn += end - start;
+        sent += end - start;
+        col = end;
+    }
+
+    // the line is up to date once the whole line has been checked
+    if (col >= DISPLAY_CHAR_WIDTH && memcmp(str, shadow[lineNum], DISPLAY_CHAR_WIDTH) == 0) {
+        dirtyLines &= ~(1 << lineNum);
+    }
+    return sent;
+}
 
 
 // Configure OLED display
 void displayInit(void)
 {
-    OLEDInitialise();
+    halOledInit();
+
+    // the display starts blank
+    memset(frame, ' ', sizeof(frame));
+    memset(shadow, ' ', sizeof(shadow));
+}
+
+
+// Send up to maxChars characters of the wanted text which differ from the display.
+// Call regularly so that the time spent drawing is spread out. Returns true when the
+// display matches the wanted text.
+bool displayFlush(uint32_t maxChars)
+{
+    uint32_t lineNum;
+
+    for (lineNum = 0; lineNum < DISPLAY_NUM_LINES && maxChars > 0; lineNum++) {
+        if (dirtyLines & (1 << lineNum)) {
+            maxChars -= displayFlushLine(lineNum, maxChars);
+        }
+    }
+    return dirtyLines == 0;
+}
+
+
+// Copy the counts of the display work done and avoided into statsOut.
+void displayGetStats(display_stats_t* statsOut)
+{
+    *statsOut = stats;
+}
+
+
+// Finish a line of storedChars characters formatted into str, which must have room
+// for DISPLAY_CHAR_WIDTH + 1 characters, and store it as the wanted text for lineNum.
+static void displayFinishLine(char* str, int storedChars, uint32_t lineNum)
+{
+    // add ellipsis if string too long
+    if (storedChars > DISPLAY_CHAR_WIDTH) {
+        int i = DISPLAY_CHAR_WIDTH;
+        while (i-- > DISPLAY_CHAR_WIDTH - 3) {
+            str[i] = '.';
+        }
+    } else {
+        // pad with spaces to overwrite anything left from a longer line
+        int i;
+        for (i = storedChars; i < DISPLAY_CHAR_WIDTH; i++) {
+            str[i] = ' ';
+        }
+    }
+    str[DISPLAY_CHAR_WIDTH] = '\0';
+    displaySetLine(str, lineNum);
 }
 
 
 // Format a line for printing to the lineNum'th line of the display.
 // If the line is too long, the string is truncated and an elipsis is
-// added to the end. All other behaviour is as per printf.
+// added to the end. All other behaviour is as per printf. The rest of
+// the line is cleared. Returns without drawing, the changed characters
+// are sent by displayFlush(..).
 void displayPrintLineWithFormat(const char* format, uint32_t lineNum, ...)
 {
     va_list args;
@@ -31,25 +156,36 @@ void displayPrintLineWithFormat(const char* format, uint32_t lineNum, ...)
     char str[DISPLAY_CHAR_WIDTH + 1];  // for \0
 
     va_start(args, lineNum);
-    storedChars = uvsnprintf(str, DISPLAY_CHAR_WIDTH, format, args);
-    va_end(arg);
+    storedChars = uvsnprintf(str, DISPLAY_CHAR_WIDTH + 1, format, args);
+    va_end(args);
 
-    // add ellipsis if string too long
-    if (storedChars >= DISPLAY_CHAR_WIDTH) {
-        int i = DISPLAY_CHAR_WIDTH;
-        while (i-- > DISPLAY_CHAR_WIDTH - 3) {
-            str[i] = '.';
-        }
-        str[DISPLAY_CHAR_WIDTH] = '\0';
+    displayFinishLine(str, storedChars, lineNum);
+}
+
+
+// As displayPrintLineWithFormat, but with a format compiled by lineFormatCompile(..)
+// so that the format string is not parsed again. A format which failed to compile
+// is formatted with uvsnprintf.
+void displayPrintLineWithCompiled(const line_format_t* format, uint32_t lineNum, ...)
+{
+    va_list args;
+    int storedChars;
+    char str[DISPLAY_CHAR_WIDTH + 1];  // for \0
+
+    va_start(args, lineNum);
+    if (format->isCompiled) {
+        storedChars = lineFormatApply(format, str, DISPLAY_CHAR_WIDTH + 1, args);
     } else {
-        str[storedChars + 1] = '\0';
+        storedChars = uvsnprintf(str, DISPLAY_CHAR_WIDTH + 1, format->format, args);
     }
-    OLEDStringDraw(str, 0, lineNum);
+    va_end(args);
+
+    displayFinishLine(str, storedChars, lineNum);
 }
 
 
-// Place blank spaces on the display at the given line.
+// Place blank spaces on the display at the given line. Drawn by displayFlush(..).
 void displayClear(uint32_t line)
 {
-    OLEDStringDraw ("                 ", 0, line);  // 16 characters across the display
+    displaySetLine("                ", line);  // 16 characters across the display
 }
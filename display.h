@@ -12,10 +12,23 @@
 #define DISPLAY_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 
+#include "lineFormat.h"
+
 // The number of chars which fit on a line of the display
 #define DISPLAY_CHAR_WIDTH 16
+#define DISPLAY_NUM_LINES 4
+#define DISPLAY_BYTES_PER_CHAR 8  // bytes sent to the display for each character drawn
+
+
+// Counts of the display work done. Lines which are requested but unchanged cost no draw calls.
+typedef struct {
+    uint32_t linesRequested;  // calls to print or clear a line
+    uint32_t drawCalls;  // calls made to the OLED driver
+    uint32_t charsDrawn;  // characters sent to the display
+} display_stats_t;
 
 
 // Configure OLED display
@@ -24,11 +37,31 @@ void displayInit(void);
 
 // Format a line for printing to the lineNum'th line of the display.
 // If the line is too long, the string is truncated and an elipsis is
-// added to the end. All other behaviour is as per printf.
+// added to the end. All other behaviour is as per printf. The rest of
+// the line is cleared. Returns without drawing, the changed characters
+// are sent by displayFlush(..).
 void displayPrintLineWithFormat(const char* format, uint32_t lineNum, ...);
 
 
-// Place blank spaces on the display at the given line.
+// As displayPrintLineWithFormat, but with a format compiled by lineFormatCompile(..)
+// so that the format string is not parsed again. A format which failed to compile
+// is formatted with uvsnprintf.
+void displayPrintLineWithCompiled(const line_format_t* format, uint32_t lineNum, ...);
+
+
+// Place blank spaces on the display at the given line. Drawn by displayFlush(..).
 void displayClear(uint32_t line);
 
+
+// Send up to maxChars characters of the wanted text which differ from the display.
+// Call regularly so that the time spent drawing is spread out. Returns true when the
+// display matches the wanted text.
+bool displayFlush(uint32_t maxChars);
+
+
+// Copy the counts of the display work done and avoided into statsOut.
+// Without the cache every requested line would cost one draw call and
+// DISPLAY_CHAR_WIDTH characters.
+void displayGetStats(display_stats_t* statsOut);
+
 #endif /* DISPLAY_H_ */
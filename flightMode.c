@@ -0,0 +1,282 @@
+// ************************************************************
+// flightMode.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Move the helicopter between its modes (see heli_state_t) in
+// response to events.
+// Explaination: transitions[] lists every allowed mode change. The first row
+// matching the current mode and event whose guard passes is taken: the exit
+// action of the old mode runs, then the row's action, then the entry action of
+// the new mode. Control channels finishing are posted from controlUpdate(..)
+// so, with flightModeDispatch(..) called straight after it, the next mode
+// starts in the same tick.
+// ************************************************************
+
+#include "flightMode.h"
+#include "control.h"
+#include "height.h"
+#include "yaw.h"
+#include "buttons4.h"
+#include "timerer.h"
+#include "trace.h"
+#include "stepResponse.h"
+
+typedef bool (*flight_guard_t)(state_t* state);
+typedef void (*flight_action_t)(state_t* state);
+
+// An allowed mode change. A guard or action of 0 always passes or does nothing.
+typedef struct {
+    heli_state_t from;
+    flight_event_t event;
+    flight_guard_t guard;
+    flight_action_t action;
+    heli_state_t to;
+} flight_transition_t;
+
+// What to do when entering, leaving and staying in a mode. 0 for nothing.
+typedef struct {
+    flight_action_t enter;
+    flight_action_t during;
+    flight_action_t exit;
+} flight_mode_actions_t;
+
+static bool shouldCalibrate = true;  // only calibrate the yaw once
+
+static flight_event_t eventQueue[FLIGHT_EVENT_QUEUE_SIZE];
+static uint32_t eventHead = 0;  // next free slot
+static uint32_t eventTail = 0;  // oldest event
+
+static flight_log_entry_t transitionLog[FLIGHT_LOG_SIZE];
+static uint32_t logCount = 0;  // total transitions, the newest is at (logCount - 1) % FLIGHT_LOG_SIZE
+
+
+//
+// Guards and actions
+//
+
+
+static bool needsCalibration(state_t* state)
+{
+    return shouldCalibrate;
+}
+
+
+static void startFlying(state_t* state)
+{
+    // enable PID control on height and yaw
+    controlEnable(state, CONTROL_HEIGHT);
+    controlEnable(state, CONTROL_YAW);
+    state->targetHeight = 0;
+
+    // set integral controllers back to zero to prevent windup
+    controlReset();
+}
+
+
+static void finishCalibration(state_t* state)
+{
+    shouldCalibrate = false;
+    state->targetYaw = 0;
+}
+
+
+static void stopHeightControl(state_t* state)
+{
+    controlDisable(state, CONTROL_HEIGHT);
+}
+
+
+static void enterLanded(state_t* state)
+{
+    controlDisable(state, CONTROL_YAW);
+    state->targetHeight = 0;
+    state->targetYaw = 0;
+
+    // round the yaw measurement so that we always return to 0 degrees by the shortest
+    // path. i.e. don't unwind if we have spun multiple times.
+    yawClipTo360Degrees();
+
+    // prevent a toggle of the switch causing the heli to take off again once landed
+    buttonsIgnore(SW1);
+}
+
+
+static void duringLanded(state_t* state)
+{
+    heightCalibrate();  // always re-calibrate the height
+}
+
+
+static void enterCalibrateYaw(state_t* state)
+{
+    // seek the zero point for the yaw
+    controlEnable(state, CONTROL_CALIBRATE_YAW);
+}
+
+
+static void enterFlying(state_t* state)
+{
+    // don't carry a step from the last flight, or count take off as one
+    stepResponseReset(state);
+}
+
+
+static void enterDescending(state_t* state)
+{
+    controlEnable(state, CONTROL_DESCENDING);
+}
+
+
+static void enterPowerDown(state_t* state)
+{
+    controlEnable(state, CONTROL_POWER_DOWN);
+
+    // prevent a toggle of the switch causing the heli to take off again once landed
+    buttonsIgnore(SW1);
+}
+
+
+// in heli_state_t order
+static const flight_mode_actions_t modeActions[NUM_HELI_STATES] = {
+    {enterLanded, duringLanded, 0},  // STATE_LANDED
+    {enterCalibrateYaw, 0, 0},  // STATE_CALIBRATE_YAW
+    {enterFlying, 0, 0},  // STATE_FLYING
+    {enterDescending, 0, 0},  // STATE_DESCENDING
+    {enterPowerDown, 0, 0}  // STATE_POWER_DOWN
+};
+
+static const flight_transition_t transitions[] = {
+    // from, event, guard, action, to
+    {STATE_LANDED, FLIGHT_EV_TAKE_OFF, needsCalibration, startFlying, STATE_CALIBRATE_YAW},
+    {STATE_LANDED, FLIGHT_EV_TAKE_OFF, 0, startFlying, STATE_FLYING},
+    {STATE_CALIBRATE_YAW, FLIGHT_EV_CALIBRATED, 0, finishCalibration, STATE_FLYING},
+    {STATE_FLYING, FLIGHT_EV_LAND, 0, 0, STATE_DESCENDING},
+    {STATE_DESCENDING, FLIGHT_EV_DESCENDED, 0, stopHeightControl, STATE_POWER_DOWN},
+    {STATE_POWER_DOWN, FLIGHT_EV_POWERED_DOWN, 0, 0, STATE_LANDED}
+    // add transitions here
+};
+
+#define NUM_TRANSITIONS (sizeof(transitions) / sizeof(transitions[0]))
+
+
+//
+// Event handling
+//
+
+
+// Turn control channels finishing into events.
+static void controlFinishedHandler(state_t* state, control_channel_t channel)
+{
+    switch (channel) {
+    case CONTROL_CALIBRATE_YAW:
+        flightModePost(FLIGHT_EV_CALIBRATED);
+        break;
+    case CONTROL_DESCENDING:
+        flightModePost(FLIGHT_EV_DESCENDED);
+        break;
+    case CONTROL_POWER_DOWN:
+        flightModePost(FLIGHT_EV_POWERED_DOWN);
+        break;
+    default:
+        break;
+    }
+}
+
+
+// Take the first transition for event from the current mode whose guard passes.
+static void flightModeHandleEvent(state_t* state, flight_event_t event)
+{
+    uint32_t i;
+
+    for (i = 0; i < NUM_TRANSITIONS; i++) {
+        const flight_transition_t* transition = &transitions[i];
+        if (transition->from != state->heliMode || transition->event != event ||
+                (transition->guard && !transition->guard(state))) {
+            continue;
+        }
+
+        if (modeActions[transition->from].exit) {
+            modeActions[transition->from].exit(state);
+        }
+        if (transition->action) {
+            transition->action(state);
+        }
+        state->heliMode = transition->to;
+        TRACE(TRACE_MODE, transition->to, event);
+        if (modeActions[transition->to].enter) {
+            modeActions[transition->to].enter(state);
+        }
+
+        flight_log_entry_t* entry = &transitionLog[logCount % FLIGHT_LOG_SIZE];
+        entry->time = timererGetTicks();
+        entry->from = transition->from;
+        entry->to = transition->to;
+        entry->event = event;
+        logCount++;
+        return;
+    }
+}
+
+
+// Listen for control channels finishing. The helicopter starts in STATE_LANDED.
+void flightModeInit(void)
+{
+    controlSetFinishedHandler(controlFinishedHandler);
+}
+
+
+// Queue an event to be dispatched by the next flightModeDispatch(..). Returns false
+// if the queue is full and the event was dropped. Not for use from interrupts.
+bool flightModePost(flight_event_t event)
+{
+    uint32_t next = (eventHead + 1) % FLIGHT_EVENT_QUEUE_SIZE;
+
+    if (next == eventTail) {
+        return false;
+    }
+    eventQueue[eventHead] = event;
+    eventHead = next;
+    return true;
+}
+
+
+// Take any transitions for the queued events, in the order they were posted. Events
+// with no transition from the current mode are discarded.
+void flightModeDispatch(state_t* state)
+{
+    while (eventTail != eventHead) {
+        flight_event_t event = eventQueue[eventTail];
+        eventTail = (eventTail + 1) % FLIGHT_EVENT_QUEUE_SIZE;
+        flightModeHandleEvent(state, event);
+    }
+}
+
+
+// Dispatch queued events then run the during action of the current mode.
+void flightModeUpdate(state_t* state)
+{
+    flightModeDispatch(state);
+
+    if (modeActions[state->heliMode].during) {
+        modeActions[state->heliMode].during(state);
+    }
+}
+
+
+// Copy up to maxEntries of the most recent transitions into entries, oldest first.
+// Returns the number copied.
+uint32_t flightModeGetLog(flight_log_entry_t* entries, uint32_t maxEntries)
+{
+    uint32_t count = logCount < FLIGHT_LOG_SIZE ? logCount : FLIGHT_LOG_SIZE;
+    uint32_t i;
+
+    if (count > maxEntries) {
+        count = maxEntries;
+    }
+    for (i = 0; i < count; i++) {
+        entries[i] = transitionLog[(logCount - count + i) % FLIGHT_LOG_SIZE];
+    }
+    return count;
+}
@@ -0,0 +1,73 @@
+// ************************************************************
+// flightMode.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Move the helicopter between its modes (see heli_state_t) in
+// response to events.
+// Explaination: The allowed mode changes are listed in a transition table
+// with an optional guard and action for each. Every mode has entry, exit and
+// during actions. Events are queued as they happen (buttons, UART commands,
+// control channels finishing) and dispatched in the same tick. The most recent
+// transitions are kept in a log for debugging.
+// ************************************************************
+
+#ifndef FLIGHT_MODE_H_
+#define FLIGHT_MODE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stateInfo.h"
+
+#define FLIGHT_EVENT_QUEUE_SIZE 8
+#define FLIGHT_LOG_SIZE 16
+
+
+// Things which can cause a mode change.
+typedef enum {
+    FLIGHT_EV_TAKE_OFF = 0,  // SW1 switched up, or a fly command
+    FLIGHT_EV_LAND,  // SW1 switched down, or a land command
+    FLIGHT_EV_CALIBRATED,  // the yaw calibration channel finished
+    FLIGHT_EV_DESCENDED,  // the descending channel finished
+    FLIGHT_EV_POWERED_DOWN,  // the power down channel finished
+
+    // the value of this enum is the number of events defined above
+    FLIGHT_NUM_EVENTS
+} flight_event_t;
+
+
+// One mode change in the transition log.
+typedef struct {
+    uint32_t time;  // timer ticks when the transition happened, see timererTicksSince
+    uint8_t from;  // heli_state_t
+    uint8_t to;  // heli_state_t
+    uint8_t event;  // flight_event_t
+} flight_log_entry_t;
+
+
+// Listen for control channels finishing. The helicopter starts in STATE_LANDED.
+void flightModeInit(void);
+
+
+// Queue an event to be dispatched by the next flightModeDispatch(..). Returns false
+// if the queue is full and the event was dropped. Not for use from interrupts.
+bool flightModePost(flight_event_t event);
+
+
+// Take any transitions for the queued events, in the order they were posted. Events
+// with no transition from the current mode are discarded.
+void flightModeDispatch(state_t* state);
+
+
+// Dispatch queued events then run the during action of the current mode.
+void flightModeUpdate(state_t* state);
+
+
+// Copy up to maxEntries of the most recent transitions into entries, oldest first.
+// Returns the number copied.
+uint32_t flightModeGetLog(flight_log_entry_t* entries, uint32_t maxEntries);
+
+
+#endif /* FLIGHT_MODE_H_ */
@@ -0,0 +1,200 @@
+// ************************************************************
+// hal.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: The hardware the firmware modules use, behind one small interface.
+// Explaination: Each peripheral is reduced to the few operations the modules
+// need, with the pins, bases and TivaWare calls kept in the backend. halTiva.c
+// is the backend for the TM4C123 on the board. Building with HAL_HOST defined
+// swaps in tools/halHost.cpp instead, which runs the same modules on a PC in
+// virtual time, with the sensors driven and the outputs watched by the host
+// tools (see tools/halHost.h). Handlers registered here are called as
+// interrupts by both backends.
+// ************************************************************
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+typedef void (*hal_handler_t)(void);
+
+// PWM outputs, in pwm_channel_t order
+#define HAL_PWM_MAIN 0
+#define HAL_PWM_TAIL 1
+#define HAL_PWM_NUM_CHANNELS 2
+
+// UART interrupt causes, as returned by halUartIntStatus()
+#define HAL_UART_INT_TX 0x01  // room in the transmit FIFO
+#define HAL_UART_INT_RX 0x02  // characters in the receive FIFO
+
+// Encoder channels, as returned by halEncoderInit(..) and halEncoderIntStatus()
+#define HAL_ENCODER_A 0x01
+#define HAL_ENCODER_B 0x02
+
+
+// System
+
+// Reset the GPIO ports and set the system clock to 20 MHz.
+void halSystemInit(void);
+
+// Return the system clock in Hz.
+uint32_t halClockGet(void);
+
+// Reset the processor. Does not return.
+void halSystemReset(void);
+
+// Mask interrupts. Returns true if they were already masked, as IntMasterDisable().
+bool halInterruptsDisable(void);
+
+// Unmask interrupts.
+void halInterruptsEnable(void);
+
+
+// Cycle counter
+
+// Start the cycle counter from zero.
+void halCyclesInit(void);
+
+#ifdef HAL_HOST
+// Return the cycle counter. Moves virtual time on, see tools/halHost.h.
+uint32_t halCycles(void);
+#else
+#define HAL_DWT_CYCCNT 0xE0001004  // Cortex-M4 DWT cycle counter
+// Return the cycle counter. Inline so that reading it costs a load.
+static inline uint32_t halCycles(void)
+{
+    return *(volatile uint32_t*)HAL_DWT_CYCCNT;
+}
+#endif
+
+
+// Timer
+
+// Start a 32 bit periodic down counter at the system clock, reloading with load.
+void halTimerInit(uint32_t load);
+
+// Return the value of the down counter.
+uint32_t halTimerGet(void);
+
+// Called while busy waiting with ticks still to go. Does nothing on the board; the
+// host backend moves virtual time on to the next event instead of spinning.
+void halTimerIdle(uint32_t ticks);
+
+
+// SysTick
+
+// Call handler as an interrupt rate times a second.
+void halTickInit(uint32_t rate, hal_handler_t handler);
+
+
+// ADC, one channel converted on request
+
+// Set up the channel on the rig's height sensor, calling handler when a conversion completes.
+void halAdcInit(hal_handler_t handler);
+
+// Start a conversion.
+void halAdcTrigger(void);
+
+// Return the result of the last conversion and clear its interrupt.
+uint32_t halAdcRead(void);
+
+
+// PWM, counting up and down
+
+// Start channel at frequency Hz with its output off, calling handler once per period
+// where the width for the next period is set. Returns the period in counts.
+uint32_t halPwmInit(uint32_t channel, uint32_t frequency, hal_handler_t handler);
+
+// Clear the period interrupt of channel.
+void halPwmIntClear(uint32_t channel);
+
+// Set the pulse width of channel in counts, latched at the start of the next period.
+// Only even widths reach the output, see pwmDither.h.
+void halPwmSetWidth(uint32_t channel, uint32_t width);
+
+// Turn the output of channel on or off.
+void halPwmSetOutput(uint32_t channel, bool isOn);
+
+
+// Quadrature encoder
+
+// Set up both channels, calling handler on every edge of either. Returns the
+// HAL_ENCODER_A and B bits of the channels which were high before the interrupts
+// were enabled.
+uint32_t halEncoderInit(hal_handler_t handler);
+
+// Return the HAL_ENCODER_A and B bits of the channels with a pending edge, and clear them.
+uint32_t halEncoderIntStatus(void);
+
+
+// Yaw reference, active low
+
+// Set up the reference pin, calling handler on a falling edge once enabled.
+void halYawRefInit(hal_handler_t handler);
+
+// Enable the reference interrupt.
+void halYawRefEnable(void);
+
+// Disable the reference interrupt and clear any pending edge.
+void halYawRefDisable(void);
+
+
+// Buttons and switches, one bit per button in butNames order
+
+// Set up the button pins, calling handler on either edge of any of them.
+void halButtonsInit(hal_handler_t handler);
+
+// Return the bits of the buttons with a pending edge, and clear them.
+uint32_t halButtonsIntStatus(void);
+
+// Return the bits of the buttons whose pins are high.
+uint32_t halButtonsRead(void);
+
+
+// UART, 8 data bits, 1 stop bit, no parity
+
+// Start the UART at baud, calling handler when the transmit FIFO runs low or
+// characters are received.
+void halUartInit(uint32_t baud, hal_handler_t handler);
+
+// Return the HAL_UART_INT bits of the pending interrupts, and clear them.
+uint32_t halUartIntStatus(void);
+
+// Enable or disable the transmit interrupt.
+void halUartSetTxInt(bool isEnabled);
+
+// Return true if the transmit FIFO has room for a character.
+bool halUartSpaceAvail(void);
+
+// Put a character into the transmit FIFO, which must have room.
+void halUartPut(char c);
+
+// Return true if the receive FIFO has a character.
+bool halUartCharsAvail(void);
+
+// Take a character from the receive FIFO, which must have one.
+char halUartGet(void);
+
+
+// OLED
+
+// Start the OLED display.
+void halOledInit(void);
+
+// Draw str at column col of row row.
+void halOledDraw(const char* str, uint32_t col, uint32_t row);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_H_ */
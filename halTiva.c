@@ -0,0 +1,553 @@
+// ************************************************************
+// halTiva.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: The hardware interface of hal.h on the TM4C123 and Orbit board.
+// Explaination: All of the firmware's TivaWare calls, pins and peripheral
+// bases are here. The settings are those the modules used before the HAL:
+// WTIMER5 as the timer, ADC0 sequence 3 on channel 9, M0PWM7 (PC5) and M1PWM5
+// (PF1) counting up and down, the encoder on PB0 and PB1, the yaw reference on
+// PC4, UART0 on PA0 and PA1, and the buttons and switches on ports A, D, E and F.
+// ************************************************************
+
+#include "hal.h"
+
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/tm4c123gh6pm.h"  // Board specific defines (for PF0)
+#include "driverlib/adc.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/pwm.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
+#include "driverlib/uart.h"
+#include "OrbitOLED/OrbitOLEDInterface.h"
+#include "buttons4.h"
+
+// Cortex-M4 debug registers, see the ARMv7-M Architecture Reference Manual
+#define DEMCR 0xE000EDFC  // debug exception and monitor control
+#define DEMCR_TRCENA 0x01000000  // enables the DWT
+#define DWT_CTRL 0xE0001000
+#define DWT_CTRL_CYCCNTENA 0x00000001
+
+// Timer
+#define TIMER_PERIPH SYSCTL_PERIPH_WTIMER5
+#define TIMER_BASE WTIMER5_BASE
+#define TIMER_INTERVAL TIMER_A
+#define TIMER_MODE TIMER_CFG_A_PERIODIC
+
+// ADC: the rig's height sensor is on channel 9 (the potentiometer is channel 0)
+#define ADC_PERIPH SYSCTL_PERIPH_ADC0
+#define ADC_BASE ADC0_BASE
+#define ADC_SEQUENCE 3
+#define ADC_CHANNEL ADC_CTL_CH9
+
+// PWM
+#define PWM_DIVIDER_CODE SYSCTL_PWMDIV_4
+#define PWM_DIVIDER 4
+
+// Quadrature encoder channels A and B: PB0 and PB1
+#define ENCODER_PERIPH SYSCTL_PERIPH_GPIOB
+#define ENCODER_PORT_BASE GPIO_PORTB_BASE
+#define ENCODER_A_PIN GPIO_PIN_0
+#define ENCODER_B_PIN GPIO_PIN_1
+
+// Yaw reference: PC4
+#define REF_PERIPH SYSCTL_PERIPH_GPIOC
+#define REF_PORT_BASE GPIO_PORTC_BASE
+#define REF_PIN GPIO_PIN_4
+
+// USB Serial comms: UART0, Rx:PA0 , Tx:PA1
+#define UART_USB_BASE UART0_BASE
+#define UART_USB_PERIPH_UART SYSCTL_PERIPH_UART0
+#define UART_USB_PERIPH_GPIO SYSCTL_PERIPH_GPIOA
+#define UART_USB_GPIO_BASE GPIO_PORTA_BASE
+#define UART_USB_GPIO_PINS (GPIO_PIN_0 | GPIO_PIN_1)
+
+// A PWM output and its pins
+typedef struct {
+    uint32_t base;
+    uint32_t gen;
+    uint32_t outNum;
+    uint32_t outBit;
+    uint32_t periphPwm;
+    uint32_t periphGpio;
+    uint32_t gpioBase;
+    uint32_t gpioConfig;
+    uint32_t gpioPin;
+    uint32_t intGen;
+} pwm_output_t;
+
+// in HAL_PWM order
+static const pwm_output_t pwmOutputs[HAL_PWM_NUM_CHANNELS] = {
+    // Main Rotor: M0PWM7 (gen 3), PC5, J4-05
+    {PWM0_BASE, PWM_GEN_3, PWM_OUT_7, PWM_OUT_7_BIT, SYSCTL_PERIPH_PWM0, SYSCTL_PERIPH_GPIOC,
+     GPIO_PORTC_BASE, GPIO_PC5_M0PWM7, GPIO_PIN_5, PWM_INT_GEN_3},
+    // Tail rotor: M1PWM5 (gen 2), PF1
+    {PWM1_BASE, PWM_GEN_2, PWM_OUT_5, PWM_OUT_5_BIT, SYSCTL_PERIPH_PWM1, SYSCTL_PERIPH_GPIOF,
+     GPIO_PORTF_BASE, GPIO_PF1_M1PWM5, GPIO_PIN_1, PWM_INT_GEN_2}
+};
+
+// A button pin
+typedef struct {
+    uint32_t periph;
+    uint32_t portBase;
+    uint8_t pin;
+    uint32_t padType;  // pull down for active high, pull up for active low
+} button_pin_t;
+
+// in butNames order. UP and DOWN are on the Orbit daughterboard, LEFT and RIGHT are
+// SW1 and SW2 on the Tiva, and SW1 and SW2 are the Orbit slide switches.
+static const button_pin_t buttonPins[NUM_BUTS] = {
+    {SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_0, GPIO_PIN_TYPE_STD_WPD},  // UP
+    {SYSCTL_PERIPH_GPIOD, GPIO_PORTD_BASE, GPIO_PIN_2, GPIO_PIN_TYPE_STD_WPD},  // DOWN
+    {SYSCTL_PERIPH_GPIOF, GPIO_PORTF_BASE, GPIO_PIN_4, GPIO_PIN_TYPE_STD_WPU},  // LEFT
+    {SYSCTL_PERIPH_GPIOF, GPIO_PORTF_BASE, GPIO_PIN_0, GPIO_PIN_TYPE_STD_WPU},  // RIGHT
+    {SYSCTL_PERIPH_GPIOA, GPIO_PORTA_BASE, GPIO_PIN_7, GPIO_PIN_TYPE_STD_WPD},  // SW1
+    {SYSCTL_PERIPH_GPIOA, GPIO_PORTA_BASE, GPIO_PIN_6, GPIO_PIN_TYPE_STD_WPU}   // SW2
+};
+
+
+//
+// System
+//
+
+
+// Reset the GPIO ports and set the system clock to 20 MHz.
+void halSystemInit(void)
+{
+    // Reset ports for good measure. Other peripherals are reset as they are started.
+    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOA);
+    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOB);
+    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOC);
+    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOD);
+    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOE);
+    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOF);
+
+    SysCtlClockSet(SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ | SYSCTL_SYSDIV_10);
+}
+
+
+// Return the system clock in Hz.
+uint32_t halClockGet(void)
+{
+    return SysCtlClockGet();
+}
+
+
+// Reset the processor. Does not return.
+void halSystemReset(void)
+{
+    SysCtlReset();
+}
+
+
+// Mask interrupts. Returns true if they were already masked, as IntMasterDisable().
+bool halInterruptsDisable(void)
+{
+    return IntMasterDisable();
+}
+
+
+// Unmask interrupts.
+void halInterruptsEnable(void)
+{
+    IntMasterEnable();
+}
+
+
+//
+// Cycle counter
+//
+
+
+// Start the cycle counter from zero.
+void halCyclesInit(void)
+{
+    HWREG(DEMCR) |= DEMCR_TRCENA;
+    HWREG(HAL_DWT_CYCCNT) = 0;
+    HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+}
+
+
+//
+// Timer
+//
+
+
+// Start a 32 bit periodic down counter at the system clock, reloading with load.
+void halTimerInit(uint32_t load)
+{
+    SysCtlPeripheralReset(TIMER_PERIPH);  // reset for good measure
+
+    SysCtlPeripheralEnable(TIMER_PERIPH);
+    TimerDisable(TIMER_BASE, TIMER_INTERVAL);
+    TimerConfigure(TIMER_BASE, TIMER_MODE);
+    TimerLoadSet(TIMER_BASE, TIMER_INTERVAL, load);
+    TimerEnable(TIMER_BASE, TIMER_INTERVAL);
+}
+
+
+// Return the value of the down counter.
+uint32_t halTimerGet(void)
+{
+    return TimerValueGet(TIMER_BASE, TIMER_INTERVAL);
+}
+
+
+// Called while busy waiting with ticks still to go. Nothing to do on the board.
+void halTimerIdle(uint32_t ticks)
+{
+}
+
+
+//
+// SysTick
+//
+
+
+// Call handler as an interrupt rate times a second.
+void halTickInit(uint32_t rate, hal_handler_t handler)
+{
+    SysTickPeriodSet(SysCtlClockGet() / rate);
+    SysTickIntRegister(handler);
+    SysTickIntEnable();
+    SysTickEnable();
+}
+
+
+//
+// ADC
+//
+
+
+// Set up the channel on the rig's height sensor, calling handler when a conversion completes.
+void halAdcInit(hal_handler_t handler)
+{
+    SysCtlPeripheralReset(ADC_PERIPH);  // reset for good measure
+    SysCtlPeripheralEnable(ADC_PERIPH);
+
+    // Sequence 3 does a single sample when the processor sends a signal to start the
+    // conversion. Its only step samples the channel in single-ended mode (default),
+    // sets the interrupt flag when done (ADC_CTL_IE), and is the last (ADC_CTL_END).
+    ADCSequenceConfigure(ADC_BASE, ADC_SEQUENCE, ADC_TRIGGER_PROCESSOR, 0);
+    ADCSequenceStepConfigure(ADC_BASE, ADC_SEQUENCE, 0, ADC_CHANNEL | ADC_CTL_IE | ADC_CTL_END);
+    ADCSequenceEnable(ADC_BASE, ADC_SEQUENCE);
+
+    ADCIntRegister(ADC_BASE, ADC_SEQUENCE, handler);
+    ADCIntEnable(ADC_BASE, ADC_SEQUENCE);  // clears any outstanding interrupts
+}
+
+
+// Start a conversion.
+void halAdcTrigger(void)
+{
+    ADCProcessorTrigger(ADC_BASE, ADC_SEQUENCE);
+}
+
+
+// Return the result of the last conversion and clear its interrupt.
+uint32_t halAdcRead(void)
+{
+    uint32_t value;
+
+    ADCSequenceDataGet(ADC_BASE, ADC_SEQUENCE, &value);
+    ADCIntClear(ADC_BASE, ADC_SEQUENCE);
+    return value;
+}
+
+
+//
+// PWM
+//
+
+
+// Start channel at frequency Hz with its output off, calling handler once per period
+// where the width for the next period is set. Returns the period in counts.
+uint32_t halPwmInit(uint32_t channel, uint32_t frequency, hal_handler_t handler)
+{
+    const pwm_output_t* out = &pwmOutputs[channel];
+    uint32_t period = SysCtlClockGet() / PWM_DIVIDER / frequency;
+
+    SysCtlPeripheralReset(out->periphPwm);  // the GPIO pins are reset by halSystemInit()
+    SysCtlPeripheralEnable(out->periphPwm);
+    SysCtlPeripheralEnable(out->periphGpio);
+    GPIOPinConfigure(out->gpioConfig);
+    GPIOPinTypePWM(out->gpioBase, out->gpioPin);
+
+    PWMGenConfigure(out->base, out->gen, PWM_GEN_MODE_UP_DOWN | PWM_GEN_MODE_NO_SYNC);
+    PWMGenPeriodSet(out->base, out->gen, period);
+    PWMPulseWidthSet(out->base, out->outNum, 0);
+
+    // triggered when the counter reaches the load value, the middle of the period in
+    // up/down mode. A width set then is latched when the counter next reaches zero.
+    PWMGenIntRegister(out->base, out->gen, handler);
+    PWMGenIntTrigEnable(out->base, out->gen, PWM_INT_CNT_LOAD);
+    PWMIntEnable(out->base, out->intGen);
+    PWMGenEnable(out->base, out->gen);
+    PWMOutputState(out->base, out->outBit, false);
+
+    SysCtlPWMClockSet(PWM_DIVIDER_CODE);
+    return period;
+}
+
+
+// Clear the period interrupt of channel.
+void halPwmIntClear(uint32_t channel)
+{
+    PWMGenIntClear(pwmOutputs[channel].base, pwmOutputs[channel].gen, PWM_INT_CNT_LOAD);
+}
+
+
+// Set the pulse width of channel in counts, latched at the start of the next period.
+void halPwmSetWidth(uint32_t channel, uint32_t width)
+{
+    PWMPulseWidthSet(pwmOutputs[channel].base, pwmOutputs[channel].outNum, width);
+}
+
+
+// Turn the output of channel on or off.
+void halPwmSetOutput(uint32_t channel, bool isOn)
+{
+    PWMOutputState(pwmOutputs[channel].base, pwmOutputs[channel].outBit, isOn);
+}
+
+
+//
+// Quadrature encoder
+//
+
+
+// Set up both channels, calling handler on every edge of either. Returns the
+// HAL_ENCODER_A and B bits of the channels which were high before the interrupts
+// were enabled.
+uint32_t halEncoderInit(hal_handler_t handler)
+{
+    uint32_t pins = ENCODER_A_PIN | ENCODER_B_PIN;
+    uint32_t levels;
+
+    SysCtlPeripheralEnable(ENCODER_PERIPH);
+    GPIOPadConfigSet(ENCODER_PORT_BASE, pins, GPIO_STRENGTH_4MA, GPIO_PIN_TYPE_STD_WPD);  // active HIGH
+    GPIODirModeSet(ENCODER_PORT_BASE, pins, GPIO_DIR_MODE_IN);
+    GPIOIntRegister(ENCODER_PORT_BASE, handler);
+    GPIOIntTypeSet(ENCODER_PORT_BASE, pins, GPIO_BOTH_EDGES);
+
+    levels = GPIOPinRead(ENCODER_PORT_BASE, pins);
+    GPIOIntEnable(ENCODER_PORT_BASE, pins);
+    return (levels & ENCODER_A_PIN ? HAL_ENCODER_A : 0) | (levels & ENCODER_B_PIN ? HAL_ENCODER_B : 0);
+}
+
+
+// Return the HAL_ENCODER_A and B bits of the channels with a pending edge, and clear them.
+uint32_t halEncoderIntStatus(void)
+{
+    uint32_t status = GPIOIntStatus(ENCODER_PORT_BASE, true);
+
+    GPIOIntClear(ENCODER_PORT_BASE, ENCODER_A_PIN | ENCODER_B_PIN);
+    return (status & ENCODER_A_PIN ? HAL_ENCODER_A : 0) | (status & ENCODER_B_PIN ? HAL_ENCODER_B : 0);
+}
+
+
+//
+// Yaw reference
+//
+
+
+// Set up the reference pin, calling handler on a falling edge once enabled.
+void halYawRefInit(hal_handler_t handler)
+{
+    SysCtlPeripheralEnable(REF_PERIPH);
+    GPIOPadConfigSet(REF_PORT_BASE, REF_PIN, GPIO_STRENGTH_4MA, GPIO_PIN_TYPE_STD_WPU);  // active LOW
+    GPIODirModeSet(REF_PORT_BASE, REF_PIN, GPIO_DIR_MODE_IN);
+    GPIOIntRegister(REF_PORT_BASE, handler);
+    GPIOIntTypeSet(REF_PORT_BASE, REF_PIN, GPIO_FALLING_EDGE);
+}
+
+
+// Enable the reference interrupt.
+void halYawRefEnable(void)
+{
+    GPIOIntEnable(REF_PORT_BASE, REF_PIN);
+}
+
+
+// Disable the reference interrupt and clear any pending edge.
+void halYawRefDisable(void)
+{
+    GPIOIntDisable(REF_PORT_BASE, REF_PIN);
+    GPIOIntClear(REF_PORT_BASE, REF_PIN);
+}
+
+
+//
+// Buttons
+//
+
+
+// Set up the button pins, calling handler on either edge of any of them.
+void halButtonsInit(hal_handler_t handler)
+{
+    int i;
+
+    for (i = 0; i < NUM_BUTS; i++) {
+        const button_pin_t* but = &buttonPins[i];
+
+        SysCtlPeripheralEnable(but->periph);
+        if (but->portBase == GPIO_PORTF_BASE && but->pin == GPIO_PIN_0) {
+            // PF0 is one of a handful of GPIO pins that need to be "unlocked" before
+            // they can be reconfigured, see PhilsNotesOnTiva.rtf.
+            GPIO_PORTF_LOCK_R = GPIO_LOCK_KEY;
+            GPIO_PORTF_CR_R |= GPIO_PIN_0;
+            GPIO_PORTF_LOCK_R = GPIO_LOCK_M;
+        }
+        GPIOPinTypeGPIOInput(but->portBase, but->pin);
+        GPIOPadConfigSet(but->portBase, but->pin, GPIO_STRENGTH_2MA, but->padType);
+    }
+
+    // a port has a single interrupt handler, so ports shared by buttons are registered twice
+    for (i = 0; i < NUM_BUTS; i++) {
+        const button_pin_t* but = &buttonPins[i];
+
+        GPIOIntRegister(but->portBase, handler);
+        GPIOIntTypeSet(but->portBase, but->pin, GPIO_BOTH_EDGES);
+        GPIOIntClear(but->portBase, but->pin);
+        GPIOIntEnable(but->portBase, but->pin);
+    }
+}
+
+
+// Return the bits of the buttons with a pending edge, and clear them.
+uint32_t halButtonsIntStatus(void)
+{
+    uint32_t status = 0;
+    int i;
+
+    for (i = 0; i < NUM_BUTS; i++) {
+        const button_pin_t* but = &buttonPins[i];
+
+        if (GPIOIntStatus(but->portBase, true) & but->pin) {
+            GPIOIntClear(but->portBase, but->pin);
+            status |= 1 << i;
+        }
+    }
+    return status;
+}
+
+
+// Return the bits of the buttons whose pins are high.
+uint32_t halButtonsRead(void)
+{
+    uint32_t levels = 0;
+    int i;
+
+    for (i = 0; i < NUM_BUTS; i++) {
+        if (GPIOPinRead(buttonPins[i].portBase, buttonPins[i].pin) == buttonPins[i].pin) {
+            levels |= 1 << i;
+        }
+    }
+    return levels;
+}
+
+
+//
+// UART
+//
+
+
+// Start the UART at baud, calling handler when the transmit FIFO runs low or
+// characters are received.
+void halUartInit(uint32_t baud, hal_handler_t handler)
+{
+    SysCtlPeripheralReset(UART_USB_PERIPH_UART);  // reset for good measure
+    SysCtlPeripheralEnable(UART_USB_PERIPH_UART);
+    SysCtlPeripheralEnable(UART_USB_PERIPH_GPIO);
+
+    // Select the alternate (UART) function for these pins.
+    GPIOPinTypeUART(UART_USB_GPIO_BASE, UART_USB_GPIO_PINS);
+    UARTConfigSetExpClk(UART_USB_BASE, SysCtlClockGet(), baud,
+                        UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE);
+    UARTFIFOEnable(UART_USB_BASE);
+
+    // interrupt when the transmit FIFO drains below 1/8 full so it can be topped up
+    // and when the receive FIFO is half full (or a receive timeout occurs) so it can be emptied
+    UARTFIFOLevelSet(UART_USB_BASE, UART_FIFO_TX1_8, UART_FIFO_RX4_8);
+    UARTTxIntModeSet(UART_USB_BASE, UART_TXINT_MODE_FIFO);
+    UARTIntRegister(UART_USB_BASE, handler);
+    UARTIntEnable(UART_USB_BASE, UART_INT_TX | UART_INT_RX | UART_INT_RT);
+    UARTEnable(UART_USB_BASE);
+}
+
+
+// Return the HAL_UART_INT bits of the pending interrupts, and clear them.
+uint32_t halUartIntStatus(void)
+{
+    uint32_t status = UARTIntStatus(UART_USB_BASE, true);
+
+    UARTIntClear(UART_USB_BASE, status);
+    return (status & UART_INT_TX ? HAL_UART_INT_TX : 0) |
+           (status & (UART_INT_RX | UART_INT_RT) ? HAL_UART_INT_RX : 0);
+}
+
+
+// Enable or disable the transmit interrupt.
+void halUartSetTxInt(bool isEnabled)
+{
+    if (isEnabled) {
+        UARTIntEnable(UART_USB_BASE, UART_INT_TX);
+    } else {
+        UARTIntDisable(UART_USB_BASE, UART_INT_TX);
+    }
+}
+
+
+// Return true if the transmit FIFO has room for a character.
+bool halUartSpaceAvail(void)
+{
+    return UARTSpaceAvail(UART_USB_BASE);
+}
+
+
+// Put a character into the transmit FIFO, which must have room.
+void halUartPut(char c)
+{
+    UARTCharPutNonBlocking(UART_USB_BASE, c);
+}
+
+
+// Return true if the receive FIFO has a character.
+bool halUartCharsAvail(void)
+{
+    return UARTCharsAvail(UART_USB_BASE);
+}
+
+
+// Take a character from the receive FIFO, which must have one.
+char halUartGet(void)
+{
+    return UARTCharGetNonBlocking(UART_USB_BASE);
+}
+
+
+//
+// OLED
+//
+
+
+// Start the OLED display.
+void halOledInit(void)
+{
+    OLEDInitialise();
+}
+
+
+// Draw str at column col of row row.
+void halOledDraw(const char* str, uint32_t col, uint32_t row)
+{
+    OLEDStringDraw((char*)str, col, row);
+}
@@ -9,8 +9,13 @@
 // ************************************************************
 
 #include "height.h"
+#include "hal.h"
 #include "circBufT.h"
 #include "adcModule.h"
+#include "recorder.h"
+#include "probe.h"
+#include "timerer.h"
+#include "trace.h"
 
 #define CONV_UNIFORM_MULTIPLIER 100
 #define CONV_BASE (CONV_SIZE * CONV_UNIFORM_MULTIPLIER)
@@ -24,12 +29,18 @@ static circBuf_t buf;
 static int32_t convolutionArray[CONV_SIZE];
 static int32_t baseMean = 0;
 static int32_t meanHeight = 0;
+static volatile uint32_t newestSampleTime = 0;  // timer ticks when the last ADC sample arrived
+static uint32_t meanSampleTime = 0;  // newestSampleTime when the average was calculated
 
 
 // start an adc read for each system tick internal
 void SysTickIntHandler(void)
 {
+    TRACE(TRACE_ISR_ENTER, PROBE_SYSTICK_ISR, 0);
+    PROBE_START(start);
     adcTrigger();
+    PROBE_STOP(PROBE_SYSTICK_ISR, start);
+    TRACE(TRACE_ISR_EXIT, PROBE_SYSTICK_ISR, 0);
 }
 
 
@@ -37,17 +48,15 @@ void SysTickIntHandler(void)
 void handleNewADCValue(uint32_t val)
 {
     writeCircBuf(&buf, val);
+    newestSampleTime = timererGetTicks();
+    recorderAddSample(val);
 }
 
 
 // setup the system tick timer to run adc
 void heightInit(height_conv convType)
 {
-    SysTickPeriodSet(SysCtlClockGet() / ADC_SAMPLE_RATE);
-    SysTickIntRegister(SysTickIntHandler);
-    // Enable interrupt and device
-    SysTickIntEnable();
-    SysTickEnable();
+    halTickInit(ADC_SAMPLE_RATE, SysTickIntHandler);
     initCircBuf(&buf, CONV_SIZE);
     adcInit(handleNewADCValue);
 
@@ -90,8 +99,18 @@ void heightUpdate(void)
 {
     int32_t sum = 0;
     int i;
+
+    // taken first so that a sample arriving during the sum can only make the age look longer
+    meanSampleTime = newestSampleTime;
     for (i = 0; i < CONV_SIZE; i++) {
         sum = sum + (readCircBuf(&buf) * convolutionArray[i]);
     }
     meanHeight = sum / CONV_BASE;
 }
+
+
+// return the timer ticks when the newest sample in the average was taken, see timererTicksSince
+uint32_t heightGetSampleTime(void)
+{
+    return meanSampleTime;
+}
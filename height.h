@@ -14,16 +14,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#include "utils/ustdlib.h"
-#include "driverlib/gpio.h"       // defines for GPIO peripheral
-#include "driverlib/sysctl.h"     // system control functions
-#include "driverlib/systick.h"
-#include "driverlib/interrupt.h"
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
 
 #define CONV_SIZE 20  // length of convolution array
 #define HEIGHT_UPDATE_RATE 4  // Hz - assuming signal frequency of 4 Hz
 #define ADC_SAMPLE_RATE (CONV_SIZE * 2 * HEIGHT_UPDATE_RATE)  // Hz - by Nyquist theorm
 
+// us - how far the uniform average lags the newest sample (the middle of the window)
+#define HEIGHT_FILTER_DELAY_US ((CONV_SIZE - 1) * 1000000 / 2 / ADC_SAMPLE_RATE)
+
 
 // convolution type used for avera
 typedef enum height_conv_t {
@@ -51,4 +52,11 @@ int32_t heightAsPercentage(int32_t precision);
 void heightUpdate(void);
 
 
+// return the timer ticks when the newest sample in the average was taken, see timererTicksSince
+uint32_t heightGetSampleTime(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* HEIGHT_H_ */
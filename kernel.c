@@ -6,6 +6,11 @@
 //
 // Purpose: A paced round robin scheduler for running tasks as specified frequencies.
 // Different frequencies are achieved by dividing the base frequency (using counters).
+// Each heli mode can have its own task table, and the time spent running tasks is
+// measured for each mode.
+// Explaination: A frame which takes longer than its time is a deadline miss. Each miss
+// raises the shed level, which runs sheddable tasks (displays, telemetry) less often so
+// that control keeps its rate. Once frames are quiet again the level drops step by step.
 // ************************************************************
 
 
@@ -13,17 +18,24 @@
 #include "timerer.h"
 
 
-// A simple round robin scheduler.
-// Uses an infinite loop to run the tasks at specified frequencies relative to baseFreq. Make
-// sure baseFreq is greater than or equal to all task frequencies otherwise the tasks will
-// not be run at the correct rate. A pointer to a state object stores entries applicable to
-// many tasks.
-void runTasks(task_t* tasks, state_t* sharedState, int32_t baseFreq)
-{
-    // initalise the value to count up to for each task so that
-    // tasks can run at different frequencies
-    int32_t deltaTime = 1000 / baseFreq;  // in milliseconds, hence the 1000 factor
+// running totals for the load in each mode
+static uint32_t modeFrames[NUM_HELI_STATES];
+static uint64_t modeBusyTicks[NUM_HELI_STATES];
+static uint32_t modePeakTicks[NUM_HELI_STATES];
+static uint32_t frameTicks = 1;  // timer ticks in one frame, set by runModeTasks(..)
 
+// load shedding
+static uint32_t shedMaxLevel = KERNEL_MAX_SHED_LEVEL;
+static uint32_t shedRecoverFrames = KERNEL_RECOVER_FRAMES;
+static uint32_t quietFrames = 0;  // in a row, since the last change of level
+static kernel_shed_stats_t shedStats;
+static uint32_t taskPeriod = 0;  // ms between full rate runs of the task being run
+
+
+// Set the value to count up to for each task so that tasks can run at different
+// frequencies. The counts start again from zero.
+static void initTasks(task_t* tasks, int32_t baseFreq)
+{
     // loop until empty terminator task
     int i = 0;
     while (tasks[i].handler) {
@@ -38,13 +50,80 @@ void runTasks(task_t* tasks, state_t* sharedState, int32_t baseFreq)
         // initalise all tasks
         tasks[i].count = 0;
         tasks[i].triggerAt = triggerCount;
+        tasks[i].skipped = 0;
         i++;
     }
+}
+
+
+// Raise the shed level on an overrun frame, and lower it after enough quiet frames.
+static void updateShedLevel(uint32_t busyTicks)
+{
+    if (busyTicks > frameTicks) {
+        shedStats.deadlineMisses++;
+        quietFrames = 0;
+        if (shedStats.level < shedMaxLevel) {
+            shedStats.level++;
+            if (shedStats.level > shedStats.maxLevel) {
+                shedStats.maxLevel = shedStats.level;
+            }
+        }
+    } else if ((uint64_t)busyTicks * KERNEL_LOAD_SCALE < (uint64_t)frameTicks * KERNEL_RECOVER_LOAD) {
+        quietFrames++;
+        if (quietFrames >= shedRecoverFrames && shedStats.level > 0) {
+            shedStats.level--;
+            quietFrames = 0;
+        }
+    } else {
+        // busy but on time, hold the current level
+        quietFrames = 0;
+    }
+}
+
+
+// A simple round robin scheduler.
+// Uses an infinite loop to run the tasks at specified frequencies relative to baseFreq. Make
+// sure baseFreq is greater than or equal to all task frequencies otherwise the tasks will
+// not be run at the correct rate. A pointer to a state object stores entries applicable to
+// many tasks.
+void runTasks(task_t* tasks, state_t* sharedState, int32_t baseFreq)
+{
+    task_t* modeTasks[NUM_HELI_STATES];
+    int mode;
+
+    // the same tasks in every mode
+    for (mode = 0; mode < NUM_HELI_STATES; mode++) {
+        modeTasks[mode] = tasks;
+    }
+    runModeTasks(modeTasks, sharedState, baseFreq);
+}
+
+
+// As runTasks(..), but with a task table for each heli mode, indexed by heli_state_t. The
+// table is chosen from sharedState->heliMode at the start of each frame, so a mode change
+// made by a task takes effect from the next frame. Tables may be shared between modes.
+void runModeTasks(task_t* modeTasks[NUM_HELI_STATES], state_t* sharedState, int32_t baseFreq)
+{
+    int32_t deltaTime = 1000 / baseFreq;  // in milliseconds, hence the 1000 factor
+    heli_state_t mode = sharedState->heliMode;
+    task_t* tasks = modeTasks[mode];
+
+    frameTicks = timererMsToTicks(deltaTime);
+    initTasks(tasks, baseFreq);
 
     // begin the main loop
     while (true) {
         int32_t referenceTime = timererGetTicks();
 
+        // only change tables between frames so a frame never mixes two tables
+        if (sharedState->heliMode != mode) {
+            mode = sharedState->heliMode;
+            if (modeTasks[mode] != tasks) {
+                tasks = modeTasks[mode];
+                initTasks(tasks, baseFreq);
+            }
+        }
+
         int i = 0;
         while (tasks[i].handler) {
             tasks[i].count++;
@@ -53,13 +132,77 @@ void runTasks(task_t* tasks, state_t* sharedState, int32_t baseFreq)
             if (tasks[i].count == tasks[i].triggerAt) {
                 tasks[i].count = 0;
 
-                // run the task
-                tasks[i].handler(sharedState, deltaTime * tasks[i].triggerAt);
+                if (tasks[i].sheddable && tasks[i].skipped + 1 < (1u << shedStats.level)) {
+                    // overloaded, skip this run
+                    tasks[i].skipped++;
+                    tasks[i].shedCount++;
+                    shedStats.shedRuns++;
+                } else {
+                    // run the task, with the time since it last ran
+                    taskPeriod = deltaTime * tasks[i].triggerAt;
+                    TRACE(TRACE_TASK_START, tasks[i].probe, 0);
+                    PROBE_START(taskStart);
+                    tasks[i].handler(sharedState, taskPeriod * (tasks[i].skipped + 1));
+                    PROBE_STOP(tasks[i].probe, taskStart);
+                    TRACE(TRACE_TASK_STOP, tasks[i].probe, 0);
+                    tasks[i].skipped = 0;
+                }
             }
               i++;
         }
 
+        // charge the time spent to the mode the frame started in
+        uint32_t busyTicks = timererTicksSince(referenceTime);
+        modeFrames[mode]++;
+        modeBusyTicks[mode] += busyTicks;
+        if (busyTicks > modePeakTicks[mode]) {
+            modePeakTicks[mode] = busyTicks;
+        }
+        updateShedLevel(busyTicks);
+
         // make sure loop runs as a consistent speed
         timererWaitFrom(deltaTime, referenceTime);
     }
 }
+
+
+// Return the ms between runs of the task being run, at its full rate. A task's
+// deltaTime is longer than this when runs before it were shed, so use this for
+// work which should not pile up into the runs which do happen.
+uint32_t kernelGetTaskPeriod(void)
+{
+    return taskPeriod;
+}
+
+
+// Copy the processor load measured while in mode into load.
+void kernelGetLoad(heli_state_t mode, kernel_load_t* load)
+{
+    load->frames = modeFrames[mode];
+    load->averageLoad = 0;
+    if (modeFrames[mode]) {
+        load->averageLoad = modeBusyTicks[mode] * KERNEL_LOAD_SCALE / ((uint64_t)modeFrames[mode] * frameTicks);
+    }
+    load->peakLoad = (uint64_t)modePeakTicks[mode] * KERNEL_LOAD_SCALE / frameTicks;
+}
+
+
+// Set how hard the scheduler sheds load. When a frame overruns the shed level goes up by
+// one, to at most maxLevel, and sheddable tasks run at 1 / 2^level of their rate. After
+// recoverFrames quiet frames in a row the level comes down by one. A maxLevel of 0 turns
+// shedding off. The default is KERNEL_MAX_SHED_LEVEL and KERNEL_RECOVER_FRAMES.
+void kernelSetShedPolicy(uint32_t maxLevel, uint32_t recoverFrames)
+{
+    shedMaxLevel = maxLevel < KERNEL_MAX_SHED_LEVEL ? maxLevel : KERNEL_MAX_SHED_LEVEL;
+    shedRecoverFrames = recoverFrames;
+    if (shedStats.level > shedMaxLevel) {
+        shedStats.level = shedMaxLevel;
+    }
+}
+
+
+// Copy the counts of overrun frames and shed task runs into stats.
+void kernelGetShedStats(kernel_shed_stats_t* stats)
+{
+    *stats = shedStats;
+}
@@ -6,6 +6,8 @@
 //
 // Purpose: A paced round robin scheduler for running tasks as specified frequencies.
 // Different frequencies are achieved by dividing the base frequency (using counters).
+// Each heli mode can have its own task table, and the time spent running tasks is
+// measured for each mode.
 // ************************************************************
 
 #ifndef KERNEL_H_
@@ -15,16 +17,50 @@
 #include <stdbool.h>
 
 #include "stateInfo.h"
+#include "probe.h"
+#include "trace.h"
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define KERNEL_MAX_SHED_LEVEL 3  // sheddable tasks run at down to 1 / 2^3 of their rate
+#define KERNEL_RECOVER_FRAMES 100  // default number of quiet frames before shedding less
+#define KERNEL_RECOVER_LOAD 750  // a frame is quiet when its load is below this, see KERNEL_LOAD_SCALE
+
 
 // Object to configure a handler for use in the task scheduler.
 typedef struct {
     void (*handler) (state_t* state, uint32_t deltaTime);  // pointer to task handler function
     uint32_t updateFreq;  // number of ms between runs
+    bool sheddable;  // may be run less often when frames overrun, never set for control
+    probe_id_t probe;  // times each run, PROBE_NONE (0) for no probe
     uint32_t count;  // used by the kernal only
     uint32_t triggerAt;  // used by the kernal only
+    uint32_t skipped;  // used by the kernal only, runs shed since the last run
+    uint32_t shedCount;  // total runs shed, read only
 } task_t;
 
 
+#define KERNEL_LOAD_SCALE 1000  // loads are in parts per KERNEL_LOAD_SCALE of the frame time
+
+// The processor time used by the tasks in one mode.
+typedef struct {
+    uint32_t frames;  // number of frames run in the mode
+    uint32_t averageLoad;  // mean of busy time / frame time, scaled by KERNEL_LOAD_SCALE
+    uint32_t peakLoad;  // the busiest frame, scaled by KERNEL_LOAD_SCALE
+} kernel_load_t;
+
+
+// What the scheduler has done about overrun frames.
+typedef struct {
+    uint32_t deadlineMisses;  // frames which took longer than the frame time
+    uint32_t shedRuns;  // task runs skipped over all tasks
+    uint32_t level;  // current shed level, 0 when every task runs at its full rate
+    uint32_t maxLevel;  // highest level reached
+} kernel_shed_stats_t;
+
+
 // A simple round robin scheduler.
 // Uses an infinite loop to run the tasks at specified frequencies relative to baseFreq. Make
 // sure baseFreq is greater than or equal to all task frequencies otherwise the tasks will
@@ -33,4 +69,35 @@ typedef struct {
 void runTasks(task_t* tasks, state_t* sharedState, int32_t baseFreq);
 
 
+// As runTasks(..), but with a task table for each heli mode, indexed by heli_state_t. The
+// table is chosen from sharedState->heliMode at the start of each frame, so a mode change
+// made by a task takes effect from the next frame. Tables may be shared between modes.
+void runModeTasks(task_t* modeTasks[NUM_HELI_STATES], state_t* sharedState, int32_t baseFreq);
+
+
+// Return the ms between runs of the task being run, at its full rate. A task's
+// deltaTime is longer than this when runs before it were shed, so use this for
+// work which should not pile up into the runs which do happen.
+uint32_t kernelGetTaskPeriod(void);
+
+
+// Copy the processor load measured while in mode into load.
+void kernelGetLoad(heli_state_t mode, kernel_load_t* load);
+
+
+// Set how hard the scheduler sheds load. When a frame overruns the shed level goes up by
+// one, to at most maxLevel, and sheddable tasks run at 1 / 2^level of their rate. After
+// recoverFrames quiet frames in a row the level comes down by one. A maxLevel of 0 turns
+// shedding off. The default is KERNEL_MAX_SHED_LEVEL and KERNEL_RECOVER_FRAMES.
+void kernelSetShedPolicy(uint32_t maxLevel, uint32_t recoverFrames);
+
+
+// Copy the counts of overrun frames and shed task runs into stats.
+void kernelGetShedStats(kernel_shed_stats_t* stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* KERNEL_H_ */
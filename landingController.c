@@ -11,35 +11,44 @@
 // ************************************************************
 
 
+#include <stdlib.h>
+
 #include "landingController.h"
 #include "control.h"
 
 
-#define LANDING_RATE 25 // height descent rate in % per second
 #define LANDING_TIME_OUT 7500 // heli will time out (force land) if stability not reached in 7.5 seconds
-#define STABILITY_TIME_MAIN 500 // Heli must remain within specified bounds for 500 ms to register as stable
-#define MS_TO_SEC 1000 // used for converting milliseconds into seconds
+#define STABILITY_WINDOW 300 // ms of measurements used to decide if the heli is stable
 #define YAW_STABILITY_ERROR 2 // accept yaw stability if within +- 2 degrees of target
+#define HEIGHT_STABILITY_ERROR 1 // accept height stability if within 1 % of the ground
+#define YAW_STABILITY_DEVIATION 1 // degrees, standard deviation of the yaw error when stable
+#define HEIGHT_STABILITY_DEVIATION 1 // %, standard deviation of the height when stable
+
+// squared deviations for comparing with the variance, scaled by PRECISION squared
+#define YAW_STABILITY_VARIANCE ((int64_t)YAW_STABILITY_DEVIATION * YAW_STABILITY_DEVIATION * PRECISION * PRECISION)
+#define HEIGHT_STABILITY_VARIANCE ((int64_t)HEIGHT_STABILITY_DEVIATION * HEIGHT_STABILITY_DEVIATION * PRECISION * PRECISION)
+#define SIGN(n) ((n) < 0 ? -1 : 1)
+
 
+// Description: Prepares for a new landing by clearing the stability measurements and time out.
+void landingControllerReset(landing_controller_t* landing)
+{
+    windowStatsInit(&landing->heightWindow, STABILITY_WINDOW);
+    windowStatsInit(&landing->yawWindow, STABILITY_WINDOW);
+    landing->landingTime = 0;
+}
 
-// Description: Ramp function for yaw: Finds nearest 360 degree target and increments/decrements the target to this position
+
+// Description: Sets the yaw target to the nearest multiple of 360 degrees. The controller's
+//              trajectory generator moves the reference there in minimum time.
 // Parameters:  state_t* state is a pointer to the data structure containing the yaw and height targets. int32_t yawDegrees
 //              is the measured yaw of the heli in degrees, scaled by PRECISION.
 void rampYaw(state_t *state, int32_t yawDegrees)
 {
-    if (yawDegrees > 0 && abs(state->targetYaw) % 360 != 0) { // Case for +ve yaw
-        if (abs(yawDegrees) % (360 * PRECISION) <= (180 * PRECISION)) { // Evaluates position relative to target to find nearest
-            state->targetYaw -= 1;
-        } else {
-            state->targetYaw += 1;
-        }
-    } else if (yawDegrees < 0 && abs(state->targetYaw) % 360 != 0) { // Case for -ve yaw
-        if (abs(yawDegrees) % (360 * PRECISION) <= (180 * PRECISION)) {
-            state->targetYaw += 1;
-        } else {
-            state->targetYaw -= 1;
-        }
-    }
+    // round to the nearest whole rotation (division truncates towards zero, so add half a
+    // rotation in the direction of the sign first)
+    int32_t rotations = (yawDegrees + SIGN(yawDegrees) * 180 * PRECISION) / (360 * PRECISION);
+    state->targetYaw = rotations * 360;
 }
 
 
@@ -54,55 +63,62 @@ bool isLandingYawStable(int32_t yawDegrees) {
 }
 
 
-// Description: This function schedules the landing sequence. First it calls the function
-//              to ramp the yaw to the reference position It then checks the yaw has met
-//              the target before ramping down the height at a set rate
+// Description: This function schedules the landing sequence. First it sets the yaw target
+//              to the reference position. Once the yaw has met the target it sets the height
+//              target to zero. The controller's trajectory generator limits how fast the
+//              references follow, so the descent takes the minimum time within those limits.
 // Parameters:  state_t* state points to the struct containing the targets for yaw and height
 //              deltaTime is a 32-bit unsigned integer. It is the task period in ms
 //              int32_t yawDegrees is the measured yaw scaled by PRECISION
 void landingControllerUpdate(state_t *state, uint32_t deltaTime, int32_t yawDegrees)
 {
-    static uint32_t landingCounter = 0; // counter to determine rate of height ramp
     rampYaw(state, yawDegrees);
     if (isLandingYawStable(yawDegrees)) {
-        // LANDING_RATE specified in % per sec
-        // MS_TO_SEC / detlaTime converts period (in ms) to frequency in Hz
-        if (state->targetHeight != 0 && landingCounter >= MS_TO_SEC / (LANDING_RATE * deltaTime) ) {
-            state->targetHeight -= 1;
-            landingCounter = 0;
-        }
+        state->targetHeight = 0;
     }
-    landingCounter++;
 }
 
 
-// Description: This function checks that the helicopter remains stable while in its landing position
-//              (reference yaw and 0 height) for a set period of time. The function includes a time
-//              out in case the helicopter does not stabilize.
-// Parameters:  state_t* state points to the struct containing the target height and target yaw variables
+// Description: This function checks that the helicopter is stable in its landing position
+//              (reference yaw and 0 height). The mean and variance of the height and the yaw
+//              error are kept over the last STABILITY_WINDOW ms, and the heli is stable as soon
+//              as the means are within the allowed errors and the deviations are small. The
+//              function includes a time out in case the helicopter does not stabilize.
+// Parameters:  landing is the landing being checked
+//              state_t* state points to the struct containing the target height and target yaw variables
 //              deltaTime is the task period in ms and yawDegrees and heightPercentage pass in the measured
 //              quantities for yaw and height respectively scaled by PRECISION.
 // Return:      Returns a boolean indicating true when landing stability has been reached.
-bool landingControllerIsStable(state_t* state, uint32_t deltaTime, int32_t yawDegrees, int32_t heightPercentage)
+bool landingControllerIsStable(landing_controller_t* landing, state_t* state, uint32_t deltaTime, int32_t yawDegrees, int32_t heightPercentage)
 {
-    static uint32_t stabilityCounter;
-    static uint32_t landingTime = 0; // time out counter
-    // check that the height is less than 1% and that the target has been set to 0
+    // only measure once the target has been set to 0, before then the heli is still moving
+    if (state->targetHeight != 0) {
+        windowStatsClear(&landing->heightWindow);
+        windowStatsClear(&landing->yawWindow);
+        return false;
+    }
+
+    // yaw error from the nearest whole rotation, from -180 to 180 degrees
+    int32_t yawError = yawDegrees % (360 * PRECISION);
+    if (abs(yawError) > 180 * PRECISION) {
+        yawError -= SIGN(yawError) * 360 * PRECISION;
+    }
+
+    windowStatsAdd(&landing->heightWindow, heightPercentage, deltaTime);
+    windowStatsAdd(&landing->yawWindow, yawError, deltaTime);
+
+    // time out in case heli gets stuck in non-stable state whilst landing.
     // PRECISION accounts for precision scaling of input parameter heightPercentage
-    if (heightPercentage <= PRECISION && state->targetHeight == 0) {
-        if (isLandingYawStable(yawDegrees)) { // is the yaw at the target (within specified error)
-            stabilityCounter++;
-        } else {
-            stabilityCounter = 0; // if the heli moves out of stable range, reset the counter
-        }
-        landingTime++;
-        // time out in case heli gets stuck in non-stable state whilst landing.
-        if (landingTime >= LANDING_TIME_OUT / deltaTime) {
+    if (heightPercentage <= HEIGHT_STABILITY_ERROR * PRECISION) {
+        landing->landingTime += deltaTime;
+        if (landing->landingTime >= LANDING_TIME_OUT) {
             return true;
         }
-    } else {
-        stabilityCounter = 0;
     }
-    // check that the heli has remained in a stable state for a set period of time
-    return stabilityCounter >= STABILITY_TIME_MAIN / deltaTime;
+
+    return windowStatsIsFull(&landing->heightWindow) &&
+           windowStatsMean(&landing->heightWindow) <= HEIGHT_STABILITY_ERROR * PRECISION &&
+           windowStatsVariance(&landing->heightWindow) <= HEIGHT_STABILITY_VARIANCE &&
+           abs(windowStatsMean(&landing->yawWindow)) <= YAW_STABILITY_ERROR * PRECISION &&
+           windowStatsVariance(&landing->yawWindow) <= YAW_STABILITY_VARIANCE;
 }
@@ -16,25 +16,50 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "stateInfo.h"
+#include "windowStats.h"
 
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
 
-// Description: This function schedules the landing sequence. First it calls the function
-//              to ramp the yaw to the reference position It then checks the yaw has met
-//              the target before ramping down the height at a set rate
+
+// The state of one landing. Each controlled heli keeps its own.
+typedef struct {
+    window_stats_t heightWindow;  // height, scaled by PRECISION
+    window_stats_t yawWindow;  // yaw error from the nearest whole rotation, scaled by PRECISION
+    uint32_t landingTime;  // ms spent in the landing position, for the time out
+} landing_controller_t;
+
+
+// Description: Prepares for a new landing by clearing the stability measurements and time out.
+void landingControllerReset(landing_controller_t* landing);
+
+
+// Description: This function schedules the landing sequence. First it sets the yaw target
+//              to the reference position. Once the yaw has met the target it sets the height
+//              target to zero. The controller's trajectory generator limits how fast the
+//              references follow, so the descent takes the minimum time within those limits.
 // Parameters:  state_t* state points to the struct containing the targets for yaw and height
 //              deltaTime is a 32-bit unsigned integer. It is the task period in ms
 //              int32_t yawDegrees is the measured yaw scaled by PRECISION
 void landingControllerUpdate(state_t *state, uint32_t deltaTime, int32_t yawDegrees);
 
 
-// Description: This function checks that the helicopter remains stable while in its landing position
-//              (reference yaw and 0 height) for a set period of time. The function includes a time
-//              out in case the helicopter does not stabilize.
-// Parameters:  state_t* state points to the struct containing the target height and target yaw variables
+// Description: This function checks that the helicopter is stable in its landing position
+//              (reference yaw and 0 height). The mean and variance of the height and the yaw
+//              error are kept over the last STABILITY_WINDOW ms, and the heli is stable as soon
+//              as the means are within the allowed errors and the deviations are small. The
+//              function includes a time out in case the helicopter does not stabilize.
+// Parameters:  landing is the landing being checked
+//              state_t* state points to the struct containing the target height and target yaw variables
 //              deltaTime is the task period in ms and yawDegrees and heightPercentage pass in the measured
 //              quantities for yaw and height respectively scaled by PRECISION.
 // Return:      Returns a boolean indicating true when landing stability has been reached.
-bool landingControllerIsStable(state_t *state, uint32_t deltaTime, int32_t yawDegrees, int32_t heightPercentage);
+bool landingControllerIsStable(landing_controller_t* landing, state_t *state, uint32_t deltaTime, int32_t yawDegrees, int32_t heightPercentage);
+
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* LANDINGCONTROLLER_H_ */
@@ -0,0 +1,166 @@
+// ************************************************************
+// lineFormat.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Fast formatting of fixed layout lines for the displays.
+// Explaination: A format string is compiled once into a list of literal and
+// field segments, so that formatting a line does not need to parse the format
+// string again. Integers are converted to decimal using multiplication by a
+// reciprocal instead of division.
+// ************************************************************
+
+#include "lineFormat.h"
+
+#define MAX_DIGITS 10  // in a 32 bit unsigned integer
+#define LITERAL 0
+
+// n / 10 for any 32 bit n. 0xCCCCCCCD is 2^35 / 10 rounded up, which is exact over this range.
+#define DIVIDE_BY_10(n) ((uint32_t)(((uint64_t)(n) * 0xCCCCCCCDu) >> 35))
+
+
+// Store one character if there is room, and count it either way. c is only evaluated
+// when stored, so it must not have side effects.
+#define PUT_CHAR(c) do { if (length + 1 < size) str[length] = (c); length++; } while (0)
+
+
+// Compile a printf style format string. Returns false, and leaves isCompiled
+// false, if the format uses anything unsupported or has too many segments.
+bool lineFormatCompile(line_format_t* compiled, const char* format)
+{
+    uint32_t i = 0;
+
+    compiled->format = format;
+    compiled->isCompiled = false;
+    compiled->numSegments = 0;
+
+    while (format[i]) {
+        if (compiled->numSegments >= LINE_FORMAT_MAX_SEGMENTS) {
+            return false;
+        }
+        line_segment_t* segment = &compiled->segments[compiled->numSegments++];
+
+        if (format[i] != '%') {
+            // a run of literal characters
+            segment->type = LITERAL;
+            segment->offset = i;
+            while (format[i] && format[i] != '%') {
+                i++;
+            }
+            segment->width = i - segment->offset;
+            continue;
+        }
+
+        i++;  // skip the %
+        segment->fill = ' ';
+        segment->width = 0;
+        if (format[i] == '0') {
+            segment->fill = '0';
+            i++;
+        }
+        while (format[i] >= '0' && format[i] <= '9') {
+            segment->width = segment->width * 10 + format[i] - '0';
+            i++;
+        }
+
+        switch (format[i]) {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'c':
+        case 's':
+            segment->type = format[i];
+            break;
+        case '%':
+            // a literal % from the format string
+            segment->type = LITERAL;
+            segment->offset = i;
+            segment->width = 1;
+            break;
+        default:
+            return false;
+        }
+        i++;
+    }
+    compiled->isCompiled = true;
+    return true;
+}
+
+
+// Format the arguments into str using a compiled format, as per uvsnprintf.
+// At most size - 1 characters are stored followed by \0. Returns the length the
+// full output would have had.
+int lineFormatApply(const line_format_t* compiled, char* str, uint32_t size, va_list args)
+{
+    char digits[MAX_DIGITS];
+    uint32_t length = 0;
+    uint32_t i, n;
+    int count;
+
+    for (i = 0; i < compiled->numSegments; i++) {
+        const line_segment_t* segment = &compiled->segments[i];
+
+        switch (segment->type) {
+        case LITERAL:
+            for (n = 0; n < segment->width; n++) {
+                PUT_CHAR(compiled->format[segment->offset + n]);
+            }
+            break;
+
+        case 'c':
+            n = va_arg(args, int);
+            PUT_CHAR((char)n);
+            break;
+
+        case 's': {
+            const char* s = va_arg(args, const char*);
+            for (count = 0; s[count]; count++) {
+                PUT_CHAR(s[count]);
+            }
+            for (; count < segment->width; count++) {
+                PUT_CHAR(' ');
+            }
+            break;
+        }
+
+        case 'd':
+        case 'i':
+        case 'u': {
+            int32_t value = va_arg(args, int32_t);
+            bool isNegative = segment->type != 'u' && value < 0;
+            uint32_t magnitude = isNegative ? -(uint32_t)value : (uint32_t)value;
+
+            // digits are produced least significant first
+            int numDigits = 0;
+            do {
+                uint32_t quotient = DIVIDE_BY_10(magnitude);
+                digits[numDigits++] = '0' + (magnitude - quotient * 10);
+                magnitude = quotient;
+            } while (magnitude);
+
+            // the sign is part of the width. It goes before zero padding and after space padding.
+            int padding = segment->width - numDigits - isNegative;
+            if (isNegative && segment->fill == '0') {
+                PUT_CHAR('-');
+            }
+            for (; padding > 0; padding--) {
+                PUT_CHAR(segment->fill);
+            }
+            if (isNegative && segment->fill == ' ') {
+                PUT_CHAR('-');
+            }
+            while (numDigits) {
+                numDigits--;
+                PUT_CHAR(digits[numDigits]);
+            }
+            break;
+        }
+        }
+    }
+
+    if (size) {
+        str[length < size ? length : size - 1] = '\0';
+    }
+    return length;
+}
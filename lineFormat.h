@@ -0,0 +1,62 @@
+// ************************************************************
+// lineFormat.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Fast formatting of fixed layout lines for the displays.
+// Explaination: A format string is compiled once into a list of literal and
+// field segments, so that formatting a line does not need to parse the format
+// string again. Supports %d, %i, %u, %c, %s and %% with an optional 0 flag and
+// width, and gives the same output as uvsnprintf for these. Integers are
+// converted to decimal using multiplication by a reciprocal instead of division.
+// ************************************************************
+
+#ifndef LINE_FORMAT_H_
+#define LINE_FORMAT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define LINE_FORMAT_MAX_SEGMENTS 12
+
+
+// A piece of a compiled format. Literals refer to a span of the format string.
+typedef struct {
+    char type;  // the conversion character, or 0 for a literal
+    char fill;  // ' ' or '0'
+    uint8_t width;  // minimum field width, or the literal length
+    uint8_t offset;  // start of the literal in the format string
+} line_segment_t;
+
+
+// A compiled format. The format string must outlive it.
+typedef struct {
+    const char* format;
+    bool isCompiled;  // false if lineFormatCompile(..) failed, then format with uvsnprintf instead
+    uint32_t numSegments;
+    line_segment_t segments[LINE_FORMAT_MAX_SEGMENTS];
+} line_format_t;
+
+
+// Compile a printf style format string. Returns false, and leaves isCompiled
+// false, if the format uses anything unsupported or has too many segments.
+bool lineFormatCompile(line_format_t* compiled, const char* format);
+
+
+// Format the arguments into str using a compiled format, as per uvsnprintf.
+// At most size - 1 characters are stored followed by \0. Returns the length the
+// full output would have had.
+int lineFormatApply(const line_format_t* compiled, char* str, uint32_t size, va_list args);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINE_FORMAT_H_ */
@@ -14,13 +14,8 @@
 #include <stdbool.h>
 #include <string.h>
 
-// TivaWare library includes
-#include "inc/hw_memmap.h"        // defines GPIO_PORTF_BASE
-#include "inc/tm4c123gh6pm.h"     // defines interrupt vectors and register addresses
-#include "driverlib/gpio.h"       // defines for GPIO peripheral
-#include "driverlib/sysctl.h"     // system control functions
-#include "driverlib/systick.h"
-#include "driverlib/interrupt.h"
+// Hardware, TivaWare on the board, see hal.h
+#include "hal.h"
 
 // 3rd party libraries
 #include "buttons4.h"             // left, right, up, down buttons (debouncing)
@@ -37,52 +32,53 @@
 #include "kernel.h"
 #include "quadratureEncoder.h"
 #include "landingController.h"
+#include "flightMode.h"
+#include "telemetry.h"
+#include "recorder.h"
+#include "benchmark.h"
+#include "probe.h"
+#include "trace.h"
+#include "report.h"
+#include "command.h"
+#include "stepResponse.h"
+#include "outputScheduler.h"
 
 #define TASK_BASE_FREQ 100  // Hz, the maximum frequency of a task
-#define UART_DISPLAY_FREQUENCY 4  // Hz
-#define UPDATE_DISPLAY_COUNT (TASK_BASE_FREQ / UART_DISPLAY_FREQUENCY)
+
+#define DISPLAY_FLUSH_CHARS 4  // OLED characters drawn per TASK_BASE_FREQ tick
+#define UART_STATUS_LINES 5  // lines in uartStatusBlock
+#define UART_DIAGNOSTICS_LINES 6  // lines in uartDiagnosticsBlock
 
 #define MAIN_STEP 10  // %
 #define TAIL_STEP 15  // deg
 
 
-void softResetIntHandler(void)
+// Called from the button interrupt when SW2 (PA6) is pushed
+void softResetHandler(void)
 {
-    GPIOIntClear(GPIO_PORTA_BASE, GPIO_PIN_6);
-    SysCtlReset();
+    halSystemReset();
 }
 
 
+// SW2 shares port A with SW1, and a port has a single interrupt handler, so the
+// buttons module handles the interrupt and calls back on a push.
 void initSoftReset(void)
 {
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
-
-    GPIOPadConfigSet(GPIO_PORTA_BASE, GPIO_PIN_6, GPIO_STRENGTH_4MA, GPIO_PIN_TYPE_STD_WPU);
-    GPIODirModeSet(GPIO_PORTA_BASE, GPIO_PIN_6, GPIO_DIR_MODE_IN);
-
-    GPIOIntRegister(GPIO_PORTA_BASE, softResetIntHandler);
-    GPIOIntTypeSet(GPIO_PORTA_BASE, GPIO_PIN_6, GPIO_FALLING_EDGE);
-    GPIOIntEnable(GPIO_PORTA_BASE, GPIO_PIN_6);
+    buttonsSetPushHandler(SW2, softResetHandler);
 }
 
 
 void initalise()
 {
-    // Reset ports for good measure
-    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOA);
-    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOB);
-    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOC);
-    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOD);
-    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOE);
-    SysCtlPeripheralReset(SYSCTL_PERIPH_GPIOF);
-
+    // Reset ports for good measure and set system clock rate to 20 MHz.
     // Other peripherals are reset inside each module
-
-    // Set system clock rate to 20 MHz.
-    SysCtlClockSet(SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ | SYSCTL_SYSDIV_10);
+    halSystemInit();
     timererInit();
+    recorderInit();  // from reset, when built to record for tools/replay
     timererWait(1);  // Allow time for the oscillator to settle down (for 1 millisecond).
 
+    probeInit();
+    traceInit();
     buttonsInit();
     initSoftReset();
     displayInit();
@@ -91,101 +87,75 @@ void initalise()
     uartInit();
 
     // Enable interrupts to the processor.
-    IntMasterEnable ();
+    halInterruptsEnable ();
     timererWait(1);
     heightCalibrate();
     controlInit();
+    flightModeInit();
 }
 
 
-void stateTransitionUpdate(state_t* state, uint32_t deltaTime)
+// Change the targets in response to a push (or auto-repeat) of a button while flying.
+void changeTargetWithButton(state_t* state, uint8_t button)
 {
-    static bool shouldCalibrate = true;  // only calibrate the yaw once
-
-    switch (state->heliMode) {
-    case STATE_LANDED:
-        heightCalibrate();  // always re-calibrate the height
-
-        // wait for switch to trigger take off
-        if (buttonsCheck(SW1) == PUSHED) {
-            // start calibration and enable PID control on height and yaw
-            controlEnable(state, CONTROL_HEIGHT);
-            controlEnable(state, CONTROL_YAW);
-            state->targetHeight = 0;
-
-            // set integral controllers back to zero to prevent windup
-            controlReset();
-
-            if (shouldCalibrate) {
-                controlEnable(state, CONTROL_CALIBRATE_YAW);
-                state->heliMode = STATE_CALIBRATE_YAW;
-            } else {
-                state->heliMode = STATE_FLYING;
-            }
-        }
+    switch (button) {
+    // change height with buttons
+    case UP:
+        if (state->targetHeight < CONTROL_MAX_DUTY)
+            state->targetHeight += MAIN_STEP;
+        break;
+    case DOWN:
+        if (state->targetHeight > CONTROL_MIN_DUTY)
+            state->targetHeight -= MAIN_STEP;
         break;
 
-    case STATE_CALIBRATE_YAW:
-        // seek the zero point for the yaw
-
-        if (!controlIsEnabled(CONTROL_CALIBRATE_YAW)) {
-            // when the zero point is found, move to the flying mode
-            shouldCalibrate = false;
-            state->targetYaw = 0;
-            state->heliMode = STATE_FLYING;
-        }
+    // change yaw with buttons
+    case LEFT:
+        state->targetYaw -= TAIL_STEP;
         break;
+    case RIGHT:
+        state->targetYaw += TAIL_STEP;
+        break;
+    }
+}
 
-    case STATE_FLYING:
-        // change height with buttons
-        if (buttonsCheck(UP) == PUSHED && state->targetHeight < CONTROL_MAX_DUTY)
-            state->targetHeight += MAIN_STEP;
-        if (buttonsCheck(DOWN) == PUSHED && state->targetHeight > CONTROL_MIN_DUTY)
-            state->targetHeight -= MAIN_STEP;
 
-        // change yaw with buttons
-        if (buttonsCheck(LEFT) == PUSHED)
-            state->targetYaw -= TAIL_STEP;
-        if (buttonsCheck(RIGHT) == PUSHED)
-            state->targetYaw += TAIL_STEP;
+// Turn button presses and UART commands into targets and flight mode events. The
+// mode changes themselves are made by the flightMode module.
+void stateTransitionUpdate(state_t* state, uint32_t deltaTime)
+{
+    button_event_t event;
 
-        // switch one to go into the landing sequence
-        if (buttonsCheck(SW1) == RELEASED) {  // switch down
-            controlEnable(state, CONTROL_DESCENDING);
-            state->heliMode = STATE_DESCENDING;
-        }
+    // mode changes can also be requested over UART
+    switch (commandTakeModeRequest()) {
+    case COMMAND_MODE_FLY:
+        flightModePost(FLIGHT_EV_TAKE_OFF);
         break;
-
-    case STATE_DESCENDING:
-        if (!controlIsEnabled(CONTROL_DESCENDING)) {
-            // when the descending controller auto-disables, move to the power down sequence
-            // and disable PID control on the height
-            controlDisable(state, CONTROL_HEIGHT);
-            controlEnable(state, CONTROL_POWER_DOWN);
-
-            // prevent a toggle of the switch causing the heli to take off again once landed
-            buttonsIgnore(SW1);
-            state->heliMode = STATE_POWER_DOWN;
-        }
+    case COMMAND_MODE_LAND:
+        flightModePost(FLIGHT_EV_LAND);
         break;
+    default:
+        break;
+    }
 
-    case STATE_POWER_DOWN:
-        if (!controlIsEnabled(CONTROL_POWER_DOWN)) {
-            // when the power down controller auto-disables, move to the landed sequence
-            controlDisable(state, CONTROL_YAW);
-            state->targetHeight = 0;
-            state->targetYaw = 0;
-
-            // round the yaw measurement so that we always return to 0 degrees by the shortest
-            // path. i.e. don't unwind if we have spun multiple times.
-            yawClipTo360Degrees();
-
-            // prevent a toggle of the switch causing the heli to take off again once landed
-            buttonsIgnore(SW1);
-            state->heliMode = STATE_LANDED;
+    // act on every push and auto-repeat, even when several happen between updates.
+    // Events in the other modes are discarded so they don't take effect later.
+    buttonsUpdate();
+    while (buttonsGetEvent(&event)) {
+        if (event.button == SW1) {
+            // switch up to take off, down to land
+            if (event.type == BUT_EV_PUSHED) {
+                flightModePost(FLIGHT_EV_TAKE_OFF);
+            } else if (event.type == BUT_EV_RELEASED) {
+                flightModePost(FLIGHT_EV_LAND);
+            }
+        } else if (state->heliMode == STATE_FLYING &&
+                (event.type == BUT_EV_PUSHED || event.type == BUT_EV_REPEATED)) {
+            changeTargetWithButton(state, event.button);
         }
-        break;
     }
+
+    flightModeUpdate(state);
 }
 
 
@@ -194,84 +164,223 @@ void stateTransitionUpdate(state_t* state, uint32_t deltaTime)
 //
 
 
-void displayUpdate(state_t* state, uint32_t deltaTime)
+// The fixed layouts of the display lines
+enum display_format_e {
+    FORMAT_OLED_HEIGHT = 0,
+    FORMAT_OLED_DUTY,
+    FORMAT_UART_HEIGHT,
+    FORMAT_UART_YAW,
+    FORMAT_UART_DUTY,
+    FORMAT_UART_MODE,
+    FORMAT_UART_LOAD,
+    FORMAT_UART_SHED,
+    FORMAT_UART_BUDGET,
+    FORMAT_UART_HEIGHT_LATENCY,
+    FORMAT_UART_YAW_LATENCY,
+    FORMAT_UART_SEPARATOR,
+    NUM_DISPLAY_FORMATS
+};
+
+static line_format_t formats[NUM_DISPLAY_FORMATS];
+static const char* formatStrings[NUM_DISPLAY_FORMATS] = {
+    "Height = %4d%%",
+    "M = %2d, T = %2d",
+    "\nALT %d [%d] %%\n",
+    "YAW %d [%d] deg\n",
+    "MAIN %d %%, TAIL %d %%\n",
+    "MODE %s\n",
+    "CPU %d%% [%d%%] S%d\n",
+    "SHED M%d R%d\n",  // deadline misses, shed task runs
+    "OUT %d [%d] D%d\n",  // UART chars sent on the last tick [most on one tick], deferred blocks
+    "LH %d [%d] %d\n",  // us
+    "LY %d [%d] %d\n",  // us
+    "----------------\n"
+};
+
+// Remember to update these strings when changing the states above
+// These are the string values to be displayed when in each state
+static const char* heliModeDisplayStringMap[] = {
+   "Landed",
+   "Calibrate Yaw",
+   "Flying",
+   "Descending",
+   "Power Down"
+};
+
+
+//
+// Display lines to be run by the output scheduler
+//
+
+
+void oledHeightLine(state_t* state)
 {
-    static int uartCount = 0;
-    // Remember to update these strings when changing the states above
-    // These are the string values to be displayed when in each state
-    static const char* heliModeDisplayStringMap[] = {
-       "Landed",
-       "Calibrate Yaw",
-       "Flying",
-       "Descending",
-       "Power Down"
-    };
+    displayPrintLineWithCompiled(&formats[FORMAT_OLED_HEIGHT], 1, heightAsPercentage(1));
+}
 
-    // Take measurements
-    uint32_t percentageHeight = heightAsPercentage(1);  // precision = 1
-    uint32_t degreesYaw = yawGetDegrees(1);  // precision = 1
 
-    // Use a collaborative technique to update the displays across update cycles.
-    // Thus, the time spent on each call to displayUpdate is reduced allowing higher frequency tasks
-    // to be serviced at more consistent rates.
+void oledDutyLine(state_t* state)
+{
+    displayPrintLineWithCompiled(&formats[FORMAT_OLED_DUTY], 2, state->outputMainDuty, state->outputTailDuty);
+}
 
-    switch (uartCount) {
 
-    // Update OLED display
-    case UPDATE_DISPLAY_COUNT - 7:
-        displayPrintLineWithFormat("Height = %4d%%", 1, percentageHeight);  // line 1
-        break;
-    case UPDATE_DISPLAY_COUNT - 6:
-        displayPrintLineWithFormat("M = %2d, T = %2d", 2, state->outputMainDuty, state->outputTailDuty);  // line 2
-        break;
+// The status lines read by the web interface. Sent as one block so that the lines
+// always arrive together and in this order, ending with the separator.
+void uartStatusBlock(state_t* state)
+{
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_HEIGHT], state->targetHeight, heightAsPercentage(1));
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_YAW], state->targetYaw, yawGetDegrees(1));
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_DUTY], state->outputMainDuty, state->outputTailDuty);
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_MODE], heliModeDisplayStringMap[state->heliMode]);
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_SEPARATOR]);
+}
 
-    // Update UART display
-    case UPDATE_DISPLAY_COUNT - 5:
-        uartPrintLineWithFormat("\nALT %d [%d] %%\n", state->targetHeight, percentageHeight);
-        break;
-    case UPDATE_DISPLAY_COUNT - 4:
-        uartPrintLineWithFormat("YAW %d [%d] deg\n", state->targetYaw, degreesYaw);
-        break;
-    case UPDATE_DISPLAY_COUNT - 3:
-        uartPrintLineWithFormat("MAIN %d %%, TAIL %d %%\n", state->outputMainDuty, state->outputTailDuty);
-        break;
-    case UPDATE_DISPLAY_COUNT - 2:
-        uartPrintLineWithFormat("MODE %s\n", heliModeDisplayStringMap[state->heliMode]);
-        break;
-    case UPDATE_DISPLAY_COUNT - 1:
-        uartPrintLineWithFormat("%s", "----------------\n");
-        break;
-    case UPDATE_DISPLAY_COUNT:
-        uartCount = 0;
+
+// Timing diagnostics, as a block of their own between status blocks:
+// processor load in the current mode, average [peak], and the load shedding level;
+// overrun frames and shed task runs since power on;
+// UART budget use; sensor to rotor latency of the height and yaw since the motors
+// were turned on, min [mean] max in us.
+void uartDiagnosticsBlock(state_t* state)
+{
+    kernel_load_t load;
+    kernel_shed_stats_t shed;
+    output_stats_t output;
+    control_latency_t heightLatency, yawLatency;
+
+    kernelGetLoad(state->heliMode, &load);
+    kernelGetShedStats(&shed);
+    outputGetStats(OUTPUT_UART, &output);
+    controlGetLatency(CONTROL_DUTY_MAIN, &heightLatency);
+    controlGetLatency(CONTROL_DUTY_TAIL, &yawLatency);
+
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_LOAD],
+                              load.averageLoad * 100 / KERNEL_LOAD_SCALE,
+                              load.peakLoad * 100 / KERNEL_LOAD_SCALE, shed.level);
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_SHED], shed.deadlineMisses, shed.shedRuns);
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_BUDGET], output.lastUsed, output.maxUsed, output.deferred);
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_HEIGHT_LATENCY], heightLatency.min, heightLatency.mean, heightLatency.max);
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_YAW_LATENCY], yawLatency.min, yawLatency.mean, yawLatency.max);
+    uartPrintLineWithCompiled(&formats[FORMAT_UART_SEPARATOR]);
+}
+
+
+// Parse the display layouts and register the lines with the output scheduler.
+// Priorities and periods decide which lines are freshest when the budget is tight.
+// A layout lineFormat can't compile still works, formatted by uvsnprintf, but is
+// reported so that it gets fixed.
+void initDisplayLines(void)
+{
+    int i;
+    for (i = 0; i < NUM_DISPLAY_FORMATS; i++) {
+        if (!lineFormatCompile(&formats[i], formatStrings[i])) {
+            uartPrintLineWithFormat("FORMAT %d NOT COMPILED\n", i);
+        }
     }
-    uartCount++;
+
+    outputSetRate(OUTPUT_UART, UART_CHARS_PER_SECOND);
+    outputSetDevice(OUTPUT_UART, uartTxSpace, uartTxQueued);  // shared with the reports and dumps
+    outputSetRate(OUTPUT_OLED, DISPLAY_FLUSH_CHARS * TASK_BASE_FREQ);
+
+    // handler, output, priority, period (ms), max chars
+    outputRegister(oledHeightLine, OUTPUT_OLED, 2, 100, DISPLAY_CHAR_WIDTH);
+    outputRegister(oledDutyLine, OUTPUT_OLED, 1, 250, DISPLAY_CHAR_WIDTH);
+    outputRegister(uartStatusBlock, OUTPUT_UART, 1, 250, UART_STATUS_LINES * (UART_LINE_LENGTH + 1));
+    outputRegister(uartDiagnosticsBlock, OUTPUT_UART, 0, 1000, UART_DIAGNOSTICS_LINES * (UART_LINE_LENGTH + 1));
+}
+
+
+void displayUpdate(state_t* state, uint32_t deltaTime)
+{
+    // the UART only carries text when binary telemetry is off and no trace is being dumped
+    outputSetEnabled(OUTPUT_UART, telemetryIsTextAllowed());
+
+    // format the lines which are due and fit in this tick's budget
+    outputUpdate(state, deltaTime);
+
+    // draw a few changed characters each call rather than whole lines at once. Shed
+    // runs are not made up for, as that would only make the runs which do happen longer.
+    displayFlush(DISPLAY_FLUSH_CHARS * kernelGetTaskPeriod() * TASK_BASE_FREQ / 1000);
 }
 
 
 void mainUpdate(state_t* state, uint32_t deltaTime)
 {
+    commandApply(state);  // changes received over UART take effect together
     heightUpdate();  // recalculate height average
     controlUpdate(state, deltaTime);
-    buttonsUpdate();
+
+    // start the next mode in this tick when a control channel has just finished
+    flightModeDispatch(state);
 }
 
 
 int main(void)
 {
     initalise();
+    initDisplayLines();
 
     // make sure ADC buffer has a chance to fill up for the height measurement
     timererWait(1000 * CONV_SIZE / ADC_SAMPLE_RATE);
 
-    // the tasks which need to run at what frequency
+    // the tasks which need to run at what frequency in each mode
     // the frequency cannot be larger than the TASK_BASE_FREQ
-    task_t tasks[] = {
-        {mainUpdate, 100},
-        {displayUpdate, 100},  // actually about 4 Hz due to co-operative behaviour
-        {stateTransitionUpdate, 10},  // assuming responce of 200 ms, then 2 * 5 Hz = 10 from Nyquist
+    // displays and telemetry are sheddable: they run less often when frames overrun
+
+    // landed: only watch for take off and keep the height reference up to date
+    task_t landedTasks[] = {
+        {mainUpdate, 20, false, PROBE_TASK_MAIN},  // motors are off, but heightCalibrate needs the averaged height
+        {displayUpdate, 50, true, PROBE_TASK_DISPLAY},
+        {telemetryUpdate, 20, true, PROBE_TASK_TELEMETRY},
+        {stateTransitionUpdate, 100, false, PROBE_TASK_STATE_TRANSITION},  // take off as soon as the switch moves
+        {recorderUpdate, 20, false, PROBE_TASK_RECORDER},  // never shed, the sample queue only covers 100 ms
+        {commandUpdate, 20, false, PROBE_TASK_COMMAND},
+        {benchmarkUpdate, 20},  // only when asked for, the motors are off
+        {probeDumpUpdate, 20, true},
+        {traceDumpUpdate, 20, true},
+        {reportUpdate, 20, true},
         {0}  // terminator (read until this value when processing the array)
     };
 
+    // calibrating, descending and powering down: under control but not taking input
+    task_t transitionTasks[] = {
+        {mainUpdate, 100, false, PROBE_TASK_MAIN},
+        {displayUpdate, 50, true, PROBE_TASK_DISPLAY},
+        {telemetryUpdate, 100, true, PROBE_TASK_TELEMETRY},
+        {stateTransitionUpdate, 100, false, PROBE_TASK_STATE_TRANSITION},
+        {recorderUpdate, 20, false, PROBE_TASK_RECORDER},
+        {commandUpdate, 20, false, PROBE_TASK_COMMAND},
+        {probeDumpUpdate, 20, true},
+        {traceDumpUpdate, 20, true},
+        {reportUpdate, 20, true},
+        {0}
+    };
+
+    // flying: full rate control, displays and step response measurement
+    task_t flyingTasks[] = {
+        {mainUpdate, 100, false, PROBE_TASK_MAIN},
+        {displayUpdate, 100, true, PROBE_TASK_DISPLAY},  // lines are produced at their own rates within a budget
+        {telemetryUpdate, 100, true, PROBE_TASK_TELEMETRY},  // binary telemetry at the control rate, when enabled
+        {stateTransitionUpdate, 100, false, PROBE_TASK_STATE_TRANSITION},  // buttons are interrupt driven, so this is cheap enough to run every tick
+        {stepResponseUpdate, 100, true, PROBE_TASK_STEP_RESPONSE},
+        {recorderUpdate, 20, false, PROBE_TASK_RECORDER},
+        {commandUpdate, 20, false, PROBE_TASK_COMMAND},  // low priority, 64 byte receive queue covers 50 ms at 9600 baud
+        {probeDumpUpdate, 20, true},
+        {traceDumpUpdate, 20, true},
+        {reportUpdate, 20, true},
+        {0}
+    };
+
+    // in heli_state_t order
+    task_t* modeTasks[NUM_HELI_STATES] = {
+        landedTasks,  // STATE_LANDED
+        transitionTasks,  // STATE_CALIBRATE_YAW
+        flyingTasks,  // STATE_FLYING
+        transitionTasks,  // STATE_DESCENDING
+        transitionTasks  // STATE_POWER_DOWN
+    };
+
     // any data which many tasks might need to know about
     state_t sharedState = {
         .heliMode = STATE_LANDED,
@@ -281,5 +390,5 @@ int main(void)
         .outputTailDuty = 0
     };
 
-    runTasks(tasks, &sharedState, TASK_BASE_FREQ);
+    runModeTasks(modeTasks, &sharedState, TASK_BASE_FREQ);
 }
@@ -0,0 +1,179 @@
+// ************************************************************
+// outputScheduler.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Decide which display and UART lines are produced on each tick.
+// Explaination: Producers register a handler which prints one line, with the
+// output it goes to, a priority, a refresh period and the number of characters
+// it sends. Each output earns a budget of characters per second. On each tick the
+// due lines are run in priority order while they fit in the budget and in the
+// room the output has left, and lines which do not fit wait for a later tick.
+// The characters actually sent on each tick are recorded.
+// ************************************************************
+
+#include "outputScheduler.h"
+
+#define MS_TO_SEC 1000
+#define OUTPUT_MAX_CREDIT_TICKS 4  // unused budget is kept for this many ticks' worth of lines
+
+typedef struct {
+    output_handler_t handler;
+    output_sink_t sink;
+    uint32_t priority;
+    uint32_t period;
+    uint32_t cost;
+    uint32_t sinceLastRun;  // ms
+} output_entry_t;
+
+// Budget of one output, in characters scaled by MS_TO_SEC so that fractions of a
+// character earned per tick are not lost
+typedef struct {
+    bool isDisabled;
+    uint32_t rate;  // characters per second
+    uint32_t credit;
+    uint32_t maxCredit;  // enough for the largest line, so every line can run eventually
+    output_space_t space;  // 0 if the output is always assumed to have room
+    output_counter_t sent;  // 0 to charge lines their cost
+} output_budget_t;
+
+static output_entry_t entries[OUTPUT_MAX_ENTRIES];
+static uint32_t numEntries = 0;
+static output_budget_t budgets[OUTPUT_NUM_SINKS];
+static output_stats_t stats[OUTPUT_NUM_SINKS];
+
+
+// Register a line to be produced. priority: higher values are run first.
+// period: ms between runs. cost: the most characters the handler sends.
+// Returns false if there is no room for another entry.
+bool outputRegister(output_handler_t handler, output_sink_t sink, uint32_t priority,
+                    uint32_t period, uint32_t cost)
+{
+    if (numEntries >= OUTPUT_MAX_ENTRIES) {
+        return false;
+    }
+
+    output_entry_t* entry = &entries[numEntries++];
+    entry->handler = handler;
+    entry->sink = sink;
+    entry->priority = priority;
+    entry->period = period;
+    entry->cost = cost;
+    entry->sinceLastRun = period;  // due straight away
+
+    if (cost * MS_TO_SEC * OUTPUT_MAX_CREDIT_TICKS > budgets[sink].maxCredit) {
+        budgets[sink].maxCredit = cost * MS_TO_SEC * OUTPUT_MAX_CREDIT_TICKS;
+    }
+    return true;
+}
+
+
+// Set the rate at which an output earns budget in characters per second.
+void outputSetRate(output_sink_t sink, uint32_t charsPerSecond)
+{
+    budgets[sink].rate = charsPerSecond;
+}
+
+
+// Tell the scheduler how to measure an output, which it shares with other writers.
+// space: a line is only run when its cost fits in the room left. sent: the budget
+// and stats are charged the characters actually sent rather than the cost.
+void outputSetDevice(output_sink_t sink, output_space_t space, output_counter_t sent)
+{
+    budgets[sink].space = space;
+    budgets[sink].sent = sent;
+}
+
+
+// Turn an output on or off. Lines for an output which is off are not run and
+// the output earns no budget. Outputs are on by default.
+void outputSetEnabled(output_sink_t sink, bool isEnabled)
+{
+    budgets[sink].isDisabled = !isEnabled;
+    if (!isEnabled) {
+        budgets[sink].credit = 0;
+    }
+}
+
+
+// Copy the budget use of an output into stats.
+void outputGetStats(output_sink_t sink, output_stats_t* statsOut)
+{
+    *statsOut = stats[sink];
+}
+
+
+// Task to run the due lines which fit in the budget of each output.
+void outputUpdate(state_t* state, uint32_t deltaTime)
+{
+    uint32_t used[OUTPUT_NUM_SINKS] = {0};
+    bool hasRun[OUTPUT_MAX_ENTRIES] = {0};
+    uint32_t i;
+    int sink;
+
+    // earn budget
+    for (sink = 0; sink < OUTPUT_NUM_SINKS; sink++) {
+        output_budget_t* budget = &budgets[sink];
+        if (!budget->isDisabled) {
+            budget->credit += budget->rate * deltaTime;
+            if (budget->credit > budget->maxCredit) {
+                budget->credit = budget->maxCredit;
+            }
+        }
+    }
+
+    for (i = 0; i < numEntries; i++) {
+        entries[i].sinceLastRun += deltaTime;
+    }
+
+    // repeatedly run the due line with the highest priority (the most overdue on a tie)
+    // until none are due or the rest don't fit
+    while (true) {
+        output_entry_t* best = 0;
+        uint32_t bestIndex = 0;
+
+        for (i = 0; i < numEntries; i++) {
+            output_entry_t* entry = &entries[i];
+            if (hasRun[i] || entry->sinceLastRun < entry->period || budgets[entry->sink].isDisabled) {
+                continue;
+            }
+            if (!best || entry->priority > best->priority ||
+                    (entry->priority == best->priority && entry->sinceLastRun > best->sinceLastRun)) {
+                best = entry;
+                bestIndex = i;
+            }
+        }
+
+        if (!best) {
+            break;
+        }
+        hasRun[bestIndex] = true;  // considered once per tick either way
+
+        // other writers share the output, so a line which fits the budget may still
+        // not fit in the room they have left
+        output_budget_t* budget = &budgets[best->sink];
+        if (best->cost * MS_TO_SEC > budget->credit || (budget->space && budget->space() < best->cost)) {
+            stats[best->sink].deferred++;  // stays due for the next tick
+            continue;
+        }
+
+        uint32_t sentBefore = budget->sent ? budget->sent() : 0;
+        best->handler(state);
+        best->sinceLastRun = 0;
+
+        uint32_t sent = budget->sent ? budget->sent() - sentBefore : best->cost;
+        budget->credit -= sent * MS_TO_SEC < budget->credit ? sent * MS_TO_SEC : budget->credit;
+        used[best->sink] += sent;
+    }
+
+    for (sink = 0; sink < OUTPUT_NUM_SINKS; sink++) {
+        output_stats_t* s = &stats[sink];
+        s->ticks++;
+        s->lastUsed = used[sink];
+        s->totalUsed += used[sink];
+        if (used[sink] > s->maxUsed) {
+            s->maxUsed = used[sink];
+        }
+    }
+}
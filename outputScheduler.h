@@ -0,0 +1,90 @@
+// ************************************************************
+// outputScheduler.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Decide which display and UART lines are produced on each tick.
+// Explaination: Producers register a handler which prints one line, with the
+// output it goes to, a priority, a refresh period and the number of characters
+// it sends. Each output earns a budget of characters per second. On each tick the
+// due lines are run in priority order while they fit in the budget and in the
+// room the output has left, and lines which do not fit wait for a later tick.
+// The characters actually sent on each tick are recorded.
+// ************************************************************
+
+#ifndef OUTPUT_SCHEDULER_H_
+#define OUTPUT_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stateInfo.h"
+
+#define OUTPUT_MAX_ENTRIES 12
+
+
+// Where a line is sent. Each output has its own budget.
+typedef enum {
+    OUTPUT_UART = 0,
+    OUTPUT_OLED,
+
+    // Always equal to the number of outputs above
+    OUTPUT_NUM_SINKS
+} output_sink_t;
+
+
+// Prints one line to its output
+typedef void (*output_handler_t)(state_t* state);
+
+
+// Returns the characters an output has room for now
+typedef uint32_t (*output_space_t)(void);
+
+
+// Returns the running total of characters an output has accepted
+typedef uint32_t (*output_counter_t)(void);
+
+
+// Budget use of one output.
+typedef struct {
+    uint32_t ticks;  // number of updates
+    uint32_t lastUsed;  // characters sent on the last update
+    uint32_t maxUsed;  // most characters sent on one update
+    uint32_t totalUsed;  // characters sent over all updates
+    uint32_t deferred;  // times a due line was held back for lack of budget or room
+} output_stats_t;
+
+
+// Register a line to be produced. priority: higher values are run first.
+// period: ms between runs. cost: the most characters the handler sends.
+// Returns false if there is no room for another entry.
+bool outputRegister(output_handler_t handler, output_sink_t sink, uint32_t priority,
+                    uint32_t period, uint32_t cost);
+
+
+// Set the rate at which an output earns budget in characters per second.
+void outputSetRate(output_sink_t sink, uint32_t charsPerSecond);
+
+
+// Tell the scheduler how to measure an output, which it shares with other writers.
+// space: a line is only run when its cost fits in the room left. sent: the budget
+// and stats are charged the characters actually sent rather than the cost. Either
+// may be 0, then lines are only limited by the budget and charged their cost.
+void outputSetDevice(output_sink_t sink, output_space_t space, output_counter_t sent);
+
+
+// Turn an output on or off. Lines for an output which is off are not run and
+// the output earns no budget. Outputs are on by default.
+void outputSetEnabled(output_sink_t sink, bool isEnabled);
+
+
+// Copy the budget use of an output into stats.
+void outputGetStats(output_sink_t sink, output_stats_t* stats);
+
+
+// Task to run the due lines which fit in the budget of each output.
+void outputUpdate(state_t* state, uint32_t deltaTime);
+
+
+#endif /* OUTPUT_SCHEDULER_H_ */
@@ -0,0 +1,43 @@
+// ************************************************************
+// pid.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: The PID stage of the height and yaw channels.
+// Explaination: Fixed point, scaled by PRECISION as in control.c. The derivative
+// acts on the error rate given by the caller, so the reference's velocity can be
+// fed forward, and the integral is bounded to PID_INTEGRAL_LIMIT either way. Kept
+// apart from control.c, with no hardware dependencies, so the host tools can run
+// the same arithmetic as the board (tools/batchSim.cpp).
+// ************************************************************
+
+#include "pid.h"
+
+#include <stdlib.h>
+
+#define MS_TO_SEC 1000  // number of ms in one s
+#define SIGN(n) ((n) < 0 ? -1 : 1)
+
+
+// Return the PID output for one update, scaled by PRECISION. gains are in
+// control_gain_t order, error is the reference less the measurement and
+// errorRate its rate of change per second, both scaled by PRECISION. integral
+// is the controller's running integral, updated here. deltaTime is in ms.
+int32_t pidUpdate(const int32_t* gains, int32_t* integral, int32_t error, int32_t errorRate, uint32_t deltaTime)
+{
+    // proportonal component = Kp * error
+    int32_t prop = gains[CONTROL_KP] * error / PRECISION;
+
+    // derivitive component = Kd * d/dt(error)
+    int32_t deri = gains[CONTROL_KD] * errorRate / PRECISION;
+
+    // cumulative component = Ki * sum(error) from t0 to t. Hence, we sum. However, a bound
+    // is put on the cumulative component to stop overflow.
+    *integral += gains[CONTROL_KI] * (int32_t)deltaTime * error / MS_TO_SEC / PRECISION;
+    if (abs(*integral) > PID_INTEGRAL_LIMIT) {
+        // limit to the max integral value (as a +ve or -ve value) with the correct sign
+        *integral = SIGN(*integral) * PID_INTEGRAL_LIMIT;
+    }
+    return prop + deri + *integral;
+}
@@ -0,0 +1,40 @@
+// ************************************************************
+// pid.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: The PID stage of the height and yaw channels.
+// Explaination: Fixed point, scaled by PRECISION as in control.c. The derivative
+// acts on the error rate given by the caller, so the reference's velocity can be
+// fed forward, and the integral is bounded to PID_INTEGRAL_LIMIT either way. Kept
+// apart from control.c, with no hardware dependencies, so the host tools can run
+// the same arithmetic as the board (tools/batchSim.cpp).
+// ************************************************************
+
+#ifndef PID_H_
+#define PID_H_
+
+#include <stdint.h>
+
+#include "control.h"  // PRECISION and the gain order
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define PID_INTEGRAL_LIMIT (PRECISION * 200)  // set to 200% max compensation
+
+
+// Return the PID output for one update, scaled by PRECISION. gains are in
+// control_gain_t order, error is the reference less the measurement and
+// errorRate its rate of change per second, both scaled by PRECISION. integral
+// is the controller's running integral, updated here. deltaTime is in ms.
+int32_t pidUpdate(const int32_t* gains, int32_t* integral, int32_t error, int32_t errorRate, uint32_t deltaTime);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PID_H_ */
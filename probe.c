@@ -0,0 +1,134 @@
+// ************************************************************
+// probe.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Cycle accurate timing of interrupts and tasks on the board.
+// Explaination: The recording is done inline by the macros in probe.h. This
+// file starts the cycle counter and sends the results over UART.
+// ************************************************************
+
+#include <string.h>
+
+#include "probe.h"
+#include "uartDisplay.h"
+#include "telemetry.h"
+#include "utils/ustdlib.h"
+
+#define PROBE_LINE_LENGTH 192  // room for the longest histogram likely between dumps
+
+#if PROBES_ENABLED
+probe_stats_t probeStats[PROBE_NUM_PROBES];
+#endif
+
+// in probe_id_t order
+static const char* probeNames[PROBE_NUM_PROBES] = {
+    "none",
+    "adcIsr",
+    "quadEncoderIsr",
+    "sysTickIsr",
+    "mainUpdate",
+    "displayUpdate",
+    "telemetryUpdate",
+    "stateTransitionUpdate",
+    "stepResponseUpdate",
+    "recorderUpdate",
+    "commandUpdate"
+};
+
+static bool isDumping = false;
+static uint32_t next = 0;  // next probe to send
+
+
+// Clear the results of one probe.
+static void probeClear(probe_id_t id)
+{
+#if PROBES_ENABLED
+    memset(&probeStats[id], 0, sizeof(probeStats[id]));
+    probeStats[id].min = UINT32_MAX;
+#endif
+}
+
+
+// Start the cycle counter and clear the probes.
+void probeInit(void)
+{
+    uint32_t id;
+
+    halCyclesInit();
+
+    for (id = 0; id < PROBE_NUM_PROBES; id++) {
+        probeClear(id);
+    }
+}
+
+
+// Return the name of probe id, as used in the dumps.
+const char* probeGetName(probe_id_t id)
+{
+    return id < PROBE_NUM_PROBES ? probeNames[id] : "unknown";
+}
+
+
+// Copy the results of probe id into stats, as recorded since the last dump.
+void probeGetStats(probe_id_t id, probe_stats_t* stats)
+{
+#if PROBES_ENABLED
+    *stats = probeStats[id];
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+
+// Send the results of every probe, starting from the next call to probeDumpUpdate(..).
+void probeDumpStart(void)
+{
+    isDumping = true;
+    next = PROBE_NONE + 1;
+}
+
+
+// Task to send the results of one probe per call, until all have been sent. Each
+// probe is cleared once sent, so the next dump covers the time since.
+void probeDumpUpdate(state_t* state, uint32_t deltaTime)
+{
+    char line[PROBE_LINE_LENGTH];
+    probe_stats_t stats;
+    int length, i;
+
+    // wait for the previous line to be sent, so none are dropped, and don't put
+    // text into the middle of a binary stream or a trace dump
+    if (!isDumping || uartTxSpace() < PROBE_LINE_LENGTH || !telemetryIsTextAllowed()) {
+        return;
+    }
+
+    // the ISR probes record from interrupts, so copy and clear with them off or a
+    // sample landing in between would be lost or leave the copy half updated
+    bool prevIntState = halInterruptsDisable();
+    probeGetStats(next, &stats);
+    probeClear(next);
+    if (!prevIntState) {
+        halInterruptsEnable();
+    }
+
+    // leave room for \r\n\0 at the end, a line which is too long is cut short
+    uint32_t size = sizeof(line) - 2;
+    length = usnprintf(line, size, "%s n=%u min=%u max=%u mean=%u h=",
+                       probeNames[next], stats.count, stats.count ? stats.min : 0, stats.max,
+                       stats.count ? (uint32_t)(stats.total / stats.count) : 0);
+    for (i = 0; i < PROBE_NUM_BUCKETS && length < size - 1; i++) {
+        length += usnprintf(&line[length], size - length, i ? ",%u" : "%u", stats.histogram[i]);
+    }
+    if (length > size - 1) {
+        length = size - 1;
+    }
+    strcpy(&line[length], "\r\n");
+    uartSend(line);
+
+    next++;
+    if (next >= PROBE_NUM_PROBES) {
+        isDumping = false;
+    }
+}
@@ -0,0 +1,136 @@
+// ************************************************************
+// probe.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Cycle accurate timing of interrupts and tasks on the board.
+// Explaination: A probe times the code between PROBE_START and PROBE_STOP with
+// the Cortex-M4 DWT cycle counter, and keeps the count, min, max, total and a
+// histogram of the times in static memory. The histogram has a bucket per
+// power of two cycles. With PROBES_ENABLED set to 0 the macros compile to
+// nothing. probeDumpUpdate(..) sends the results over UART, one probe per line:
+//   adcIsr n=160 min=92 max=131 mean=95 h=0,0,0,0,0,0,0,158,2,0,0,0,0,0,0,0
+// ************************************************************
+
+#ifndef PROBE_H_
+#define PROBE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "hal.h"
+#include "stateInfo.h"
+
+#define PROBES_ENABLED 1  // set to 0 to remove the probes from the build
+#define PROBE_NUM_BUCKETS 16  // bucket i holds times from 2^i to 2^(i+1) - 1 cycles, the last holds the rest
+
+// Everything which can be probed. Add a name in probe.c when adding a probe.
+typedef enum {
+    PROBE_NONE = 0,  // not probed, for tasks which are not timed
+    PROBE_ADC_ISR,
+    PROBE_QUAD_ENCODER_ISR,
+    PROBE_SYSTICK_ISR,
+    PROBE_TASK_MAIN,
+    PROBE_TASK_DISPLAY,
+    PROBE_TASK_TELEMETRY,
+    PROBE_TASK_STATE_TRANSITION,
+    PROBE_TASK_STEP_RESPONSE,
+    PROBE_TASK_RECORDER,
+    PROBE_TASK_COMMAND,
+
+    // the value of this enum is the number of probes defined above
+    PROBE_NUM_PROBES
+} probe_id_t;
+
+
+// The times recorded by one probe, in cycles.
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[PROBE_NUM_BUCKETS];
+} probe_stats_t;
+
+
+// The current value of the cycle counter, started by probeInit(). Kept with the
+// probes removed, for benchmark.c.
+#define PROBE_CYCLES() halCycles()
+
+
+#if PROBES_ENABLED
+
+extern probe_stats_t probeStats[PROBE_NUM_PROBES];
+
+// Declare the variable start and store the cycle count in it.
+#define PROBE_START(start) uint32_t start = PROBE_CYCLES()
+
+// Record the cycles since PROBE_START(start) against probe id.
+#define PROBE_STOP(id, start) probeRecord((id), PROBE_CYCLES() - (start))
+
+
+// Record one time against a probe. Kept inline so a probe costs a few cycles.
+// Times for PROBE_NONE, from tasks which are not timed, are ignored.
+static inline void probeRecord(probe_id_t id, uint32_t cycles)
+{
+    probe_stats_t* stats = &probeStats[id];
+    uint32_t bucket;
+
+    if (id == PROBE_NONE) {
+        return;
+    }
+
+#if defined(__GNUC__)
+    bucket = cycles ? 31 - __builtin_clz(cycles) : 0;
+#else
+    bucket = 0;
+    while ((cycles >> bucket) > 1) {
+        bucket++;
+    }
+#endif
+    if (bucket >= PROBE_NUM_BUCKETS) {
+        bucket = PROBE_NUM_BUCKETS - 1;
+    }
+
+    stats->count++;
+    stats->total += cycles;
+    stats->histogram[bucket]++;
+    if (cycles < stats->min) {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+}
+
+#else
+
+#define PROBE_START(start)
+#define PROBE_STOP(id, start)
+
+#endif
+
+
+// Start the cycle counter and clear the probes.
+void probeInit(void);
+
+
+// Return the name of probe id, as used in the dumps.
+const char* probeGetName(probe_id_t id);
+
+
+// Copy the results of probe id into stats, as recorded since the last dump.
+void probeGetStats(probe_id_t id, probe_stats_t* stats);
+
+
+// Send the results of every probe, starting from the next call to probeDumpUpdate(..).
+void probeDumpStart(void);
+
+
+// Task to send the results of one probe per call, until all have been sent. Each
+// probe is cleared once sent, so the next dump covers the time since.
+void probeDumpUpdate(state_t* state, uint32_t deltaTime);
+
+
+#endif /* PROBE_H_ */
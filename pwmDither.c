@@ -0,0 +1,41 @@
+// ************************************************************
+// pwmDither.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Spread the part of a PWM pulse width finer than the generator can
+// output over successive periods.
+// Explaination: Widths are held as fixed point PWM counts with PWM_DITHER_BITS
+// fractional bits. A first order sigma-delta modulator outputs whole widths in
+// steps of PWM_WIDTH_STEP counts, carrying the remainder to the next period, so
+// the average width converges on the target. Kept apart from pwmModule.c, with
+// no hardware dependencies, so the achieved average can be simulated in tools/.
+// ************************************************************
+
+#include "pwmDither.h"
+
+
+// Set the width to average to, in counts scaled by PWM_DITHER_ONE. Written as a
+// single word, so it can be called while the period interrupt is running.
+void pwmDitherSetTarget(pwm_dither_t* dither, uint32_t target)
+{
+    dither->target = target;
+}
+
+
+// Return the width to output for the next period, a multiple of PWM_WIDTH_STEP
+// counts. The whole steps of the target are always output and the remainder is
+// accumulated, adding one more step each time the accumulator overflows.
+uint32_t pwmDitherNext(pwm_dither_t* dither)
+{
+    uint32_t target = dither->target;
+    uint32_t steps = target / PWM_DITHER_STEP;
+
+    dither->accumulator += target % PWM_DITHER_STEP;
+    if (dither->accumulator >= PWM_DITHER_STEP) {
+        dither->accumulator -= PWM_DITHER_STEP;
+        steps++;
+    }
+    return steps * PWM_WIDTH_STEP;
+}
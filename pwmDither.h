@@ -0,0 +1,53 @@
+// ************************************************************
+// pwmDither.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Spread the part of a PWM pulse width finer than the generator can
+// output over successive periods.
+// Explaination: Widths are held as fixed point PWM counts with PWM_DITHER_BITS
+// fractional bits. A first order sigma-delta modulator outputs whole widths in
+// steps of PWM_WIDTH_STEP counts, carrying the remainder to the next period, so
+// the average width converges on the target. Kept apart from pwmModule.c, with
+// no hardware dependencies, so the achieved average can be simulated in tools/.
+// ************************************************************
+
+#ifndef PWMDITHER_H_
+#define PWMDITHER_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define PWM_DITHER_BITS 8
+#define PWM_DITHER_ONE (1 << PWM_DITHER_BITS)  // one count, scaled
+// The generators count up/down, where PWMPulseWidthSet(..) halves the width and the
+// hardware doubles it again, so only even widths reach the output.
+#define PWM_WIDTH_STEP 2  // counts
+#define PWM_DITHER_STEP (PWM_WIDTH_STEP * PWM_DITHER_ONE)
+
+
+typedef struct {
+    volatile uint32_t target;  // counts scaled by PWM_DITHER_ONE, written outside the interrupt
+    uint32_t accumulator;  // scaled counts carried between periods, below PWM_DITHER_STEP
+} pwm_dither_t;
+
+
+// Set the width to average to, in counts scaled by PWM_DITHER_ONE. Written as a
+// single word, so it can be called while the period interrupt is running.
+void pwmDitherSetTarget(pwm_dither_t* dither, uint32_t target);
+
+
+// Return the width to output for the next period, a multiple of PWM_WIDTH_STEP
+// counts. Called once per PWM period.
+uint32_t pwmDitherNext(pwm_dither_t* dither);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PWMDITHER_H_ */
@@ -11,129 +11,154 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "inc/hw_memmap.h"
-#include "inc/hw_types.h"
-#include "driverlib/pin_map.h" //Needed for pin configure
-#include "driverlib/debug.h"
-#include "driverlib/gpio.h"
-#include "driverlib/pwm.h"
-#include "driverlib/systick.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/interrupt.h"
-#include "buttons4.h"
-
-#include "inc/hw_ints.h"
-#include "driverlib/adc.h"
-#include "driverlib/debug.h"
-#include "utils/ustdlib.h"
-#include "stdlib.h"
+#include "hal.h"
 #include "pwmModule.h"
-
-// Systick configuration
-#define SYSTICK_RATE_HZ    100
+#include "pwmDither.h"
+#include "timerer.h"
 
 // PWM configuration
 #define PWM_START_RATE_HZ  250  // Hz
 #define PWM_START_DUTY     10   // %
-#define PWM_DIVIDER_CODE   SYSCTL_PWMDIV_4
-#define PWM_DIVIDER        4
-
-// PWM Hardware Details M0PWM7 (gen 3)
-// Main Rotor PWM: PC5, J4-05
-#define PWM_MAIN_BASE        PWM0_BASE
-#define PWM_MAIN_GEN         PWM_GEN_3
-#define PWM_MAIN_OUTNUM      PWM_OUT_7
-#define PWM_MAIN_OUTBIT      PWM_OUT_7_BIT
-#define PWM_MAIN_PERIPH_PWM  SYSCTL_PERIPH_PWM0
-#define PWM_MAIN_PERIPH_GPIO SYSCTL_PERIPH_GPIOC
-#define PWM_MAIN_GPIO_BASE   GPIO_PORTC_BASE
-#define PWM_MAIN_GPIO_CONFIG GPIO_PC5_M0PWM7
-#define PWM_MAIN_GPIO_PIN    GPIO_PIN_5
-
-// Tail rotor PWM: PF1
-#define PWM_TAIL_BASE        PWM1_BASE
-#define PWM_TAIL_GEN         PWM_GEN_2
-#define PWM_TAIL_OUTNUM      PWM_OUT_5
-#define PWM_TAIL_OUTBIT      PWM_OUT_5_BIT
-#define PWM_TAIL_PERIPH_PWM  SYSCTL_PERIPH_PWM1
-#define PWM_TAIL_PERIPH_GPIO SYSCTL_PERIPH_GPIOF
-#define PWM_TAIL_GPIO_BASE   GPIO_PORTF_BASE
-#define PWM_TAIL_GPIO_CONFIG GPIO_PF1_M1PWM5
-#define PWM_TAIL_GPIO_PIN    GPIO_PIN_1
-
-
-// M0PWM7 (J4-05, PC5) is used for the main rotor motor
+#define MS_TO_US 1000  // number of us in one ms
+#define PWM_LATCH_DELAY_US (MS_TO_US * 1000 / PWM_START_RATE_HZ / 2)  // from the interrupt to the latch
+
+static uint32_t period;  // PWM period in counts
+
+// Pulse width of each channel, dithered over successive periods. See pwmDither.h.
+static pwm_dither_t dither[2];
+
+// The measurement behind the duty cycle waiting to be latched, see pwmSetDutyFrom(..)
+static volatile bool isSamplePending[2];
+static volatile uint32_t pendingTime[2], pendingDelay[2];
+
+// sensor to latch latency of each channel, in us. Written by the interrupts.
+static volatile uint32_t latencyCount[2], latencyMin[2], latencyMax[2];
+static volatile uint64_t latencyTotal[2];
+
+
+// Add the age of the pending measurement of channel to its latency, as the width
+// just set is latched. Called from the interrupts.
+static void pwmAddLatency(pwm_channel_t channel)
+{
+    if (!isSamplePending[channel]) {
+        return;
+    }
+    isSamplePending[channel] = false;
+
+    uint32_t latency = timererTicksSince(pendingTime[channel]) / (timererMsToTicks(1) / MS_TO_US)
+                       + pendingDelay[channel] + PWM_LATCH_DELAY_US;
+
+    latencyCount[channel]++;
+    latencyTotal[channel] += latency;
+    if (latencyCount[channel] == 1 || latency < latencyMin[channel]) {
+        latencyMin[channel] = latency;
+    }
+    if (latency > latencyMax[channel]) {
+        latencyMax[channel] = latency;
+    }
+}
+
+
+// Interrupt handler for the main rotor generator, triggered when the counter reaches
+// the load value (the middle of the period in up/down mode). The new width is latched
+// by the hardware when the counter next reaches zero.
+void pwmMainIntHandler(void)
+{
+    halPwmIntClear(MAIN_ROTOR);
+    halPwmSetWidth(MAIN_ROTOR, pwmDitherNext(&dither[MAIN_ROTOR]));
+    pwmAddLatency(MAIN_ROTOR);
+}
+
+
+// Interrupt handler for the tail rotor generator. See pwmMainIntHandler.
+void pwmTailIntHandler(void)
+{
+    halPwmIntClear(TAIL_ROTOR);
+    halPwmSetWidth(TAIL_ROTOR, pwmDitherNext(&dither[TAIL_ROTOR]));
+    pwmAddLatency(TAIL_ROTOR);
+}
+
+
+// M0PWM7 (J4-05, PC5) is used for the main rotor motor, M1PWM5 (PF1) for the tail.
+// Both start with their output off. Repeat pwmSetOutputState(..) with 'true' to turn it on.
 void pwmInit(void)
 {
-    // reset PWM generators, the GPIO pins are reset elsewhere
-    SysCtlPeripheralReset(PWM_MAIN_PERIPH_PWM);
-    SysCtlPeripheralReset(PWM_TAIL_PERIPH_PWM);
-
-    SysCtlPeripheralEnable(PWM_MAIN_PERIPH_PWM);
-    SysCtlPeripheralEnable(PWM_TAIL_PERIPH_PWM);
-    SysCtlPeripheralEnable(PWM_MAIN_PERIPH_GPIO);
-    SysCtlPeripheralEnable(PWM_TAIL_PERIPH_GPIO);
-
-    GPIOPinConfigure(PWM_MAIN_GPIO_CONFIG);
-    GPIOPinConfigure(PWM_TAIL_GPIO_CONFIG);
-    GPIOPinTypePWM(PWM_MAIN_GPIO_BASE, PWM_MAIN_GPIO_PIN);
-    GPIOPinTypePWM(PWM_TAIL_GPIO_BASE, PWM_TAIL_GPIO_PIN);
-
-    PWMGenConfigure(PWM_MAIN_BASE, PWM_MAIN_GEN,
-                    PWM_GEN_MODE_UP_DOWN | PWM_GEN_MODE_NO_SYNC);
-    PWMGenConfigure(PWM_TAIL_BASE, PWM_TAIL_GEN,
-                        PWM_GEN_MODE_UP_DOWN | PWM_GEN_MODE_NO_SYNC);
-    // Set the initial PWM parameters ***
+    // update the dithered pulse width once per period
+    period = halPwmInit(MAIN_ROTOR, PWM_START_RATE_HZ, pwmMainIntHandler);
+    halPwmInit(TAIL_ROTOR, PWM_START_RATE_HZ, pwmTailIntHandler);
+
+    // Set the initial PWM parameters
     pwmSetDuty(PWM_START_DUTY, 1, MAIN_ROTOR);
     pwmSetDuty(PWM_START_DUTY, 1, TAIL_ROTOR);
 
-    PWMGenEnable(PWM_MAIN_BASE, PWM_MAIN_GEN);
-    PWMGenEnable(PWM_TAIL_BASE, PWM_TAIL_GEN);
-
-    // Disable the output.  Repeat this call with 'true' to turn O/P on.
-    PWMOutputState(PWM_MAIN_BASE, PWM_MAIN_OUTBIT, false);
-    PWMOutputState(PWM_TAIL_BASE, PWM_TAIL_OUTBIT, false);
-
-    // Set the PWM clock rate (using the prescaler)
-    SysCtlPWMClockSet(PWM_DIVIDER_CODE);
+    halPwmSetWidth(MAIN_ROTOR, pwmDitherNext(&dither[MAIN_ROTOR]));
+    halPwmSetWidth(TAIL_ROTOR, pwmDitherNext(&dither[TAIL_ROTOR]));
 }
 
 
 // take a duty cycle, as a percentage from 0 to 100, a precision multiplier (i.e. a multiplier of 100 means
 // the supplied duty cycle is a factor of 100 larger than needs and should be divided down), and an enum
-// with the name of the channel to change the pwm duty cycle of.
+// with the name of the channel to change the pwm duty cycle of. The part of the duty cycle finer than the
+// generator's width step is dithered over successive periods rather than truncated.
 void pwmSetDuty(uint32_t dutyPercent, uint32_t precision, pwm_channel_t channel)
 {
-    // Calculate the PWM period corresponding to the freq.
-    uint32_t period = SysCtlClockGet() / PWM_DIVIDER / PWM_START_RATE_HZ;
-    switch(channel)
-    {
-    case MAIN_ROTOR:
-        PWMGenPeriodSet(PWM_MAIN_BASE, PWM_MAIN_GEN, period);
-        PWMPulseWidthSet(PWM_MAIN_BASE, PWM_MAIN_OUTNUM, period * dutyPercent / 100 / precision);
-        break;
-    case TAIL_ROTOR:
-        PWMGenPeriodSet(PWM_TAIL_BASE, PWM_TAIL_GEN, period);
-        PWMPulseWidthSet(PWM_TAIL_BASE, PWM_TAIL_OUTNUM, period * dutyPercent / 100 / precision);
-        break;
-    }
+    // 64 bit intermediate since period * dutyPercent * PWM_DITHER_ONE overflows 32 bits
+    pwmDitherSetTarget(&dither[channel], (uint64_t)period * dutyPercent * PWM_DITHER_ONE / 100 / precision);
 }
 
 
-// enable or disable output from a given channel.
-void pwmSetOutputState(bool state, pwm_channel_t channel)
+// As pwmSetDuty(..), for a duty cycle worked out from a measurement taken at sampleTime,
+// in timer ticks. When the first width for it is latched, the age of the measurement
+// is added to the channel's latency, with extraDelay in us for any delay before
+// sampleTime such as a filter's.
+void pwmSetDutyFrom(uint32_t dutyPercent, uint32_t precision, pwm_channel_t channel,
+                    uint32_t sampleTime, uint32_t extraDelay)
 {
-    switch(channel)
-    {
-    case MAIN_ROTOR:
-        // Calculate the PWM period corresponding to the freq.
-        PWMOutputState(PWM_MAIN_BASE, PWM_MAIN_OUTBIT, state);
-        break;
-    case TAIL_ROTOR:
-        // Calculate the PWM period corresponding to the freq.
-        PWMOutputState(PWM_TAIL_BASE, PWM_TAIL_OUTBIT, state);
-        break;
-    }
+    // so the interrupt sees the duty cycle and its measurement together
+    bool prevIntState = halInterruptsDisable();
+
+    pwmSetDuty(dutyPercent, precision, channel);
+    pendingTime[channel] = sampleTime;
+    pendingDelay[channel] = extraDelay;
+    isSamplePending[channel] = true;
+
+    if (!prevIntState)
+        halInterruptsEnable();
+}
+
+
+// Copy the latency of a channel into latency. See pwmSetDutyFrom(..).
+void pwmGetLatency(pwm_channel_t channel, pwm_latency_t* latency)
+{
+    bool prevIntState = halInterruptsDisable();
 
+    latency->count = latencyCount[channel];
+    latency->min = latencyMin[channel];
+    latency->max = latencyMax[channel];
+    latency->mean = latencyCount[channel] ? latencyTotal[channel] / latencyCount[channel] : 0;
+
+    if (!prevIntState)
+        halInterruptsEnable();
+}
+
+
+// Start measuring the latency of both channels again.
+void pwmResetLatency(void)
+{
+    bool prevIntState = halInterruptsDisable();
+
+    latencyCount[MAIN_ROTOR] = latencyCount[TAIL_ROTOR] = 0;
+    latencyTotal[MAIN_ROTOR] = latencyTotal[TAIL_ROTOR] = 0;
+    latencyMax[MAIN_ROTOR] = latencyMax[TAIL_ROTOR] = 0;
+    isSamplePending[MAIN_ROTOR] = isSamplePending[TAIL_ROTOR] = false;
+
+    if (!prevIntState)
+        halInterruptsEnable();
 }
 
+
+// enable or disable output from a given channel.
+void pwmSetOutputState(bool state, pwm_channel_t channel)
+{
+    halPwmSetOutput(channel, state);
+}
@@ -12,6 +12,13 @@
 #ifndef PWM_MODULE_H_
 #define PWM_MODULE_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
 
 // two PWM channels are defined
 typedef enum pwm_channel {
@@ -19,16 +26,46 @@ typedef enum pwm_channel {
 } pwm_channel_t;
 
 
+// How old the measurements behind a channel's widths were when the widths were latched.
+typedef struct {
+    uint32_t count;  // number of widths measured
+    uint32_t min;  // us
+    uint32_t mean;  // us
+    uint32_t max;  // us
+} pwm_latency_t;
+
+
 void pwmInit(void);
 
 
 // take a duty cycle, as a percentage from 0 to 100, a precision multiplier (i.e. a multiplier of 100 means
 // the supplied duty cycle is a factor of 100 larger than needs and should be divided down), and an enum
-// with the name of the channel to change the pwm duty cycle of.
+// with the name of the channel to change the pwm duty cycle of. The part of the duty cycle finer than the
+// generator's width step is dithered over successive periods rather than truncated.
 void pwmSetDuty(uint32_t dutyPercent, uint32_t precision, pwm_channel_t channel);
 
 
+// As pwmSetDuty(..), for a duty cycle worked out from a measurement taken at sampleTime,
+// in timer ticks. When the first width for it is latched, the age of the measurement
+// is added to the channel's latency, with extraDelay in us for any delay before
+// sampleTime such as a filter's.
+void pwmSetDutyFrom(uint32_t dutyPercent, uint32_t precision, pwm_channel_t channel,
+                    uint32_t sampleTime, uint32_t extraDelay);
+
+
+// Copy the latency of a channel into latency. See pwmSetDutyFrom(..).
+void pwmGetLatency(pwm_channel_t channel, pwm_latency_t* latency);
+
+
+// Start measuring the latency of both channels again.
+void pwmResetLatency(void);
+
+
 // enable or disable output from a given channel.
 void pwmSetOutputState(bool state, pwm_channel_t channel);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*PWM_MODULE_H_*/
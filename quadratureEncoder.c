@@ -11,15 +11,15 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "inc/hw_memmap.h"
-#include "driverlib/gpio.h"
-#include "driverlib/sysctl.h"
+#include "hal.h"
+#include "probe.h"
+#include "trace.h"
+#include "timerer.h"
+#include "recorder.h"
 
-// Define constants for A and B encoder channel GPIO pins (PB0 and PB1 respectively)
-#define GPIO_CHANNEL_PERIPH     SYSCTL_PERIPH_GPIOB
-#define CHANNEL_PORT_BASE       GPIO_PORTB_BASE
-#define CHANNEL_A_PIN           GPIO_PIN_0
-#define CHANNEL_B_PIN           GPIO_PIN_1
+// The A and B encoder channels (PB0 and PB1 respectively)
+#define CHANNEL_A_PIN           HAL_ENCODER_A
+#define CHANNEL_B_PIN           HAL_ENCODER_B
 
 #define CW_DIRECTION    1
 #define CCW_DIRECTION  -1
@@ -29,16 +29,18 @@
 static uint32_t initialPinState;
 static volatile int32_t direction, encoderCount = 0;
 static volatile uint32_t lastIntStatus = INITIAL_INT_STATUS;
+static volatile uint32_t lastEdgeTime = 0;  // timer ticks when the last edge was counted
 
 
 // Handles interrupts from A and B channels of the quadrature encoder
 // Adds or subtracts from encoderCount depending on current rotation direction
 void quadEncoderIntHandler(void)
 {
-    uint32_t intStatus = GPIOIntStatus(CHANNEL_PORT_BASE, true); // Gets the pin that triggered
-                                                                 // the interrupt
-    // Clear the interrupt
-    GPIOIntClear(CHANNEL_PORT_BASE, CHANNEL_A_PIN | CHANNEL_B_PIN);
+    uint32_t now = timererGetTicks();  // first, so a replay can raise the edge at the same time
+    TRACE(TRACE_ISR_ENTER, PROBE_QUAD_ENCODER_ISR, 0);
+    PROBE_START(start);
+    uint32_t intStatus = halEncoderIntStatus(); // Gets the pin that triggered the interrupt
+                                                // and clears the interrupt
 
     if(lastIntStatus == INITIAL_INT_STATUS) // If this is the first interrupt, determine
     {                                       //  the initial direction of rotation
@@ -73,6 +75,10 @@ void quadEncoderIntHandler(void)
 
     encoderCount += direction; // Either add or subtract one depending on direction
     lastIntStatus = intStatus;
+    lastEdgeTime = now;
+    recorderAddEvent(RECORDER_EV_ENCODER, intStatus, now);
+    PROBE_STOP(PROBE_QUAD_ENCODER_ISR, start);
+    TRACE(TRACE_ISR_EXIT, PROBE_QUAD_ENCODER_ISR, 0);
 }
 
 
@@ -105,24 +111,18 @@ int32_t quadEncoderGetCount(void)
 }
 
 
+// Returns the timer ticks when the last edge was counted, see timererTicksSince
+uint32_t quadEncoderGetEdgeTime(void)
+{
+    return lastEdgeTime;
+}
+
+
 // Configure GPIO pins and initialize interrupts
 // Get initial state of channel pins for determining direction on first interrupt
 void quadEncoderInit(void)
 {
-    // Enable GPIO peripheral on used ports
-    SysCtlPeripheralEnable(GPIO_CHANNEL_PERIPH);
-
-    // Configure channel input pins (active HIGH)
-    GPIOPadConfigSet(CHANNEL_PORT_BASE, CHANNEL_A_PIN | CHANNEL_B_PIN, GPIO_STRENGTH_4MA, GPIO_PIN_TYPE_STD_WPD);
-    GPIODirModeSet(CHANNEL_PORT_BASE, CHANNEL_A_PIN | CHANNEL_B_PIN, GPIO_DIR_MODE_IN);
-
-    // Initialize channel interrupts
-    GPIOIntRegister(CHANNEL_PORT_BASE, quadEncoderIntHandler);
-    GPIOIntTypeSet(CHANNEL_PORT_BASE, CHANNEL_A_PIN | CHANNEL_B_PIN, GPIO_BOTH_EDGES);
-
+    // Configure channel input pins (active HIGH) and enable their interrupts on both edges.
     // Get initial state of channel A and channel B for initially determining direction
-    initialPinState = GPIOPinRead(CHANNEL_PORT_BASE, CHANNEL_A_PIN | CHANNEL_B_PIN);
-
-    // Enable encoder interrupts
-    GPIOIntEnable(CHANNEL_PORT_BASE, CHANNEL_A_PIN | CHANNEL_B_PIN);
+    initialPinState = halEncoderInit(quadEncoderIntHandler);
 }
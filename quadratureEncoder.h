@@ -13,6 +13,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
 
 // Resets the running encoder count to zero
 void quadEncoderResetCount(void);
@@ -34,8 +38,21 @@ void quadEncoderSetCount(uint32_t newCount);
 int32_t quadEncoderGetCount(void);
 
 
+// Returns the timer ticks when the last edge was counted, see timererTicksSince
+uint32_t quadEncoderGetEdgeTime(void);
+
+
 // Configure GPIO pins and initialize interrupts
 // Get initial state of channel pins for determining direction on first interrupt
 void quadEncoderInit(void);
 
+
+// Handles interrupts from A and B channels of the quadrature encoder.
+// Public so that tools/bench can time it.
+void quadEncoderIntHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*QUADRATURE_ENCODER_H_*/
@@ -0,0 +1,179 @@
+// ************************************************************
+// recorder.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Record the raw sensor inputs over UART so that a flight can be
+// looked at again, or replayed through the firmware on a PC.
+// Explaination: The interrupts each fill a queue which only the recorder task
+// empties. Only one interrupt runs at a time, so the queues need no locking.
+// The task takes whatever is queued, in as many packets as it needs, and times
+// the events from the start of the recording by counting the timer on past
+// its wrap. recorderPacket.c builds the packets.
+// ************************************************************
+
+#include "recorder.h"
+#include "recorderPacket.h"
+#include "telemetry.h"
+#include "quadratureEncoder.h"
+#include "timerer.h"
+#include "uartDisplay.h"
+
+typedef struct {
+    uint32_t time;  // timer ticks
+    uint8_t type;  // recorder_event_t
+    uint8_t data;
+} recorder_event_entry_t;
+
+static volatile bool isRecording = false;
+
+static volatile uint16_t samples[RECORDER_ADC_QUEUE_SIZE];
+static volatile uint32_t sampleHead = 0, sampleTail = 0;
+
+static volatile recorder_event_entry_t events[RECORDER_EVENT_QUEUE_SIZE];
+static volatile uint32_t eventHead = 0, eventTail = 0;
+
+static recorder_stats_t stats;
+static recorder_encoder_t encoder;
+static uint32_t lastTicks;  // the timer when elapsedTicks was last moved on
+static uint64_t elapsedTicks;  // since the recording started
+static uint32_t droppedReported;  // samples and events lost which packets have counted
+
+
+// Start a new recording from the timer value startTicks.
+static void recorderStart(uint32_t startTicks)
+{
+    sampleTail = sampleHead;
+    eventTail = eventHead;
+    recorderEncoderReset(&encoder);
+    lastTicks = startTicks;
+    elapsedTicks = 0;
+    droppedReported = stats.samplesDropped + stats.eventsDropped;
+    isRecording = true;
+}
+
+
+// Start recording from reset if RECORDER_FROM_RESET is set. Call straight
+// after timererInit(), before the interrupts are enabled.
+void recorderInit(void)
+{
+#if RECORDER_FROM_RESET
+    telemetrySetMode(TELEMETRY_RECORD);
+    recorderStart(TIMERER_MAX_TICKS);  // timed from the start of the timer
+#endif
+}
+
+
+// Store an ADC sample for the recording. Called from the ADC interrupt.
+void recorderAddSample(uint32_t sample)
+{
+    uint32_t next = (sampleHead + 1) % RECORDER_ADC_QUEUE_SIZE;
+
+    if (!isRecording) {
+        return;
+    }
+    if (next == sampleTail) {
+        stats.samplesDropped++;
+        return;
+    }
+    samples[sampleHead] = sample;
+    sampleHead = next;
+}
+
+
+// Store an event for the recording, which happened at time in timer ticks. Call
+// from an interrupt or with interrupts masked.
+void recorderAddEvent(recorder_event_t type, uint8_t data, uint32_t time)
+{
+    uint32_t next = (eventHead + 1) % RECORDER_EVENT_QUEUE_SIZE;
+
+    if (!isRecording) {
+        return;
+    }
+    if (next == eventTail) {
+        stats.eventsDropped++;
+        return;
+    }
+    events[eventHead].time = time;
+    events[eventHead].type = type;
+    events[eventHead].data = data;
+    eventHead = next;
+}
+
+
+// Copy the recording statistics into stats.
+void recorderGetStats(recorder_stats_t* statsOut)
+{
+    *statsOut = stats;
+}
+
+
+// Task to send the samples and events collected since the last call. Starts a new
+// recording when the telemetry mode changes to TELEMETRY_RECORD.
+void recorderUpdate(state_t* state, uint32_t deltaTime)
+{
+    uint16_t packetSamples[RECORDER_MAX_SAMPLES];
+    recorder_packet_event_t packetEvents[RECORDER_MAX_EVENTS];
+    uint8_t packet[TELEMETRY_MAX_PACKET_LENGTH];
+
+    if (telemetryGetMode() != TELEMETRY_RECORD) {
+        isRecording = false;
+        return;
+    }
+    if (!isRecording) {
+        // the first packet only marks the start
+        recorderStart(timererGetTicks());
+    }
+
+    // what is queued before the timer is read, so no event is newer than now
+    uint32_t numSamples = (sampleHead - sampleTail + RECORDER_ADC_QUEUE_SIZE) % RECORDER_ADC_QUEUE_SIZE;
+    uint32_t numEvents = (eventHead - eventTail + RECORDER_EVENT_QUEUE_SIZE) % RECORDER_EVENT_QUEUE_SIZE;
+    uint32_t now = timererGetTicks();
+    elapsedTicks += timererTicksBetween(lastTicks, now);
+    lastTicks = now;
+
+    uint32_t time = elapsedTicks / RECORDER_TICKS_PER_MS;
+    int32_t sinceTime = elapsedTicks - (uint64_t)time * RECORDER_TICKS_PER_MS;
+    int32_t count = quadEncoderGetCount();
+    uint32_t lost = stats.samplesDropped + stats.eventsDropped;
+    uint32_t dropped = lost - droppedReported;
+    droppedReported = lost;
+
+    // a delimiter first, so that text sent before can't run into the start packet
+    if (!encoder.isStarted) {
+        uint8_t delimiter = 0;
+        uartSendBytes(&delimiter, 1);
+    }
+
+    // always one packet, for the time and encoder count, and more while anything is left
+    do {
+        uint32_t packetNumSamples = 0, packetNumEvents = 0;
+
+        for (; numSamples > 0 && packetNumSamples < RECORDER_MAX_SAMPLES; numSamples--) {
+            packetSamples[packetNumSamples++] = samples[sampleTail];
+            sampleTail = (sampleTail + 1) % RECORDER_ADC_QUEUE_SIZE;
+        }
+        for (; numEvents > 0 && packetNumEvents < RECORDER_MAX_EVENTS; numEvents--) {
+            const volatile recorder_event_entry_t* event = &events[eventTail];
+            recorder_packet_event_t* packetEvent = &packetEvents[packetNumEvents++];
+            packetEvent->type = event->type;
+            packetEvent->data = event->data;
+            packetEvent->offset = sinceTime - (int32_t)timererTicksBetween(event->time, now);
+            eventTail = (eventTail + 1) % RECORDER_EVENT_QUEUE_SIZE;
+        }
+
+        uint32_t length = recorderEncodePacket(&encoder, time, count, packetSamples, packetNumSamples,
+                                               packetEvents, packetNumEvents, dropped, packet);
+        dropped = 0;
+
+        // a lost packet can't be resent. The decoder sees the gap in the sequence, and the
+        // next packet starts again from 0 so that the values are known again.
+        if (telemetrySendPacket(packet, length)) {
+            stats.packetsSent++;
+        } else {
+            stats.packetsDropped++;
+            recorderEncoderLost(&encoder);
+        }
+    } while (numSamples > 0 || numEvents > 0);
+}
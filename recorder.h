@@ -0,0 +1,73 @@
+// ************************************************************
+// recorder.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Record the raw sensor inputs over UART so that a flight can be
+// looked at again, or replayed through the firmware on a PC.
+// Explaination: In TELEMETRY_RECORD mode every ADC sample, the encoder count,
+// and every encoder edge, yaw reference, button pin edge and received
+// character are sent in compact binary packets (see recorderPacket.h), framed
+// in the same way as the telemetry (CRC-16 and COBS, see telemetry.h). Samples
+// and events are collected by the interrupts and sent by a task, and each
+// event is stamped with the timer as its interrupt starts.
+//
+// Built with RECORDER_FROM_RESET set to 1, recording starts at reset, timed
+// from the start of the timer, so that tools/replay can feed the recording back
+// through the firmware and get the same outputs to the bit. Every encoder edge
+// is an event, so a recording of a turning helicopter needs more than 9600
+// baud; build it with UART_BAUD_RATE 115200 as well. tools/recordDecode turns a
+// capture into a CSV timeline.
+// ************************************************************
+
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stateInfo.h"
+#include "recorderPacket.h"
+
+#ifndef RECORDER_FROM_RESET
+#define RECORDER_FROM_RESET 0  // 1 to record from reset, for tools/replay
+#endif
+
+#define RECORDER_ADC_QUEUE_SIZE 32  // covers 200 ms at 160 Hz, for the start up
+#define RECORDER_EVENT_QUEUE_SIZE 32
+
+
+// What the recorder has sent and lost.
+typedef struct {
+    uint32_t packetsSent;
+    uint32_t packetsDropped;  // the UART queue was too full, the sequence number shows the gap
+    uint32_t samplesDropped;  // ADC samples which didn't fit the queue
+    uint32_t eventsDropped;  // events which didn't fit the queue
+} recorder_stats_t;
+
+
+// Start recording from reset if RECORDER_FROM_RESET is set. Call straight
+// after timererInit(), before the interrupts are enabled.
+void recorderInit(void);
+
+
+// Store an ADC sample for the recording. Called from the ADC interrupt.
+void recorderAddSample(uint32_t sample);
+
+
+// Store an event for the recording, which happened at time in timer ticks. Call
+// from an interrupt or with interrupts masked.
+void recorderAddEvent(recorder_event_t type, uint8_t data, uint32_t time);
+
+
+// Copy the recording statistics into stats.
+void recorderGetStats(recorder_stats_t* stats);
+
+
+// Task to send the samples and events collected since the last call. Starts a new
+// recording when the telemetry mode changes to TELEMETRY_RECORD.
+void recorderUpdate(state_t* state, uint32_t deltaTime);
+
+
+#endif /* RECORDER_H_ */
@@ -0,0 +1,69 @@
+// ************************************************************
+// recorderPacket.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Build the packets of a sensor recording.
+// Explaination: Samples and the encoder count are sent as changes from the
+// previous packet's values to keep packets small, as zigzag varints written by
+// telemetryWriteVarint(..). See recorderPacket.h for the layout.
+// ************************************************************
+
+#include "recorderPacket.h"
+#include "telemetryPacket.h"
+
+
+// Start a new recording, with the sample and encoder changes measured from 0.
+void recorderEncoderReset(recorder_encoder_t* encoder)
+{
+    encoder->lastSample = 0;
+    encoder->lastCount = 0;
+    encoder->sequence = 0;
+    encoder->isStarted = false;
+}
+
+
+// Build the next packet of the recording into out, which must have room for
+// TELEMETRY_MAX_PACKET_LENGTH bytes. samples and events are oldest first, at
+// most RECORDER_MAX_SAMPLES and RECORDER_MAX_EVENTS of them. Returns the length.
+uint32_t recorderEncodePacket(recorder_encoder_t* encoder, uint32_t time, int32_t encoderCount,
+                              const uint16_t* samples, uint32_t numSamples,
+                              const recorder_packet_event_t* events, uint32_t numEvents,
+                              uint32_t dropped, uint8_t* out)
+{
+    uint32_t length = 0;
+    uint32_t i;
+
+    out[length++] = encoder->isStarted ? RECORDER_PACKET : RECORDER_START_PACKET;
+    out[length++] = encoder->sequence++;
+    length += telemetryWriteVarint(&out[length], time);
+    length += telemetryWriteVarint(&out[length], encoderCount - encoder->lastCount);
+    encoder->lastCount = encoderCount;
+    encoder->isStarted = true;
+
+    length += telemetryWriteVarint(&out[length], numSamples);
+    for (i = 0; i < numSamples; i++) {
+        length += telemetryWriteVarint(&out[length], samples[i] - encoder->lastSample);
+        encoder->lastSample = samples[i];
+    }
+
+    length += telemetryWriteVarint(&out[length], numEvents);
+    for (i = 0; i < numEvents; i++) {
+        out[length++] = events[i].type;
+        out[length++] = events[i].data;
+        length += telemetryWriteVarint(&out[length], events[i].offset);
+    }
+
+    length += telemetryWriteVarint(&out[length], dropped);
+    return length;
+}
+
+
+// Record that the last packet built was not sent. The decoder sees the gap in the
+// sequence, and the next packet starts its changes from 0 again.
+void recorderEncoderLost(recorder_encoder_t* encoder)
+{
+    encoder->lastSample = 0;
+    encoder->lastCount = 0;
+}
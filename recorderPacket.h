@@ -0,0 +1,91 @@
+// ************************************************************
+// recorderPacket.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Build the packets of a sensor recording.
+// Explaination: The encoding is kept apart from recorder.c, with no hardware
+// dependencies, so that the host decoder and the replay in tools/ are checked
+// against the same code as the firmware runs. Packets are framed as the
+// telemetry is, with telemetryFrame(..).
+//
+// Packet layout before framing, numbers other than the sequence are zigzag varints:
+//   [type] [sequence] [time] [encoder change] [n] [n ADC changes] [m] [m events] [dropped]
+// type is RECORDER_START_PACKET for the first packet of a recording and
+// RECORDER_PACKET after it. time is ms since the recording started, in whole
+// ms of the timer. The first encoder and ADC changes of a recording, or after
+// a lost packet, are from 0. Each event is [type byte] [data byte] [offset],
+// where offset is the event's time less the packet's time, in timer ticks
+// (RECORDER_TICKS_PER_MS per ms), so events are timed to the tick. dropped is
+// how many samples and events were lost since the last packet because the
+// queues were full.
+// ************************************************************
+
+#ifndef RECORDERPACKET_H_
+#define RECORDERPACKET_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define RECORDER_START_PACKET 'S'
+#define RECORDER_PACKET 'R'
+#define RECORDER_TICKS_PER_MS 20000  // the timer counts the 20 MHz system clock
+#define RECORDER_MAX_SAMPLES 16  // in a packet, 2 bytes for each 12 bit change
+#define RECORDER_MAX_EVENTS 10  // in a packet, 7 bytes each at worst, so any packet fits in 128 bytes
+
+
+// Kinds of events in a recording. Each is stamped with the first timer read of
+// the interrupt which saw it.
+typedef enum {
+    RECORDER_EV_YAW_REF = 0,  // the yaw reference was seen, data unused
+    RECORDER_EV_BUTTON,  // an edge on a button pin, data is the button << 1 | the pin is high
+    RECORDER_EV_ENCODER,  // an encoder edge, data is the HAL_ENCODER_A and B bits of the pins with an edge
+    RECORDER_EV_UART  // a character was received, data is the character
+} recorder_event_t;
+
+
+// An event ready for a packet.
+typedef struct {
+    uint8_t type;  // recorder_event_t
+    uint8_t data;
+    int32_t offset;  // timer ticks from the packet's time, negative before it
+} recorder_packet_event_t;
+
+
+// What the decoder is known to hold.
+typedef struct {
+    int32_t lastSample;
+    int32_t lastCount;
+    uint8_t sequence;
+    bool isStarted;  // the start packet has been built
+} recorder_encoder_t;
+
+
+// Start a new recording, with the sample and encoder changes measured from 0.
+void recorderEncoderReset(recorder_encoder_t* encoder);
+
+
+// Build the next packet of the recording into out, which must have room for
+// TELEMETRY_MAX_PACKET_LENGTH bytes. samples and events are oldest first, at
+// most RECORDER_MAX_SAMPLES and RECORDER_MAX_EVENTS of them. Returns the length.
+uint32_t recorderEncodePacket(recorder_encoder_t* encoder, uint32_t time, int32_t encoderCount,
+                              const uint16_t* samples, uint32_t numSamples,
+                              const recorder_packet_event_t* events, uint32_t numEvents,
+                              uint32_t dropped, uint8_t* out);
+
+
+// Record that the last packet built was not sent. The decoder sees the gap in the
+// sequence, and the next packet starts its changes from 0 again.
+void recorderEncoderLost(recorder_encoder_t* encoder);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RECORDERPACKET_H_ */
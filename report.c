@@ -0,0 +1,140 @@
+// ************************************************************
+// report.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Send the statistics kept by the modules over UART on request.
+// Explaination: Each line of the report is written by a function in
+// reportLines[]. Add a function there to report another module.
+// ************************************************************
+
+#include "report.h"
+#include "uartDisplay.h"
+#include "telemetry.h"
+#include "display.h"
+#include "recorder.h"
+#include "flightMode.h"
+#include "timerer.h"
+#include "utils/ustdlib.h"
+
+#define REPORT_LINE_LENGTH 96  // room for four 10 digit counts
+
+typedef void (*report_line_t)(char* line, uint32_t size);
+
+static bool isReporting = false;
+static uint32_t next = 0;  // next line to send
+
+static bool isReportingLog = false;
+static flight_log_entry_t logEntries[FLIGHT_LOG_SIZE];  // copied at the start so the lines agree
+static uint32_t logCount = 0;
+static uint32_t logAges[FLIGHT_LOG_SIZE];  // ms before the log was copied
+static uint32_t logNext = 0;
+
+
+static void uartStatsLine(char* line, uint32_t size)
+{
+    uart_tx_stats_t stats;
+    uartGetTxStats(&stats);
+    usnprintf(line, size, "uart queued=%u dropped=%u max=%u rxDropped=%u\r\n",
+              stats.bytesQueued, stats.bytesDropped, stats.maxQueued, uartRxDropped());
+}
+
+
+static void telemetryStatsLine(char* line, uint32_t size)
+{
+    telemetry_stats_t stats;
+    telemetryGetStats(&stats);
+    usnprintf(line, size, "telemetry sent=%u skipped=%u bytes=%u\r\n",
+              stats.packetsSent, stats.packetsSkipped, stats.bytesSent);
+}
+
+
+// Without the cache every line requested would send a whole line to the OLED,
+// so saved is the bytes of drawing that were avoided.
+static void displayStatsLine(char* line, uint32_t size)
+{
+    display_stats_t stats;
+    displayGetStats(&stats);
+    usnprintf(line, size, "display lines=%u draws=%u chars=%u saved=%u\r\n",
+              stats.linesRequested, stats.drawCalls, stats.charsDrawn,
+              (stats.linesRequested * DISPLAY_CHAR_WIDTH - stats.charsDrawn) * DISPLAY_BYTES_PER_CHAR);
+}
+
+
+static void recorderStatsLine(char* line, uint32_t size)
+{
+    recorder_stats_t stats;
+    recorderGetStats(&stats);
+    usnprintf(line, size, "recorder sent=%u dropped=%u samplesDropped=%u eventsDropped=%u\r\n",
+              stats.packetsSent, stats.packetsDropped, stats.samplesDropped, stats.eventsDropped);
+}
+
+
+static const report_line_t reportLines[] = {
+    uartStatsLine,
+    telemetryStatsLine,
+    recorderStatsLine,
+    displayStatsLine
+    // add lines here
+};
+
+#define NUM_REPORT_LINES (sizeof(reportLines) / sizeof(reportLines[0]))
+
+
+// Send the statistics of every module, starting from the next call to reportUpdate(..).
+void reportStart(void)
+{
+    isReporting = true;
+    next = 0;
+}
+
+
+// Send the flight mode transition log, starting from the next call to reportUpdate(..).
+void reportLogStart(void)
+{
+    uint32_t i;
+
+    logCount = flightModeGetLog(logEntries, FLIGHT_LOG_SIZE);
+    for (i = 0; i < logCount; i++) {
+        logAges[i] = timererTicksSince(logEntries[i].time) / timererMsToTicks(1);
+    }
+    logNext = 0;
+    isReportingLog = true;
+}
+
+
+// Task to send one line of the report per call, until all have been sent.
+void reportUpdate(state_t* state, uint32_t deltaTime)
+{
+    char line[REPORT_LINE_LENGTH];
+
+    // wait for the previous line to be sent, so none are dropped, and don't put
+    // text into the middle of a binary stream or a trace dump
+    if ((!isReporting && !isReportingLog) || uartTxSpace() < REPORT_LINE_LENGTH ||
+            !telemetryIsTextAllowed()) {
+        return;
+    }
+
+    if (isReporting) {
+        reportLines[next](line, sizeof(line));
+        uartSend(line);
+
+        next++;
+        if (next >= NUM_REPORT_LINES) {
+            isReporting = false;
+        }
+        return;
+    }
+
+    if (logNext < logCount) {
+        const flight_log_entry_t* entry = &logEntries[logNext];
+        usnprintf(line, sizeof(line), "mode %u>%u event=%u ago=%ums\r\n",
+                  entry->from, entry->to, entry->event, logAges[logNext]);
+        logNext++;
+    } else {
+        usnprintf(line, sizeof(line), "mode log end\r\n");
+        isReportingLog = false;
+    }
+    uartSend(line);
+}
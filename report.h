@@ -0,0 +1,41 @@
+// ************************************************************
+// report.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Send the statistics kept by the modules over UART on request.
+// Explaination: The "D S" command calls reportStart(). reportUpdate(..) then
+// sends one line per call while in text telemetry mode, so the UART queue is
+// never flooded, e.g.
+//   telemetry sent=1520 skipped=3 bytes=14380
+// The counts are totals since power on. The "D L" command calls
+// reportLogStart() to send the flight mode transition log in the same way, one
+// transition per line, oldest first, with the heli_state_t and flight_event_t
+// numbers and how long ago it happened:
+//   mode 2>3 event=1 ago=5230ms
+// Ages wrap after one timer period (about 107 s at 20 MHz).
+// ************************************************************
+
+#ifndef REPORT_H_
+#define REPORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stateInfo.h"
+
+
+// Send the statistics of every module, starting from the next call to reportUpdate(..).
+void reportStart(void);
+
+
+// Send the flight mode transition log, starting from the next call to reportUpdate(..).
+void reportLogStart(void);
+
+
+// Task to send one line of the report per call, until all have been sent.
+void reportUpdate(state_t* state, uint32_t deltaTime);
+
+
+#endif /* REPORT_H_ */
@@ -0,0 +1,106 @@
+// ************************************************************
+// stepAnalysis.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Measure the response of one controlled quantity to changes of target.
+// Explaination: Each change of target starts a new step. Rise time (10 % to 90 %),
+// overshoot, settling time and steady state error are calculated as the response
+// happens, using a fixed amount of memory, so the analysis can run for any length of
+// flight. Has no hardware dependencies, so stepResponse.c on the board and the
+// uartLog host tool measure steps the same way.
+// ************************************************************
+
+#include <stdlib.h>
+
+#include "stepAnalysis.h"
+
+
+// Finish the step in progress and fill in its metrics.
+static void completeStep(step_analysis_t* t, step_metrics_t* m)
+{
+    int32_t size = t->target - t->initial;
+
+    m->startTime = t->startTime;
+    m->stepSize = size / STEP_PRECISION;
+    m->riseTime = t->time90 ? t->time90 - t->time10 : 0;
+    m->overshoot = (int64_t)100 * (t->peak - t->target) / size;
+    if (m->overshoot < 0)
+        m->overshoot = 0;
+    m->settlingTime = t->lastOutsideBand;
+    m->steadyStateError = t->inBandCount ? t->inBandErrorSum / (int32_t)t->inBandCount : 0;
+    t->isActive = false;
+}
+
+
+// Drop any step in progress and take target (% or deg) as the starting point, so
+// that the first change of target is the first step.
+void stepAnalysisReset(step_analysis_t* analysis, int32_t target)
+{
+    analysis->isActive = false;
+    analysis->previousTarget = target;
+}
+
+
+// Update the analysis with a target (% or deg) and measurement (scaled by
+// STEP_PRECISION) at time ms. Returns true and fills in metrics when a step has
+// completed.
+bool stepAnalysisUpdate(step_analysis_t* t, int32_t target, int32_t measured, uint32_t time,
+                        step_metrics_t* metrics)
+{
+    bool isComplete = false;
+
+    if (target != t->previousTarget) {
+        // a new step. The previous one is complete even if it never settled.
+        if (t->isActive) {
+            completeStep(t, metrics);
+            isComplete = true;
+        }
+
+        t->previousTarget = target;
+        t->initial = measured;
+        t->target = target * STEP_PRECISION;
+        t->isActive = t->target != t->initial;  // nothing to measure if already there
+        t->startTime = time;
+        t->time10 = 0;
+        t->time90 = 0;
+        t->peak = measured;
+        t->lastOutsideBand = 0;
+        t->inBandErrorSum = 0;
+        t->inBandCount = 0;
+    }
+
+    if (!t->isActive)
+        return isComplete;
+
+    uint32_t elapsed = time - t->startTime;
+    int32_t size = t->target - t->initial;
+    int32_t progress = (int64_t)100 * (measured - t->initial) / size;  // % of the way through the step
+    int32_t error = measured - t->target;
+
+    if (!t->time10 && progress >= 10)
+        t->time10 = elapsed;
+    if (!t->time90 && progress >= 90)
+        t->time90 = elapsed;
+
+    // work in the direction of the step so that a negative step overshoots downwards
+    if ((size > 0 && measured > t->peak) || (size < 0 && measured < t->peak))
+        t->peak = measured;
+
+    if ((int64_t)100 * abs(error) > (int64_t)STEP_SETTLING_BAND * abs(size)) {
+        t->lastOutsideBand = elapsed;
+        t->inBandErrorSum = 0;
+        t->inBandCount = 0;
+    } else {
+        t->inBandErrorSum += error;
+        t->inBandCount++;
+    }
+
+    // a step replaced above has already been reported, and the new one can't be complete yet
+    if (!isComplete && (elapsed - t->lastOutsideBand >= STEP_SETTLING_HOLD_TIME || elapsed >= STEP_TIME_OUT)) {
+        completeStep(t, metrics);
+        isComplete = true;
+    }
+    return isComplete;
+}
@@ -0,0 +1,75 @@
+// ************************************************************
+// stepAnalysis.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Measure the response of one controlled quantity to changes of target.
+// Explaination: Each change of target starts a new step. Rise time (10 % to 90 %),
+// overshoot, settling time and steady state error are calculated as the response
+// happens, using a fixed amount of memory, so the analysis can run for any length of
+// flight. Has no hardware dependencies, so stepResponse.c on the board and the
+// uartLog host tool measure steps the same way.
+// ************************************************************
+
+#ifndef STEP_ANALYSIS_H_
+#define STEP_ANALYSIS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define STEP_PRECISION 1000  // scale of measurements and errors, as PRECISION in control.h
+#define STEP_SETTLING_BAND 5  // % of the step size
+#define STEP_SETTLING_HOLD_TIME 2000  // ms in band before a step is considered complete
+#define STEP_TIME_OUT 15000  // ms, give up on steps which never settle
+
+
+// Metrics of a completed step.
+typedef struct {
+    uint32_t startTime;  // ms, on the clock passed to stepAnalysisUpdate(..)
+    int32_t stepSize;  // % or deg
+    uint32_t riseTime;  // ms from 10 % to 90 % of the step, 0 if never reached
+    int32_t overshoot;  // % of the step size
+    uint32_t settlingTime;  // ms until the response stayed within the settling band
+    int32_t steadyStateError;  // mean error once settled, % or deg scaled by STEP_PRECISION
+} step_metrics_t;
+
+
+// Analysis of the step currently in progress on one quantity.
+typedef struct {
+    bool isActive;
+    int32_t previousTarget;  // % or deg
+    int32_t initial;  // measurement at the start of the step, scaled by STEP_PRECISION
+    int32_t target;  // scaled by STEP_PRECISION
+    uint32_t startTime;
+    uint32_t time10;  // ms since the step started that 10 % was first reached, 0 if not yet
+    uint32_t time90;
+    int32_t peak;  // furthest travel in the direction of the step, scaled by STEP_PRECISION
+    uint32_t lastOutsideBand;  // ms since the step started
+    int32_t inBandErrorSum;  // sum of errors since entering the band
+    uint32_t inBandCount;
+} step_analysis_t;
+
+
+// Drop any step in progress and take target (% or deg) as the starting point, so
+// that the first change of target is the first step.
+void stepAnalysisReset(step_analysis_t* analysis, int32_t target);
+
+
+// Update the analysis with a target (% or deg) and measurement (scaled by
+// STEP_PRECISION) at time ms. Returns true and fills in metrics when a step has
+// completed: after STEP_SETTLING_HOLD_TIME in band, at STEP_TIME_OUT, or when the
+// next step starts.
+bool stepAnalysisUpdate(step_analysis_t* analysis, int32_t target, int32_t measured, uint32_t time,
+                        step_metrics_t* metrics);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STEP_ANALYSIS_H_ */
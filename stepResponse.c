@@ -0,0 +1,69 @@
+// ************************************************************
+// stepResponse.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Measure the step response of the height and yaw controllers while flying.
+// Explaination: Each change of target starts a new step. Rise time (10 % to 90 %),
+// overshoot, settling time and steady state error are calculated by stepAnalysis.c
+// as the response happens. When a step is complete its metrics are reported over
+// UART in text mode.
+// ************************************************************
+
+#include "stepResponse.h"
+#include "control.h"  // for PRECISION
+#include "height.h"
+#include "yaw.h"
+#include "uartDisplay.h"
+#include "telemetry.h"
+
+static step_analysis_t analyses[STEP_NUM_AXES];
+static step_metrics_t results[STEP_NUM_AXES];
+static bool hasResult[STEP_NUM_AXES];
+static uint32_t elapsedTime = 0;  // ms since the task started
+
+
+// Update the analysis of one axis with a new target (not scaled) and measurement
+// (scaled by PRECISION), and report a completed step.
+static void updateAxis(step_axis_t axis, int32_t target, int32_t measured)
+{
+    step_metrics_t* m = &results[axis];
+
+    if (!stepAnalysisUpdate(&analyses[axis], target, measured, elapsedTime, m))
+        return;
+
+    hasResult[axis] = true;
+    if (telemetryIsTextAllowed()) {
+        uartPrintLineWithFormat("%c r%d o%d s%d e%d\n", axis == STEP_HEIGHT ? 'H' : 'Y',
+                                m->riseTime, m->overshoot, m->settlingTime, m->steadyStateError);
+    }
+}
+
+
+// Drop any step in progress and take the current targets as the starting point,
+// so that the first change of target is the first step.
+void stepResponseReset(state_t* state)
+{
+    stepAnalysisReset(&analyses[STEP_HEIGHT], state->targetHeight);
+    stepAnalysisReset(&analyses[STEP_YAW], state->targetYaw);
+}
+
+
+// Task to update the analysis with the latest measurements. Only run while flying.
+void stepResponseUpdate(state_t* state, uint32_t deltaTime)
+{
+    elapsedTime += deltaTime;
+
+    updateAxis(STEP_HEIGHT, state->targetHeight, heightAsPercentage(PRECISION));
+    updateAxis(STEP_YAW, state->targetYaw, yawGetDegrees(PRECISION));
+}
+
+
+// Copy the metrics of the last completed step on an axis into metrics.
+// Returns false if no step has been completed yet.
+bool stepResponseGetMetrics(step_axis_t axis, step_metrics_t* metrics)
+{
+    *metrics = results[axis];
+    return hasResult[axis];
+}
@@ -0,0 +1,50 @@
+// ************************************************************
+// stepResponse.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Measure the step response of the height and yaw controllers while flying.
+// Explaination: Each change of target starts a new step. Rise time (10 % to 90 %),
+// overshoot, settling time and steady state error are calculated by stepAnalysis.c
+// as the response happens. When a step is complete its metrics are reported over
+// UART in text mode.
+// ************************************************************
+
+#ifndef STEP_RESPONSE_H_
+#define STEP_RESPONSE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stateInfo.h"
+#include "stepAnalysis.h"  // for step_metrics_t
+
+
+// The controlled quantities which are analysed.
+typedef enum {
+    STEP_HEIGHT = 0,
+    STEP_YAW,
+
+    // Always equal to the number of axes above
+    STEP_NUM_AXES
+} step_axis_t;
+
+
+// Drop any step in progress and take the current targets as the starting point,
+// so that the first change of target is the first step. Call on entering
+// STATE_FLYING, as the targets are ramped by the sequences in the other modes,
+// which are not steps.
+void stepResponseReset(state_t* state);
+
+
+// Task to update the analysis with the latest measurements. Only run while flying.
+void stepResponseUpdate(state_t* state, uint32_t deltaTime);
+
+
+// Copy the metrics of the last completed step on an axis into metrics.
+// Returns false if no step has been completed yet.
+bool stepResponseGetMetrics(step_axis_t axis, step_metrics_t* metrics);
+
+
+#endif /* STEP_RESPONSE_H_ */
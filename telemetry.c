@@ -0,0 +1,98 @@
+// ************************************************************
+// telemetry.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Send the helicopter state over UART as compact binary packets.
+// Explaination: The packets are built by telemetryPacket.c. This file picks
+// what the UART carries, queues packets whole and counts what was sent.
+// ************************************************************
+
+#include "telemetry.h"
+#include "height.h"
+#include "yaw.h"
+#include "uartDisplay.h"
+#include "trace.h"
+
+static telemetry_mode_t mode = TELEMETRY_TEXT;
+static telemetry_stats_t sendStats;
+static telemetry_encoder_t encoder = {.packetsSinceKeyFrame = TELEMETRY_KEY_FRAME_INTERVAL};  // start with a key frame
+
+
+// Add a CRC to length bytes of data, COBS frame it and queue it on the UART. The
+// packet is sent whole or not at all. Returns false if the UART queue was too full.
+bool telemetrySendPacket(const uint8_t* data, uint32_t length)
+{
+    uint8_t framed[TELEMETRY_MAX_FRAMED_LENGTH];
+    uint32_t framedLength = telemetryFrame(data, length, framed);
+
+    if (framedLength == 0 || uartTxSpace() < framedLength || !uartSendBytes(framed, framedLength)) {
+        sendStats.packetsSkipped++;
+        return false;
+    }
+    sendStats.packetsSent++;
+    sendStats.bytesSent += framedLength;
+    return true;
+}
+
+
+// Set whether the UART carries text or binary telemetry.
+void telemetrySetMode(telemetry_mode_t newMode)
+{
+    if (newMode == TELEMETRY_BINARY && mode != TELEMETRY_BINARY) {
+        // the decoder may have missed anything sent before, so start again from a key frame
+        telemetryEncoderReset(&encoder);
+    }
+    mode = newMode;
+}
+
+
+// Return the current telemetry mode.
+telemetry_mode_t telemetryGetMode(void)
+{
+    return mode;
+}
+
+
+// Return true when text may be sent over UART: in text mode and while the
+// trace isn't being dumped, so no text lands in the middle of a binary stream
+// or a trace dump.
+bool telemetryIsTextAllowed(void)
+{
+    return mode == TELEMETRY_TEXT && !traceIsDumping();
+}
+
+
+// Copy the binary telemetry statistics into stats.
+void telemetryGetStats(telemetry_stats_t* stats)
+{
+    *stats = sendStats;
+}
+
+
+// Task to send one binary packet of the current state. Does nothing in text mode.
+// If the UART cannot take the whole packet, the packet is skipped and the next
+// one carries the accumulated changes.
+void telemetryUpdate(state_t* state, uint32_t deltaTime)
+{
+    uint8_t raw[TELEMETRY_MAX_PACKET_LENGTH];
+    int32_t fields[TELEMETRY_NUM_FIELDS];
+
+    if (mode != TELEMETRY_BINARY) {
+        return;
+    }
+
+    fields[TELEMETRY_FIELD_MODE] = state->heliMode;
+    fields[TELEMETRY_FIELD_TARGET_HEIGHT] = state->targetHeight;
+    fields[TELEMETRY_FIELD_HEIGHT] = heightAsPercentage(TELEMETRY_PRECISION);
+    fields[TELEMETRY_FIELD_TARGET_YAW] = state->targetYaw;
+    fields[TELEMETRY_FIELD_YAW] = yawGetDegrees(TELEMETRY_PRECISION);
+    fields[TELEMETRY_FIELD_MAIN_DUTY] = state->outputMainDuty;
+    fields[TELEMETRY_FIELD_TAIL_DUTY] = state->outputTailDuty;
+
+    // only commit to the new values once the decoder is sure to receive them
+    if (telemetrySendPacket(raw, telemetryEncodeState(&encoder, fields, raw))) {
+        telemetryEncoderCommit(&encoder, fields);
+    }
+}
@@ -0,0 +1,71 @@
+// ************************************************************
+// telemetry.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Send the helicopter state over UART as compact binary packets.
+// Explaination: Each packet holds the mode, targets, measurements and duty
+// cycles of the helicopter, see telemetryPacket.h for the layout. Packets are
+// built by telemetryPacket.c and queued whole on the UART. tools/ has a host
+// decoder for the packets.
+// ************************************************************
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stateInfo.h"
+#include "telemetryPacket.h"
+
+
+// Selects what is sent over the UART. The text mode is the human readable
+// output from the display task. The record mode sends the raw sensor
+// recording, see recorder.h.
+typedef enum {
+    TELEMETRY_TEXT = 0,
+    TELEMETRY_BINARY,
+    TELEMETRY_RECORD
+} telemetry_mode_t;
+
+
+// Statistics for the binary telemetry.
+typedef struct {
+    uint32_t packetsSent;
+    uint32_t packetsSkipped;  // not sent because the UART queue was too full
+    uint32_t bytesSent;  // including framing
+} telemetry_stats_t;
+
+
+// Set whether the UART carries text or binary telemetry.
+void telemetrySetMode(telemetry_mode_t newMode);
+
+
+// Return the current telemetry mode.
+telemetry_mode_t telemetryGetMode(void);
+
+
+// Return true when text may be sent over UART: in text mode and while the
+// trace isn't being dumped, so no text lands in the middle of a binary stream
+// or a trace dump.
+bool telemetryIsTextAllowed(void);
+
+
+// Copy the binary telemetry statistics into stats.
+void telemetryGetStats(telemetry_stats_t* stats);
+
+
+// Add a CRC to length bytes of data, COBS frame it and queue it on the UART. The
+// packet is sent whole or not at all. Returns false if the UART queue was too full.
+bool telemetrySendPacket(const uint8_t* data, uint32_t length);
+
+
+// Task to send one binary packet of the current state. Does nothing in text mode.
+// If the UART cannot take the whole packet, the packet is skipped and the next
+// one carries the accumulated changes.
+void telemetryUpdate(state_t* state, uint32_t deltaTime);
+
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,155 @@
+// ************************************************************
+// telemetryPacket.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Build and frame the binary telemetry packets.
+// Explaination: Key frames carry absolute values and delta frames carry only
+// the fields which changed since the last packet sent, as zigzag varints.
+// Packets end in a CRC-16 (CCITT) and are COBS framed so that every packet is
+// terminated by the only zero byte in it.
+// ************************************************************
+
+#include <string.h>
+
+#include "telemetryPacket.h"
+
+#define TELEMETRY_MAX_RAW_LENGTH (TELEMETRY_MAX_PACKET_LENGTH + 2)  // with the crc
+#define CRC_INITIAL 0xFFFF
+#define CRC_POLYNOMIAL 0x1021
+
+
+// Start again from a key frame, for when the decoder may have missed packets.
+void telemetryEncoderReset(telemetry_encoder_t* encoder)
+{
+    encoder->packetsSinceKeyFrame = TELEMETRY_KEY_FRAME_INTERVAL;
+}
+
+
+// Build a state packet of fields into out, which must have room for
+// TELEMETRY_MAX_PACKET_LENGTH bytes. Returns the length. The encoder is not
+// changed until telemetryEncoderCommit(..), so an unsent packet can be dropped.
+uint32_t telemetryEncodeState(const telemetry_encoder_t* encoder, const int32_t* fields, uint8_t* out)
+{
+    uint32_t length = 0;
+    int i;
+
+    bool isKeyFrame = encoder->packetsSinceKeyFrame >= TELEMETRY_KEY_FRAME_INTERVAL;
+    out[length++] = isKeyFrame ? TELEMETRY_KEY_FRAME : TELEMETRY_DELTA_FRAME;
+    out[length++] = encoder->sequence;
+
+    if (isKeyFrame) {
+        for (i = 0; i < TELEMETRY_NUM_FIELDS; i++) {
+            length += telemetryWriteVarint(&out[length], fields[i]);
+        }
+    } else {
+        // a mask of the fields which changed, followed by the change in each of them
+        uint32_t maskIndex = length++;
+        out[maskIndex] = 0;
+        for (i = 0; i < TELEMETRY_NUM_FIELDS; i++) {
+            if (fields[i] != encoder->lastSent[i]) {
+                out[maskIndex] |= 1 << i;
+                length += telemetryWriteVarint(&out[length], fields[i] - encoder->lastSent[i]);
+            }
+        }
+    }
+    return length;
+}
+
+
+// Record that the packet built from fields was sent.
+void telemetryEncoderCommit(telemetry_encoder_t* encoder, const int32_t* fields)
+{
+    int i;
+
+    for (i = 0; i < TELEMETRY_NUM_FIELDS; i++) {
+        encoder->lastSent[i] = fields[i];
+    }
+    bool wasKeyFrame = encoder->packetsSinceKeyFrame >= TELEMETRY_KEY_FRAME_INTERVAL;
+    encoder->packetsSinceKeyFrame = wasKeyFrame ? 1 : encoder->packetsSinceKeyFrame + 1;
+    encoder->sequence++;
+}
+
+
+// Write n as a zigzag encoded varint so that small negative numbers are also short.
+// Returns the number of bytes written (at most 5).
+uint32_t telemetryWriteVarint(uint8_t* out, int32_t n)
+{
+    uint32_t zigzag = ((uint32_t)n << 1) ^ (uint32_t)(n >> 31);
+    uint32_t length = 0;
+
+    while (zigzag >= 0x80) {
+        out[length++] = (zigzag & 0x7F) | 0x80;
+        zigzag >>= 7;
+    }
+    out[length++] = zigzag;
+    return length;
+}
+
+
+// CRC-16 (CCITT) over length bytes of data.
+static uint16_t crc16(const uint8_t* data, uint32_t length)
+{
+    uint16_t crc = CRC_INITIAL;
+    uint32_t i;
+    int bit;
+
+    for (i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ CRC_POLYNOMIAL : crc << 1;
+        }
+    }
+    return crc;
+}
+
+
+// Consistent overhead byte stuffing. Encode length bytes of data into out so that it
+// contains no zero bytes, then append the zero delimiter. Returns the framed length.
+static uint32_t cobsEncode(const uint8_t* data, uint32_t length, uint8_t* out)
+{
+    uint32_t codeIndex = 0;  // where the length code of the current block goes
+    uint32_t outIndex = 1;
+    uint8_t code = 1;
+    uint32_t i;
+
+    for (i = 0; i < length; i++) {
+        if (data[i] == 0) {
+            out[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        } else {
+            out[outIndex++] = data[i];
+            code++;
+            if (code == 0xFF) {
+                out[codeIndex] = code;
+                codeIndex = outIndex++;
+                code = 1;
+            }
+        }
+    }
+    out[codeIndex] = code;
+    out[outIndex++] = 0;
+    return outIndex;
+}
+
+
+// Add a CRC-16 (CCITT) to length bytes of data and COBS frame it into out, which
+// must have room for TELEMETRY_MAX_FRAMED_LENGTH bytes. Returns the framed length,
+// or 0 if the packet is longer than TELEMETRY_MAX_PACKET_LENGTH.
+uint32_t telemetryFrame(const uint8_t* data, uint32_t length, uint8_t* out)
+{
+    uint8_t raw[TELEMETRY_MAX_RAW_LENGTH];
+
+    if (length > TELEMETRY_MAX_PACKET_LENGTH) {
+        return 0;
+    }
+    memcpy(raw, data, length);
+
+    uint16_t crc = crc16(raw, length);
+    raw[length++] = crc >> 8;
+    raw[length++] = crc & 0xFF;
+
+    return cobsEncode(raw, length, out);
+}
@@ -0,0 +1,89 @@
+// ************************************************************
+// telemetryPacket.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Build and frame the binary telemetry packets.
+// Explaination: The encoding is kept apart from telemetry.c, with no hardware
+// or TivaWare dependencies, so that the host decoder in tools/ can be checked
+// against the same code as the firmware runs.
+//
+// Packet layout before framing:
+//   [type] [sequence] [field mask, delta frames only] [varint fields...] [crc hi] [crc lo]
+// Fields in telemetry_field_t order: mode, target height (%), height (% * 10),
+// target yaw (deg), yaw (deg * 10), main duty (%), tail duty (%).
+// ************************************************************
+
+#ifndef TELEMETRYPACKET_H_
+#define TELEMETRYPACKET_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define TELEMETRY_PRECISION 10  // scale of the measured height and yaw fields
+#define TELEMETRY_KEY_FRAME 'K'
+#define TELEMETRY_DELTA_FRAME 'D'
+#define TELEMETRY_KEY_FRAME_INTERVAL 50  // packets between key frames, so a decoder can resync
+#define TELEMETRY_MAX_PACKET_LENGTH 128  // bytes in a packet before the CRC and framing
+#define TELEMETRY_MAX_FRAMED_LENGTH (TELEMETRY_MAX_PACKET_LENGTH + 4)  // CRC, COBS overhead and delimiter
+#define TELEMETRY_MAX_VARINT_LENGTH 5
+
+
+// The fields of a state packet.
+typedef enum {
+    TELEMETRY_FIELD_MODE = 0,
+    TELEMETRY_FIELD_TARGET_HEIGHT,
+    TELEMETRY_FIELD_HEIGHT,
+    TELEMETRY_FIELD_TARGET_YAW,
+    TELEMETRY_FIELD_YAW,
+    TELEMETRY_FIELD_MAIN_DUTY,
+    TELEMETRY_FIELD_TAIL_DUTY,
+
+    // Always equal to the number of fields above
+    TELEMETRY_NUM_FIELDS
+} telemetry_field_t;
+
+
+// What the decoder is known to hold, so that delta frames can be built.
+typedef struct {
+    int32_t lastSent[TELEMETRY_NUM_FIELDS];
+    uint32_t packetsSinceKeyFrame;
+    uint8_t sequence;
+} telemetry_encoder_t;
+
+
+// Start again from a key frame, for when the decoder may have missed packets.
+void telemetryEncoderReset(telemetry_encoder_t* encoder);
+
+
+// Build a state packet of fields into out, which must have room for
+// TELEMETRY_MAX_PACKET_LENGTH bytes. Returns the length. The encoder is not
+// changed until telemetryEncoderCommit(..), so an unsent packet can be dropped.
+uint32_t telemetryEncodeState(const telemetry_encoder_t* encoder, const int32_t* fields, uint8_t* out);
+
+
+// Record that the packet built from fields was sent.
+void telemetryEncoderCommit(telemetry_encoder_t* encoder, const int32_t* fields);
+
+
+// Write n as a zigzag encoded varint so that small negative numbers are also short.
+// Returns the number of bytes written (at most 5).
+uint32_t telemetryWriteVarint(uint8_t* out, int32_t n);
+
+
+// Add a CRC-16 (CCITT) to length bytes of data and COBS frame it into out, which
+// must have room for TELEMETRY_MAX_FRAMED_LENGTH bytes. Returns the framed length,
+// or 0 if the packet is longer than TELEMETRY_MAX_PACKET_LENGTH.
+uint32_t telemetryFrame(const uint8_t* data, uint32_t length, uint8_t* out);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRYPACKET_H_ */
@@ -10,13 +10,8 @@
 
 
 #include "timerer.h"
-#include "driverlib/timer.h"
+#include "hal.h"
 
-#define TIMERER_PERIPH SYSCTL_PERIPH_WTIMER5
-#define TIMERER_BASE WTIMER5_BASE
-#define TIMERER_INTERAL TIMER_A
-#define TIMERER_MODE TIMER_CFG_A_PERIODIC
-#define TIMERER_MAX_TICKS INT32_MAX  // 32 bits for Timer0 A
 #define TIMERER_OVERSHOOT_TICKS (TIMERER_MAX_TICKS / 2)
 
 static uint32_t clockRate;
@@ -26,25 +21,43 @@ static uint32_t ticksPerMs;
 // enable the hardware timer and calculate clock parameters
 void timererInit(void)
 {
-    clockRate = SysCtlClockGet();
+    clockRate = halClockGet();
     ticksPerMs = clockRate / 1000;  // 1000 ms = 1 s
 
-    SysCtlPeripheralReset(TIMERER_PERIPH);  // reset for good measure
-
-    // timer counts down by default
-    // config to reset to max value
-    SysCtlPeripheralEnable(TIMERER_PERIPH);
-    TimerDisable(TIMERER_BASE, TIMERER_INTERAL);
-    TimerConfigure(TIMERER_BASE, TIMERER_MODE);
-    TimerLoadSet(TIMERER_BASE, TIMERER_INTERAL, TIMERER_MAX_TICKS);
-    TimerEnable(TIMERER_BASE, TIMERER_INTERAL);
+    // timer counts down, config to reset to max value
+    halTimerInit(TIMERER_MAX_TICKS);
 }
 
 
 // return the current timer value in ticks.
 uint32_t timererGetTicks(void)
 {
-    return TimerValueGet(TIMERER_BASE, TIMERER_INTERAL);
+    return halTimerGet();
+}
+
+
+// return the number of ticks which have passed since reference.
+// Correct across the timer reloading, for intervals up to one timer period.
+uint32_t timererTicksSince(uint32_t reference)
+{
+    return timererTicksBetween(reference, timererGetTicks());
+}
+
+
+// return the number of ticks from the timer value earlier to the value later.
+// Correct across the timer reloading, for intervals up to one timer period.
+uint32_t timererTicksBetween(uint32_t earlier, uint32_t later)
+{
+    // the timer counts down from TIMERER_MAX_TICKS through 0 so its period is 2^31 ticks,
+    // hence the difference is taken modulo 2^31
+    return (earlier - later) & TIMERER_MAX_TICKS;
+}
+
+
+// convert milliseconds to timer ticks.
+uint32_t timererMsToTicks(uint32_t milliseconds)
+{
+    return milliseconds * ticksPerMs;
 }
 
 
@@ -72,9 +85,16 @@ bool timererBeen(uint32_t milliseconds, uint32_t reference)
 // useful for keeping time in a loop with many operations.
 void timererWaitFrom(uint32_t milliseconds, uint32_t reference)
 {
+    uint32_t ticks = timererMsToTicks(milliseconds);
+    uint32_t passed;
+
     while (true) {
 
         // block until we pass the target time
         if (timererBeen(milliseconds, reference)) return;
+
+        // let a host build skip the rest of the wait, see halTimerIdle(..)
+        passed = timererTicksSince(reference);
+        halTimerIdle(passed < ticks ? ticks - passed : 0);
     }
 }
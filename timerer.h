@@ -14,9 +14,11 @@
 #include <stdbool.h>
 #include "stdlib.h"
 
-#include "inc/hw_memmap.h"  // for TIMER0_BASE etc
-#include "driverlib/sysctl.h"
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
 
+#define TIMERER_MAX_TICKS INT32_MAX  // 32 bits for wide timer 5 A, which starts here and counts down
 
 // enable the hardware timer and calculate clock parameters
 void timererInit(void);
@@ -26,6 +28,20 @@ void timererInit(void);
 uint32_t timererGetTicks(void);
 
 
+// return the number of ticks which have passed since reference.
+// Correct across the timer reloading, for intervals up to one timer period.
+uint32_t timererTicksSince(uint32_t reference);
+
+
+// return the number of ticks from the timer value earlier to the value later.
+// Correct across the timer reloading, for intervals up to one timer period.
+uint32_t timererTicksBetween(uint32_t earlier, uint32_t later);
+
+
+// convert milliseconds to timer ticks.
+uint32_t timererMsToTicks(uint32_t milliseconds);
+
+
 // waits for some given milliseconds.
 void timererWait(uint32_t milliseconds);
 
@@ -38,4 +54,8 @@ bool timererBeen(uint32_t milliseconds, uint32_t reference);
 // useful for keeping time in a loop with many operations.
 void timererWaitFrom(uint32_t milliseconds, uint32_t reference);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* TIMERER_H_ */
@@ -0,0 +1,381 @@
+// ************************************************************
+// batchEngine.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Fly many simulated rigs at once, as fast as the host can.
+// Explaination: See batchEngine.h. The plant and the filter are written once, as
+// inline functions on one rig's values, which both engines call. The scalar
+// engine runs the PID stage with pidUpdate(..) from the firmware, and the batch
+// engine with batchPid(..), the same arithmetic written so that the loop over
+// the rigs vectorises. Rates and positions are held in "fine" units, STEPS times
+// the unit per second, so that each step adds the whole rate on and nothing is
+// lost to truncation. Built with -O3 for the host's SIMD instructions (see the
+// Makefile).
+// ************************************************************
+
+#include "batchEngine.h"
+
+#include <cmath>
+
+#include "../pid.h"
+
+#define STEPS BATCH_STEPS_PER_SECOND
+#define MS_TO_SEC 1000  // as pid.c
+#define MEAN_RANGE (4095 * 8 / 33)  // as height.c
+#define CONV_UNIFORM_MULTIPLIER 100  // as height.c
+#define CONV_BASE (CONV_SIZE * CONV_UNIFORM_MULTIPLIER)
+#define ADC_MAX 4095
+#define HEIGHT_TOP (100 * PRECISION)  // top of the stand
+// The model stops the heli this far either way of where it started. Further out
+// the firmware's yaw integral overflows int32_t, with the default gains.
+#define YAW_STOP (270 * PRECISION)
+#define NOISE_SHIFT 29  // noise is the top 3 bits of the generator, -4 to 3 counts
+#define HASH_MULTIPLIER 31u
+
+
+static int32_t toFixed(double value, int shift)
+{
+    return (int32_t)std::lround(std::ldexp(value, shift));
+}
+
+
+BatchParams batchParams(const RigParams& params, uint32_t noiseSeed)
+{
+    BatchParams p;
+    double step = BATCH_STEP_US / 1e6;
+
+    p.mainLagQ16 = toFixed(step / params.mainLag, 16);
+    p.tailLagQ16 = toFixed(step / params.tailLag, 16);
+    p.hover = (int32_t)std::lround(params.hoverDuty * PRECISION);
+    p.gravQ16 = toFixed(params.gravSlope, 16);
+    p.liftQ8 = toFixed(params.lift, 8);
+    p.heightDragQ8 = toFixed(params.heightDrag, 8);
+    p.yawThrustQ8 = toFixed(params.yawThrust, 8);
+    p.torqueQ12 = toFixed(params.torqueRatio, 12);
+    p.yawDragQ8 = toFixed(params.yawDrag, 8);
+    p.adcLanded = (int32_t)std::lround(params.adcLanded);
+    p.adcRangeQ20 = toFixed(params.adcRange / (100 * PRECISION), 20);
+    p.noiseSeed = noiseSeed;
+    return p;
+}
+
+
+BatchFlight batchDefaultFlight(int32_t targetHeight, int32_t targetYaw)
+{
+    // control.c's starting gains and params
+    BatchFlight flight = {targetHeight, targetYaw, {1500, 600, 400}, {1200, 800, 500}, 33, 200, 800};
+    return flight;
+}
+
+
+///
+/// The plant and filter, shared by both engines.
+///
+
+
+static inline int32_t clampInt(int32_t n, int32_t lower, int32_t upper)
+{
+    return n < lower ? lower : n > upper ? upper : n;
+}
+
+
+// Move a rotor's speed towards its duty cycle, both in % scaled by PRECISION.
+static inline int32_t lagRotor(int32_t speed, int32_t duty, int32_t lagQ16)
+{
+    return speed + (((duty - speed) * lagQ16) >> 16);
+}
+
+
+// Step the height on, held between landed and the top of the stand.
+static inline void moveHeight(int32_t mainSpeed, int32_t hover, int32_t gravQ16, int32_t liftQ8, int32_t dragQ8,
+                              int32_t& heightFine, int32_t& climbFine)
+{
+    int32_t force = mainSpeed - hover - (((heightFine / STEPS) * gravQ16) >> 16);
+    int32_t acceleration = ((force * liftQ8) >> 8) - (((climbFine / STEPS) * dragQ8) >> 8);
+
+    climbFine += acceleration;
+    heightFine += climbFine / STEPS;
+    bool isStopped = heightFine < 0 || heightFine > HEIGHT_TOP * STEPS;
+    heightFine = clampInt(heightFine, 0, HEIGHT_TOP * STEPS);
+    climbFine = isStopped ? 0 : climbFine;
+}
+
+
+// Step the yaw on, turned clockwise by the tail rotor against the main rotor's torque.
+static inline void moveYaw(int32_t mainSpeed, int32_t tailSpeed, int32_t thrustQ8, int32_t torqueQ12, int32_t dragQ8,
+                           int32_t& yawFine, int32_t& yawRateFine)
+{
+    int32_t force = tailSpeed - ((mainSpeed * torqueQ12) >> 12);
+    int32_t acceleration = ((force * thrustQ8) >> 8) - (((yawRateFine / STEPS) * dragQ8) >> 8);
+
+    yawRateFine += acceleration;
+    yawFine += yawRateFine / STEPS;
+    bool isStopped = yawFine < -YAW_STOP * STEPS || yawFine > YAW_STOP * STEPS;
+    yawFine = clampInt(yawFine, -YAW_STOP * STEPS, YAW_STOP * STEPS);
+    yawRateFine = isStopped ? 0 : yawRateFine;
+}
+
+
+// Return a new ADC sample at this height, with noise from the rig's generator.
+static inline int32_t sampleAdc(int32_t heightFine, int32_t adcLanded, int32_t adcRangeQ20, uint32_t& noiseState)
+{
+    noiseState = noiseState * 1664525u + 1013904223u;
+    int32_t noise = (int32_t)(noiseState >> NOISE_SHIFT) - 4;
+    int32_t adc = adcLanded - (((heightFine / STEPS) * adcRangeQ20) >> 20) + noise;
+    return clampInt(adc, 0, ADC_MAX);
+}
+
+
+// Return the height the firmware reads from the samples' sum, as heightAsPercentage(PRECISION).
+static inline int32_t filteredHeight(int32_t adcSum, int32_t baseMean)
+{
+    int32_t meanHeight = adcSum * CONV_UNIFORM_MULTIPLIER / CONV_BASE;
+    return 100 * PRECISION * (baseMean - meanHeight) / MEAN_RANGE;
+}
+
+
+// Return the yaw the firmware reads, as yawGetDegrees(PRECISION), from the encoder's count.
+static inline int32_t encoderYaw(int32_t yawFine, int32_t countsPerRotation)
+{
+    int32_t count = yawFine / STEPS * countsPerRotation / (360 * PRECISION);
+    return count * (PRECISION * 360) / countsPerRotation;
+}
+
+
+static inline uint32_t hashDuty(uint32_t hash, int32_t duty)
+{
+    return hash * HASH_MULTIPLIER + (uint32_t)duty;
+}
+
+
+///
+/// ScalarRig
+///
+
+
+ScalarRig::ScalarRig(const BatchParams& params, const BatchFlight& flight)
+    : p(params), flight(flight), steps(0), height(0), climbRate(0), yaw(0), yawRate(0), mainSpeed(0), tailSpeed(0),
+      sampleIndex(0), adcSum(params.adcLanded * CONV_SIZE), baseMean(params.adcLanded), noiseState(params.noiseSeed),
+      previousHeight(0), previousYaw(0), heightIntegral(0), yawIntegral(0), mainDuty(0), tailDuty(0),
+      outputMainDuty(0), dutyHash(0)
+{
+    for (int32_t& sample : samples) {
+        sample = params.adcLanded;
+    }
+}
+
+
+void ScalarRig::step(void)
+{
+    mainSpeed = lagRotor(mainSpeed, mainDuty, p.mainLagQ16);
+    tailSpeed = lagRotor(tailSpeed, tailDuty, p.tailLagQ16);
+    moveHeight(mainSpeed, p.hover, p.gravQ16, p.liftQ8, p.heightDragQ8, height, climbRate);
+    moveYaw(mainSpeed, tailSpeed, p.yawThrustQ8, p.torqueQ12, p.yawDragQ8, yaw, yawRate);
+    steps++;
+
+    if (steps % BATCH_ADC_STEPS == 0) {
+        int32_t adc = sampleAdc(height, p.adcLanded, p.adcRangeQ20, noiseState);
+        adcSum += adc - samples[sampleIndex];
+        samples[sampleIndex] = adc;
+        sampleIndex = (sampleIndex + 1) % CONV_SIZE;
+    }
+
+    if (steps % BATCH_CONTROL_STEPS == 0) {
+        // as controlUpdate(..), with the height and yaw channels enabled
+        int32_t sensedHeight = filteredHeight(adcSum, baseMean);
+        int32_t verticalVelocity = (sensedHeight - previousHeight) * PRECISION / BATCH_CONTROL_MS;
+        previousHeight = sensedHeight;
+        int32_t sensedYaw = encoderYaw(yaw, BATCH_COUNTS_PER_ROTATION);
+        int32_t angularVelocity = (sensedYaw - previousYaw) * PRECISION / BATCH_CONTROL_MS;
+        previousYaw = sensedYaw;
+
+        int32_t mainOutput = flight.mainOffset * PRECISION + sensedHeight * flight.gravOffset / PRECISION;
+        mainOutput += pidUpdate(flight.mainGains, &heightIntegral, flight.targetHeight - sensedHeight,
+                                -verticalVelocity, BATCH_CONTROL_MS);
+        int32_t tailOutput = flight.torqueConst * outputMainDuty;
+        tailOutput += pidUpdate(flight.tailGains, &yawIntegral, flight.targetYaw - sensedYaw,
+                                -angularVelocity, BATCH_CONTROL_MS);
+
+        mainDuty = clampInt(mainOutput, CONTROL_MIN_DUTY * PRECISION, CONTROL_MAX_DUTY * PRECISION);
+        tailDuty = clampInt(tailOutput, CONTROL_MIN_DUTY * PRECISION, CONTROL_MAX_DUTY * PRECISION);
+        outputMainDuty = mainDuty / PRECISION;
+        dutyHash = hashDuty(hashDuty(dutyHash, mainDuty), tailDuty);
+    }
+}
+
+
+BatchResult ScalarRig::result(void) const
+{
+    BatchResult r = {height, climbRate, yaw, yawRate, mainSpeed, tailSpeed, adcSum, previousHeight, previousYaw,
+                     heightIntegral, yawIntegral, mainDuty, tailDuty, dutyHash};
+    return r;
+}
+
+
+///
+/// RigBatch
+///
+
+
+// pidUpdate(..) from pid.c, on values rather than pointers so the loop over the rigs vectorises.
+static inline int32_t batchPid(int32_t kp, int32_t kd, int32_t ki, int32_t& integral, int32_t error,
+                               int32_t errorRate, int32_t deltaTime)
+{
+    int32_t prop = kp * error / PRECISION;
+    int32_t deri = kd * errorRate / PRECISION;
+
+    integral += ki * deltaTime * error / MS_TO_SEC / PRECISION;
+    integral = clampInt(integral, -PID_INTEGRAL_LIMIT, PID_INTEGRAL_LIMIT);
+    return prop + deri + integral;
+}
+
+
+RigBatch::RigBatch(const std::vector<BatchParams>& params, const BatchFlight& flight)
+    : n(params.size()), flight(flight), steps(0), sampleIndex(0),
+      mainLagQ16(n), tailLagQ16(n), hover(n), gravQ16(n), liftQ8(n), heightDragQ8(n),
+      yawThrustQ8(n), torqueQ12(n), yawDragQ8(n), adcLanded(n), adcRangeQ20(n),
+      height(n), climbRate(n), yaw(n), yawRate(n), mainSpeed(n), tailSpeed(n),
+      samples(n * CONV_SIZE), adcSum(n), baseMean(n), noiseState(n),
+      previousHeight(n), previousYaw(n), heightIntegral(n), yawIntegral(n),
+      mainDuty(n), tailDuty(n), outputMainDuty(n), dutyHash(n)
+{
+    for (size_t rig = 0; rig < n; rig++) {
+        const BatchParams& p = params[rig];
+        mainLagQ16[rig] = p.mainLagQ16;
+        tailLagQ16[rig] = p.tailLagQ16;
+        hover[rig] = p.hover;
+        gravQ16[rig] = p.gravQ16;
+        liftQ8[rig] = p.liftQ8;
+        heightDragQ8[rig] = p.heightDragQ8;
+        yawThrustQ8[rig] = p.yawThrustQ8;
+        torqueQ12[rig] = p.torqueQ12;
+        yawDragQ8[rig] = p.yawDragQ8;
+        adcLanded[rig] = p.adcLanded;
+        adcRangeQ20[rig] = p.adcRangeQ20;
+        noiseState[rig] = p.noiseSeed;
+        adcSum[rig] = p.adcLanded * CONV_SIZE;
+        baseMean[rig] = p.adcLanded;
+        for (size_t i = 0; i < CONV_SIZE; i++) {
+            samples[i * n + rig] = p.adcLanded;
+        }
+    }
+}
+
+
+void RigBatch::stepPlant(void)
+{
+    int32_t* __restrict mainS = mainSpeed.data();
+    int32_t* __restrict tailS = tailSpeed.data();
+    int32_t* __restrict h = height.data();
+    int32_t* __restrict climb = climbRate.data();
+    int32_t* __restrict y = yaw.data();
+    int32_t* __restrict rate = yawRate.data();
+    const int32_t* __restrict mainD = mainDuty.data();
+    const int32_t* __restrict tailD = tailDuty.data();
+
+    // the rigs' arrays never overlap
+#pragma GCC ivdep
+    for (size_t i = 0; i < n; i++) {
+        int32_t main = lagRotor(mainS[i], mainD[i], mainLagQ16[i]);
+        int32_t tail = lagRotor(tailS[i], tailD[i], tailLagQ16[i]);
+        int32_t heightFine = h[i], climbFine = climb[i];
+        int32_t yawFine = y[i], yawRateFine = rate[i];
+
+        moveHeight(main, hover[i], gravQ16[i], liftQ8[i], heightDragQ8[i], heightFine, climbFine);
+        moveYaw(main, tail, yawThrustQ8[i], torqueQ12[i], yawDragQ8[i], yawFine, yawRateFine);
+        mainS[i] = main;
+        tailS[i] = tail;
+        h[i] = heightFine;
+        climb[i] = climbFine;
+        y[i] = yawFine;
+        rate[i] = yawRateFine;
+    }
+}
+
+
+void RigBatch::sample(void)
+{
+    int32_t* __restrict oldest = samples.data() + sampleIndex * n;
+    int32_t* __restrict sum = adcSum.data();
+    uint32_t* __restrict noise = noiseState.data();
+    const int32_t* __restrict h = height.data();
+
+#pragma GCC ivdep
+    for (size_t i = 0; i < n; i++) {
+        uint32_t state = noise[i];
+        int32_t adc = sampleAdc(h[i], adcLanded[i], adcRangeQ20[i], state);
+        noise[i] = state;
+        sum[i] += adc - oldest[i];
+        oldest[i] = adc;
+    }
+    sampleIndex = (sampleIndex + 1) % CONV_SIZE;
+}
+
+
+void RigBatch::control(void)
+{
+    const int32_t* __restrict sum = adcSum.data();
+    const int32_t* __restrict y = yaw.data();
+    int32_t* __restrict prevHeight = previousHeight.data();
+    int32_t* __restrict prevYaw = previousYaw.data();
+    int32_t* __restrict inteH = heightIntegral.data();
+    int32_t* __restrict inteY = yawIntegral.data();
+    int32_t* __restrict mainD = mainDuty.data();
+    int32_t* __restrict tailD = tailDuty.data();
+    int32_t* __restrict outputMain = outputMainDuty.data();
+    uint32_t* __restrict hash = dutyHash.data();
+    const BatchFlight f = flight;
+
+#pragma GCC ivdep
+    for (size_t i = 0; i < n; i++) {
+        int32_t sensedHeight = filteredHeight(sum[i], baseMean[i]);
+        int32_t verticalVelocity = (sensedHeight - prevHeight[i]) * PRECISION / BATCH_CONTROL_MS;
+        prevHeight[i] = sensedHeight;
+        int32_t sensedYaw = encoderYaw(y[i], BATCH_COUNTS_PER_ROTATION);
+        int32_t angularVelocity = (sensedYaw - prevYaw[i]) * PRECISION / BATCH_CONTROL_MS;
+        prevYaw[i] = sensedYaw;
+
+        int32_t integral = inteH[i];
+        int32_t mainOutput = f.mainOffset * PRECISION + sensedHeight * f.gravOffset / PRECISION;
+        mainOutput += batchPid(f.mainGains[CONTROL_KP], f.mainGains[CONTROL_KD], f.mainGains[CONTROL_KI], integral,
+                               f.targetHeight - sensedHeight, -verticalVelocity, BATCH_CONTROL_MS);
+        inteH[i] = integral;
+
+        integral = inteY[i];
+        int32_t tailOutput = f.torqueConst * outputMain[i];
+        tailOutput += batchPid(f.tailGains[CONTROL_KP], f.tailGains[CONTROL_KD], f.tailGains[CONTROL_KI], integral,
+                               f.targetYaw - sensedYaw, -angularVelocity, BATCH_CONTROL_MS);
+        inteY[i] = integral;
+
+        int32_t main = clampInt(mainOutput, CONTROL_MIN_DUTY * PRECISION, CONTROL_MAX_DUTY * PRECISION);
+        int32_t tail = clampInt(tailOutput, CONTROL_MIN_DUTY * PRECISION, CONTROL_MAX_DUTY * PRECISION);
+        mainD[i] = main;
+        tailD[i] = tail;
+        outputMain[i] = main / PRECISION;
+        hash[i] = hashDuty(hashDuty(hash[i], main), tail);
+    }
+}
+
+
+void RigBatch::step(void)
+{
+    stepPlant();
+    steps++;
+    if (steps % BATCH_ADC_STEPS == 0) {
+        sample();
+    }
+    if (steps % BATCH_CONTROL_STEPS == 0) {
+        control();
+    }
+}
+
+
+BatchResult RigBatch::result(size_t rig) const
+{
+    BatchResult r = {height[rig], climbRate[rig], yaw[rig], yawRate[rig], mainSpeed[rig], tailSpeed[rig],
+                     adcSum[rig], previousHeight[rig], previousYaw[rig], heightIntegral[rig], yawIntegral[rig],
+                     mainDuty[rig], tailDuty[rig], dutyHash[rig]};
+    return r;
+}
@@ -0,0 +1,146 @@
+// ************************************************************
+// batchEngine.h
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Fly many simulated rigs at once, as fast as the host can.
+// Explaination: A closed loop of a fixed point rig model, the height filter of
+// height.c and the PID stage of control.c, stepped every BATCH_STEP_US. The ADC
+// is sampled at ADC_SAMPLE_RATE into a CONV_SIZE average and the controller runs
+// every BATCH_CONTROL_MS, with the references at the targets (no trajectory).
+// The rig constants are fixed point versions of RigParams (rigModel.h).
+//
+// There are two engines over the same arithmetic. ScalarRig is one rig in a
+// struct, stepped on its own with pidUpdate(..) from pid.c, as one thread would
+// fly one rig. RigBatch holds the plant, filter and PID state of N rigs in
+// structure of arrays form, one array per variable, and steps each variable of
+// every rig in one loop, which the compiler vectorises (SSE/AVX on x86). Every
+// operation is on int32_t with the same truncating divisions and clamps, so the
+// two give bit-identical results; batchSim.cpp checks that they do.
+// ************************************************************
+
+#ifndef BATCHENGINE_H_
+#define BATCHENGINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rigModel.h"
+#include "../control.h"
+#include "../height.h"
+
+#define BATCH_STEP_US 1250  // plant step, divides both periods below
+#define BATCH_CONTROL_MS 10  // as TASK_BASE_FREQ
+#define BATCH_ADC_STEPS (1000000 / ADC_SAMPLE_RATE / BATCH_STEP_US)  // steps between ADC samples
+#define BATCH_CONTROL_STEPS (BATCH_CONTROL_MS * 1000 / BATCH_STEP_US)
+#define BATCH_STEPS_PER_SECOND (1000000 / BATCH_STEP_US)
+#define BATCH_COUNTS_PER_ROTATION (112 * 4)  // as yaw.c
+
+
+// One rig's constants in fixed point. Q<n> is scaled by 2^n.
+struct BatchParams {
+    int32_t mainLagQ16;  // BATCH_STEP_US over the main rotor's time constant
+    int32_t tailLagQ16;
+    int32_t hover;  // % scaled by PRECISION
+    int32_t gravQ16;  // gravSlope
+    int32_t liftQ8;
+    int32_t heightDragQ8;
+    int32_t yawThrustQ8;
+    int32_t torqueQ12;  // torqueRatio
+    int32_t yawDragQ8;
+    int32_t adcLanded;  // counts
+    int32_t adcRangeQ20;  // counts per % of height scaled by PRECISION
+    uint32_t noiseSeed;
+};
+
+// Convert a rig's constants. The stiction and the sensor's bend are not modelled.
+BatchParams batchParams(const RigParams& params, uint32_t noiseSeed);
+
+// The targets and gains every rig flies with, scaled as in control.c.
+struct BatchFlight {
+    int32_t targetHeight;  // % scaled by PRECISION
+    int32_t targetYaw;  // deg scaled by PRECISION
+    int32_t mainGains[CONTROL_NUM_GAINS];
+    int32_t tailGains[CONTROL_NUM_GAINS];
+    int32_t mainOffset, gravOffset, torqueConst;  // control_param_t
+};
+
+// The gains and constants control.c starts with, flying to targetHeight and targetYaw.
+BatchFlight batchDefaultFlight(int32_t targetHeight, int32_t targetYaw);
+
+// One rig's state at the end of a run, to compare the engines. The plant's positions
+// and rates are in fine units, BATCH_STEPS_PER_SECOND times the % or deg scaled by
+// PRECISION (per second for the rates).
+struct BatchResult {
+    int32_t height, climbRate, yaw, yawRate, mainSpeed, tailSpeed;  // plant
+    int32_t adcSum;  // filter
+    int32_t sensedHeight, sensedYaw;  // as the controller last read them, scaled by PRECISION
+    int32_t heightIntegral, yawIntegral;  // PID
+    int32_t mainDuty, tailDuty;
+    uint32_t dutyHash;  // of every duty cycle output, so a difference which dies away still shows
+};
+
+
+class ScalarRig {
+public:
+    ScalarRig(const BatchParams& params, const BatchFlight& flight);
+
+    void step(void);
+    BatchResult result(void) const;
+
+private:
+    BatchParams p;
+    const BatchFlight& flight;
+    uint32_t steps;
+    int32_t height, climbRate, yaw, yawRate, mainSpeed, tailSpeed;
+    int32_t samples[CONV_SIZE];
+    uint32_t sampleIndex;
+    int32_t adcSum, baseMean;
+    uint32_t noiseState;
+    int32_t previousHeight, previousYaw;
+    int32_t heightIntegral, yawIntegral;
+    int32_t mainDuty, tailDuty, outputMainDuty;
+    uint32_t dutyHash;
+};
+
+
+class RigBatch {
+public:
+    RigBatch(const std::vector<BatchParams>& params, const BatchFlight& flight);
+
+    void step(void);  // every rig
+    BatchResult result(size_t rig) const;
+    size_t size(void) const { return n; }
+
+private:
+    size_t n;
+    const BatchFlight& flight;
+    uint32_t steps;
+    uint32_t sampleIndex;
+
+    // constants
+    std::vector<int32_t> mainLagQ16, tailLagQ16, hover, gravQ16, liftQ8, heightDragQ8;
+    std::vector<int32_t> yawThrustQ8, torqueQ12, yawDragQ8, adcLanded, adcRangeQ20;
+
+    // plant
+    std::vector<int32_t> height, climbRate, yaw, yawRate, mainSpeed, tailSpeed;
+
+    // filter, samples[i * n + rig] is a rig's sample i
+    std::vector<int32_t> samples;
+    std::vector<int32_t> adcSum, baseMean;
+    std::vector<uint32_t> noiseState;
+
+    // PID
+    std::vector<int32_t> previousHeight, previousYaw, heightIntegral, yawIntegral;
+    std::vector<int32_t> mainDuty, tailDuty, outputMainDuty;
+    std::vector<uint32_t> dutyHash;
+
+    void stepPlant(void);
+    void sample(void);
+    void control(void);
+};
+
+
+#endif /* BATCHENGINE_H_ */
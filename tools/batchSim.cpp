@@ -0,0 +1,123 @@
+// ************************************************************
+// batchSim.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Fly a batch of random rigs with both engines of batchEngine.h, check
+// they agree to the bit, and compare their speed.
+// Explaination: Each rig is rigRandomParams(..) from the default rig, flown from
+// landed to a height of 50 % and a yaw of 90 deg. The scalar engine flies the
+// rigs one after the other, as a thread per rig would, and the batch engine flies
+// them all together. Prints each engine's throughput in rig-steps per second
+// (one rig moved on by BATCH_STEP_US), how many rigs ended within 2 % and 2 deg
+// of the targets as the firmware reads them, and whether every rig's end state
+// and duty cycle history were identical. Returns non zero if any rig differs.
+//   batchSim [-n rigs] [-t seconds] [-s seed]
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <unistd.h>
+
+#include "batchEngine.h"
+
+#define RIG_SPREAD 0.1
+#define TARGET_HEIGHT (50 * PRECISION)
+#define TARGET_YAW (90 * PRECISION)
+#define SETTLED_HEIGHT (2 * PRECISION)
+#define SETTLED_YAW (2 * PRECISION)
+
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+static bool isSettled(const BatchResult& r)
+{
+    return abs(r.sensedHeight - TARGET_HEIGHT) <= SETTLED_HEIGHT && abs(r.sensedYaw - TARGET_YAW) <= SETTLED_YAW;
+}
+
+
+int main(int argc, char** argv)
+{
+    uint32_t numRigs = 1024;
+    double seconds = 30;
+    uint32_t seed = 1;
+    int option;
+
+    while ((option = getopt(argc, argv, "n:t:s:")) != -1) {
+        if (option == 'n') {
+            numRigs = (uint32_t)strtoul(optarg, 0, 10);
+        } else if (option == 't') {
+            seconds = atof(optarg);
+        } else if (option == 's') {
+            seed = (uint32_t)strtoul(optarg, 0, 10);
+        } else {
+            fprintf(stderr, "usage: batchSim [-n rigs] [-t seconds] [-s seed]\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (numRigs == 0) {
+        fprintf(stderr, "no rigs to fly\n");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<BatchParams> params;
+    for (uint32_t rig = 0; rig < numRigs; rig++) {
+        params.push_back(batchParams(rigRandomParams(rigDefaultParams(), RIG_SPREAD, seed + rig), seed + rig));
+    }
+    BatchFlight flight = batchDefaultFlight(TARGET_HEIGHT, TARGET_YAW);
+    uint32_t steps = (uint32_t)(seconds * BATCH_STEPS_PER_SECOND);
+    double rigSteps = (double)steps * numRigs;
+
+    // one rig at a time
+    std::vector<BatchResult> scalarResults;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t rig = 0; rig < numRigs; rig++) {
+        ScalarRig scalar(params[rig], flight);
+        for (uint32_t step = 0; step < steps; step++) {
+            scalar.step();
+        }
+        scalarResults.push_back(scalar.result());
+    }
+    double scalarWall = secondsSince(start);
+
+    // all together
+    RigBatch batch(params, flight);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t step = 0; step < steps; step++) {
+        batch.step();
+    }
+    double batchWall = secondsSince(start);
+
+    uint32_t differing = 0, settled = 0;
+    for (uint32_t rig = 0; rig < numRigs; rig++) {
+        BatchResult result = batch.result(rig);
+        if (memcmp(&result, &scalarResults[rig], sizeof(result)) != 0) {
+            if (differing++ == 0) {
+                printf("rig %u differs: height %d and %d, yaw %d and %d, duty hash %08x and %08x\n", rig,
+                       scalarResults[rig].height, result.height, scalarResults[rig].yaw, result.yaw,
+                       scalarResults[rig].dutyHash, result.dutyHash);
+            }
+        }
+        settled += isSettled(result);
+    }
+
+    printf("%u rigs, %.1f s each, %u steps of %u us\n", numRigs, seconds, steps, BATCH_STEP_US);
+    printf("scalar %.3f s, %.3g rig-steps/s\n", scalarWall, rigSteps / scalarWall);
+    printf("batch  %.3f s, %.3g rig-steps/s, %.1f times the scalar engine\n", batchWall, rigSteps / batchWall,
+           scalarWall / batchWall);
+    printf("%u of %u rigs settled within 2 %% and 2 deg of the targets\n", settled, numRigs);
+    if (differing) {
+        printf("FAIL %u rigs differ between the engines\n", differing);
+        return EXIT_FAILURE;
+    }
+    printf("all rigs bit-identical between the engines\n");
+    return EXIT_SUCCESS;
+}
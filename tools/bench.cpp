@@ -0,0 +1,189 @@
+// ************************************************************
+// bench.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Time the hot paths of the firmware on the host, those which need
+// the live module state as well as the board's benchmarks.
+// Explaination: The firmware is brought up with initalise() from main.c on the
+// host HAL, as it starts on the board, and the helicopter set flying on both
+// channels. The functions which only work on the module state (heightUpdate,
+// controlUpdate, the encoder and ADC interrupt handlers, uartPrintLineWithFormat
+// and buttonsUpdate) are then called on the firmware's own state, which this
+// process has to itself. The board's benchmarks in benchmark.c are run after
+// them, through benchmarkCall(..).
+//
+// Each benchmark is a number of batches of calls, each batch timed with the
+// host's clock while the interrupts are masked, so only the function is timed.
+// Between batches the interrupts are let in and virtual time moves on, so the
+// ADC fills and the UART drains. The results are printed as one JSON object per
+// line, as the board prints its benchmarks:
+//   {"bench":"controlUpdate","calls":51200,"min_ns":61.2,"ns":63.8}
+// ns is the mean time of a call and min_ns that of the fastest batch. The times
+// are the host's, so compare them with a baseline from the same machine using
+// benchCompare.
+//   bench [-b batches] > bench.json
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <unistd.h>
+
+#include "halHost.h"
+#include "../benchmark.h"
+#include "../buttons4.h"
+#include "../control.h"
+#include "../height.h"
+#include "../quadratureEncoder.h"
+#include "../adcModule.h"
+#include "../uartDisplay.h"
+
+extern "C" void initalise(void);
+
+#define BATCH_CALLS 256
+#define UART_BATCH_CALLS 4  // lines queued between drains, so none are dropped
+#define DRAIN_CYCLES (HAL_HOST_CLOCK / 1000)
+
+struct Benchmark {
+    const char* name;
+    void (*run)(uint32_t call);
+    uint32_t batchCalls;
+};
+
+static state_t state;
+
+
+static void runHeightUpdate(uint32_t)
+{
+    heightUpdate();
+}
+
+
+static void runControlUpdate(uint32_t)
+{
+    controlUpdate(&state, 10);
+}
+
+
+// with an edge on the pins for the handler to find, which is timed too
+static void runQuadEncoderIntHandler(uint32_t call)
+{
+    halHostEncoderEdge(call & 1 ? HAL_ENCODER_A : HAL_ENCODER_B);
+    quadEncoderIntHandler();
+}
+
+
+static void runAdcIntHandler(uint32_t)
+{
+    adcIntHandler();
+}
+
+
+static void runUartPrintLineWithFormat(uint32_t call)
+{
+    uartPrintLineWithFormat("ALT %d [%d] %%\n", 50, (int32_t)call);
+}
+
+
+static void runButtonsUpdate(uint32_t)
+{
+    buttonsUpdate();
+}
+
+
+static const Benchmark liveBenchmarks[] = {
+    {"heightUpdate", runHeightUpdate, BATCH_CALLS},
+    {"controlUpdate", runControlUpdate, BATCH_CALLS},
+    {"quadEncoderIntHandler", runQuadEncoderIntHandler, BATCH_CALLS},
+    {"adcIntHandler", runAdcIntHandler, BATCH_CALLS},
+    {"uartPrintLineWithFormat", runUartPrintLineWithFormat, UART_BATCH_CALLS},
+    {"buttonsUpdate", runButtonsUpdate, BATCH_CALLS}
+};
+
+
+// Let the interrupts in until the UART has sent everything queued, when its
+// queue stops emptying.
+static void settle(void)
+{
+    uint32_t space;
+
+    halInterruptsEnable();
+    do {
+        space = uartTxSpace();
+        halHostBurn(DRAIN_CYCLES);
+    } while (uartTxSpace() > space);
+}
+
+
+// Time batches of batchCalls calls of run, or of board benchmark index if run is 0,
+// and print the result.
+static void bench(const char* name, void (*run)(uint32_t), uint32_t index, uint32_t batchCalls,
+                  uint32_t batches)
+{
+    double total = 0, fastest = 0;
+    uint32_t call = 0;
+
+    for (uint32_t batch = 0; batch < batches; batch++) {
+        settle();
+        if (!run) {
+            benchmarkSetup(index);  // the state the board benchmark expects, not timed
+        }
+        halInterruptsDisable();
+        auto start = std::chrono::steady_clock::now();
+        if (run) {
+            for (uint32_t i = 0; i < batchCalls; i++) {
+                run(call++);
+            }
+        } else {
+            for (uint32_t i = 0; i < batchCalls; i++) {
+                benchmarkCall(index, call++);
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        total += ns;
+        if (batch == 0 || ns < fastest) {
+            fastest = ns;
+        }
+    }
+    printf("{\"bench\":\"%s\",\"calls\":%u,\"min_ns\":%.1f,\"ns\":%.1f}\n", name, batches * batchCalls,
+           fastest / batchCalls, total / (batches * batchCalls));
+}
+
+
+int main(int argc, char** argv)
+{
+    uint32_t batches = 200;
+    int option;
+
+    while ((option = getopt(argc, argv, "b:")) != -1) {
+        if (option == 'b') {
+            batches = (uint32_t)strtoul(optarg, 0, 10);
+        } else {
+            fprintf(stderr, "usage: bench [-b batches]\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (batches == 0) {
+        fprintf(stderr, "no batches to run\n");
+        return EXIT_FAILURE;
+    }
+
+    // fly at a height and yaw which the references take a while to reach
+    initalise();
+    state.heliMode = STATE_FLYING;
+    state.targetHeight = 50;
+    state.targetYaw = 90;
+    controlEnable(&state, CONTROL_HEIGHT);
+    controlEnable(&state, CONTROL_YAW);
+
+    for (const Benchmark& benchmark : liveBenchmarks) {
+        bench(benchmark.name, benchmark.run, 0, benchmark.batchCalls, batches);
+    }
+    for (uint32_t index = 0; index < benchmarkNum(); index++) {
+        bench(benchmarkName(index), 0, index, BATCH_CALLS, batches);
+    }
+    return EXIT_SUCCESS;
+}
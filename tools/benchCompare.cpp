@@ -0,0 +1,113 @@
+// ************************************************************
+// benchCompare.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Compare a run of the benchmarks with a baseline, to find
+// regressions.
+// Explaination: Reads the JSON lines of two runs, from the board (benchmark.c,
+// in a capture of the UART, where other lines are skipped) or from the host
+// (tools/bench). Each benchmark's time per call is compared, and a line printed
+// with both times and the change. The host's fastest batch, "min_ns", is used
+// where there is one, as the host's means vary with the load of the machine;
+// the board's mean, "ns", varies little. A benchmark which got slower by
+// more than the threshold (10 % unless -t is given) or which is missing from
+// the run is a regression. Returns non zero if there are any.
+//   benchCompare [-t percent] baseline.json run.json
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+#define LINE_LENGTH 256
+#define NAME_LENGTH 64
+
+
+// Read the time of each benchmark in path into times. Returns false if there are none.
+static bool load(const char* path, std::map<std::string, double>& times)
+{
+    FILE* file = fopen(path, "r");
+    char line[LINE_LENGTH];
+
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file)) {
+        char name[NAME_LENGTH];
+        const char* bench = strstr(line, "{\"bench\":\"");
+        const char* ns = strstr(line, "\"min_ns\":");
+        const char* key = "\"min_ns\":";
+        if (!ns) {
+            ns = strstr(line, "\"ns\":");
+            key = "\"ns\":";
+        }
+        if (bench && ns && sscanf(bench, "{\"bench\":\"%63[^\"]\"", name) == 1) {
+            times[name] = atof(ns + strlen(key));
+        }
+    }
+    fclose(file);
+    if (times.empty()) {
+        fprintf(stderr, "%s has no benchmarks\n", path);
+        return false;
+    }
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    double threshold = 10;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:")) != -1) {
+        if (option == 't') {
+            threshold = atof(optarg);
+        } else {
+            optind = argc;
+            break;
+        }
+    }
+    if (optind != argc - 2) {
+        fprintf(stderr, "usage: benchCompare [-t percent] baseline.json run.json\n");
+        return EXIT_FAILURE;
+    }
+
+    std::map<std::string, double> baseline, run;
+    if (!load(argv[optind], baseline) || !load(argv[optind + 1], run)) {
+        return EXIT_FAILURE;
+    }
+
+    uint32_t regressions = 0;
+    printf("%-28s %12s %12s %8s\n", "bench", "baseline ns", "ns", "change");
+    for (const auto& entry : baseline) {
+        auto found = run.find(entry.first);
+        if (found == run.end()) {
+            printf("%-28s %12.1f %12s %8s  REGRESSION, missing\n", entry.first.c_str(), entry.second, "-", "-");
+            regressions++;
+            continue;
+        }
+        double change = entry.second > 0 ? (found->second - entry.second) * 100 / entry.second : 0;
+        bool isSlower = change > threshold;
+        printf("%-28s %12.1f %12.1f %+7.1f%%%s\n", entry.first.c_str(), entry.second, found->second, change,
+               isSlower ? "  REGRESSION" : "");
+        regressions += isSlower;
+    }
+    for (const auto& entry : run) {
+        if (!baseline.count(entry.first)) {
+            printf("%-28s %12s %12.1f %8s  new\n", entry.first.c_str(), "-", entry.second, "-");
+        }
+    }
+
+    if (regressions) {
+        printf("%u regressions over %.0f %%\n", regressions, threshold);
+        return EXIT_FAILURE;
+    }
+    printf("no regressions over %.0f %%\n", threshold);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+// ************************************************************
+// firmwareRun.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Run the whole firmware on the host, with a still rig, and show what
+// it sends.
+// Explaination: main.c and every module run on the host backend of the HAL
+// (halHost.cpp) for the given virtual time. The rig doesn't move: the height
+// sensor reads a fixed ADC value and the encoder is still. Commands are typed
+// into the UART at the given times, as "seconds:command". The UART output is
+// written to stdout as it is sent, and the OLED, the PWM outputs and the
+// interrupt count are printed to stderr at the end.
+//   firmwareRun -t 3 "1:D S" "2:D"
+// Returns non zero if the firmware reset itself or stopped early.
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "halHost.h"
+
+#define PLANT_PERIOD_US 1000
+#define RESTING_ADC 2000  // about the landed height sensor reading on the rig
+#define MAX_COMMANDS 32
+#define COMMAND_LENGTH 32
+
+struct Command {
+    double time;
+    char text[COMMAND_LENGTH];
+    bool isSent;
+};
+
+static Command commands[MAX_COMMANDS];
+static int numCommands = 0;
+
+
+static void printChar(void*, char c)
+{
+    if (c != '\r') {
+        putchar(c);
+    }
+}
+
+
+// Type each command into the UART once its time comes.
+static void operatorUpdate(void*)
+{
+    for (int i = 0; i < numCommands; i++) {
+        if (!commands[i].isSent && halHostSeconds() >= commands[i].time) {
+            halHostUartReceive(commands[i].text, strlen(commands[i].text));
+            commands[i].isSent = true;
+        }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    double seconds = 2;
+    uint32_t adc = RESTING_ADC;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:a:")) != -1) {
+        if (option == 't') {
+            seconds = atof(optarg);
+        } else if (option == 'a') {
+            adc = (uint32_t)strtoul(optarg, 0, 10);
+        } else {
+            fprintf(stderr, "usage: firmwareRun [-t seconds] [-a adc] [seconds:command ...]\n");
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = optind; i < argc && numCommands < MAX_COMMANDS; i++) {
+        const char* colon = strchr(argv[i], ':');
+        if (!colon) {
+            fprintf(stderr, "command %s has no time\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+        Command& command = commands[numCommands++];
+        command.time = atof(argv[i]);
+        snprintf(command.text, sizeof(command.text), "%s\r", colon + 1);
+        command.isSent = false;
+    }
+
+    halHostSetAdc(adc);
+    halHostSetUartSink(printChar, 0);
+    halHostSetPlant(PLANT_PERIOD_US, operatorUpdate, 0);
+    hal_host_stop_t stop = halHostRun(firmwareMain, seconds);
+    fflush(stdout);
+
+    fprintf(stderr, "\nstopped at %.3f s: %s\n", halHostSeconds(),
+            stop == HAL_HOST_STOP_TIME ? "time up" : stop == HAL_HOST_STOP_RESET ? "reset" : "returned");
+    for (uint32_t row = 0; row < 4; row++) {
+        fprintf(stderr, "oled |%s|\n", halHostOledLine(row));
+    }
+    fprintf(stderr, "pwm main %.2f %%, tail %.2f %%, %llu interrupts\n", halHostPwmDuty(HAL_PWM_MAIN) * 100,
+            halHostPwmDuty(HAL_PWM_TAIL) * 100, (unsigned long long)halHostInterrupts());
+    return stop == HAL_HOST_STOP_TIME ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,346 @@
+// ************************************************************
+// gainSweep.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Rank PID gains by flying each set against many simulated rigs.
+// Explaination: Each configuration is a set of the six height and yaw gains,
+// each a random factor of 1/g to g from the firmware's defaults (g is 2 unless
+// given with -g).
+// Configuration 0 is the defaults. Every configuration flies the same
+// randomised rigs (rigRandomParams(..), 10 % spread, with their own sensor
+// noise), so they are compared on equal terms. A flight runs the whole
+// firmware on the host HAL against RigModel: take off, a height step to 50 %,
+// a yaw step to 90 deg, then land. The steps are measured with stepAnalysis.c
+// on the rig's actual yaw, and on the height as the firmware sees it less the
+// noise, as no gains can correct the bend of the sensor. The landing time runs
+// from the land command until the motors are off.
+//
+// Module state is static, so each flight runs in its own forked process. Up
+// to -j of them run at once, and each worker that finishes is given the next
+// flight straight away, so the load stays balanced when flights take
+// different times. Results come back over a pipe. The score of a flight is
+//   height settling + yaw settling + landing time (ms) + SCORE_PER_OVERSHOOT * overshoots (%)
+// with steps which never settle counted at their time out. Configurations
+// are ranked by their mean score. Writes one CSV row per configuration with
+// -o, and prints the best ones and the speedup over running the flights one
+// after another.
+//   gainSweep [-n configurations] [-r rigs] [-j jobs] [-g range] [-s seed] [-o sweep.csv]
+// CONV_SIZE and the landing constants are compile time constants, so they
+// are not swept here.
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "halHost.h"
+#include "rigModel.h"
+#include "../control.h"
+#include "../stepAnalysis.h"
+
+#define PLANT_PERIOD_US 1000
+#define SAMPLE_PERIOD 10  // plant periods between step analysis updates
+#define RIG_SPREAD 0.1
+#define GAIN_RANGE 2.0  // default for -g
+#define HEIGHT_STEP_TIME 8.0  // s, once the yaw is calibrated
+#define HEIGHT_TARGET 50  // %
+#define YAW_STEP_TIME 16.0
+#define YAW_TARGET 90  // deg
+#define LAND_TIME 24.0
+#define FLIGHT_TIME 44.0  // s at most; the flight ends once landed
+#define SCORE_PER_OVERSHOOT 50  // ms per % of overshoot
+#define NUM_GAINS 6  // height P, D, I then yaw P, D, I
+#define TOP_CONFIGS 10
+
+// operator commands, typed at their times
+static const struct {
+    double time;
+    const char* text;
+} flightCommands[] = {
+    {1.0, "M F\r"},
+    {HEIGHT_STEP_TIME, "H 50\r"},
+    {YAW_STEP_TIME, "Y 90\r"},
+    {LAND_TIME, "M L\r"}
+};
+#define NUM_FLIGHT_COMMANDS (sizeof(flightCommands) / sizeof(flightCommands[0]))
+
+// What one flight did, sent back from its process
+struct FlightResult {
+    uint32_t config;
+    uint32_t rig;
+    uint32_t heightSettling;  // ms
+    int32_t heightOvershoot;  // %
+    uint32_t yawSettling;
+    int32_t yawOvershoot;
+    uint32_t landingTime;  // ms
+    bool isSettled;  // both steps settled and it landed
+    double cpuTime;  // s of processor time the flight took
+};
+
+// The mean results of one configuration
+struct ConfigResult {
+    uint32_t config;
+    int32_t gains[NUM_GAINS];
+    uint32_t flights;
+    uint32_t unsettled;
+    double heightSettling, heightOvershoot, yawSettling, yawOvershoot, landingTime, score;
+};
+
+
+// the flight being run, in the child process
+static RigModel* rig = 0;
+static FlightResult flight;
+static step_analysis_t heightStep, yawStep;
+static uint32_t commandsSent = 0;
+static uint32_t plantSteps = 0;
+static bool isHeightDone = false, isYawDone = false;
+
+
+static double flightScore(const FlightResult& r)
+{
+    return (double)r.heightSettling + r.yawSettling + r.landingTime +
+           SCORE_PER_OVERSHOOT * (std::max(r.heightOvershoot, 0) + std::max(r.yawOvershoot, 0));
+}
+
+
+// After each step of the rig: type the commands which are due, measure the
+// steps and watch for the motors going off after the land command.
+static void operatorUpdate(void*)
+{
+    double now = halHostSeconds();
+    uint32_t ms = (uint32_t)(now * 1000);
+    step_metrics_t metrics;
+
+    while (commandsSent < NUM_FLIGHT_COMMANDS && now >= flightCommands[commandsSent].time) {
+        halHostUartReceive(flightCommands[commandsSent].text, strlen(flightCommands[commandsSent].text));
+        commandsSent++;
+    }
+    if (plantSteps++ % SAMPLE_PERIOD != 0) {
+        return;
+    }
+
+    // the firmware's yaw is zero at the reference
+    int32_t height = (int32_t)std::lround(rig->sensedHeight() * STEP_PRECISION);
+    int32_t yaw = (int32_t)std::lround((rig->yaw() - rig->params().yawReference) * STEP_PRECISION);
+    if (!isHeightDone && now >= HEIGHT_STEP_TIME - 1 && now < LAND_TIME &&
+            stepAnalysisUpdate(&heightStep, now >= HEIGHT_STEP_TIME ? HEIGHT_TARGET : 0, height, ms, &metrics)) {
+        flight.heightSettling = metrics.settlingTime;
+        flight.heightOvershoot = metrics.overshoot;
+        isHeightDone = true;
+    }
+    if (!isYawDone && now >= YAW_STEP_TIME - 1 && now < LAND_TIME &&
+            stepAnalysisUpdate(&yawStep, now >= YAW_STEP_TIME ? YAW_TARGET : 0, yaw, ms, &metrics)) {
+        flight.yawSettling = metrics.settlingTime;
+        flight.yawOvershoot = metrics.overshoot;
+        isYawDone = true;
+    }
+
+    if (now >= LAND_TIME + 0.1 && !halHostPwmIsOn(HAL_PWM_MAIN)) {
+        flight.landingTime = (uint32_t)((now - LAND_TIME) * 1000);
+        halHostStop();
+    }
+}
+
+
+// Fly one rig with one set of gains, in this process, and fill in flight.
+static void fly(const int32_t gains[NUM_GAINS], uint32_t rigSeed)
+{
+    for (int i = 0; i < NUM_GAINS; i++) {
+        controlSetGain(i < CONTROL_NUM_GAINS ? CONTROL_HEIGHT : CONTROL_YAW,
+                       (control_gain_t)(i % CONTROL_NUM_GAINS), gains[i]);
+    }
+
+    RigModel model(rigRandomParams(rigDefaultParams(), RIG_SPREAD, rigSeed), rigSeed);
+    RigPlant plant(model);
+    rig = &model;
+    stepAnalysisReset(&heightStep, 0);
+    stepAnalysisReset(&yawStep, 0);
+
+    // steps which never settle, and a landing which never finishes, count as taking the whole time
+    flight.heightSettling = (uint32_t)((LAND_TIME - HEIGHT_STEP_TIME) * 1000);
+    flight.yawSettling = (uint32_t)((LAND_TIME - YAW_STEP_TIME) * 1000);
+    flight.landingTime = (uint32_t)((FLIGHT_TIME - LAND_TIME) * 1000);
+
+    plant.attach(PLANT_PERIOD_US, operatorUpdate, 0);
+    halHostRun(firmwareMain, FLIGHT_TIME);
+    flight.isSettled = isHeightDone && isYawDone && halHostSeconds() < FLIGHT_TIME;
+}
+
+
+// A random factor from 1/range to range, evenly spread on a log scale.
+static double gainFactor(uint32_t& state, double range)
+{
+    state = state * 1664525 + 1013904223;
+    double uniform = (state >> 8) / 16777216.0;
+    return std::exp(std::log(range) * (2 * uniform - 1));
+}
+
+
+int main(int argc, char** argv)
+{
+    uint32_t numConfigs = 100, numRigs = 8, seed = 1;
+    double gainRange = GAIN_RANGE;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    FILE* csv = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "n:r:j:g:s:o:")) != -1) {
+        if (option == 'n') {
+            numConfigs = (uint32_t)strtoul(optarg, 0, 10);
+        } else if (option == 'r') {
+            numRigs = (uint32_t)strtoul(optarg, 0, 10);
+        } else if (option == 'j') {
+            jobs = strtol(optarg, 0, 10);
+        } else if (option == 'g') {
+            gainRange = atof(optarg);
+        } else if (option == 's') {
+            seed = (uint32_t)strtoul(optarg, 0, 10);
+        } else if (option == 'o') {
+            csv = fopen(optarg, "w");
+            if (!csv) {
+                perror(optarg);
+                return EXIT_FAILURE;
+            }
+        } else {
+            fprintf(stderr, "usage: gainSweep [-n configurations] [-r rigs] [-j jobs] [-g range] [-s seed] [-o sweep.csv]\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (numConfigs == 0 || numRigs == 0 || jobs < 1 || gainRange < 1) {
+        fprintf(stderr, "nothing to run\n");
+        return EXIT_FAILURE;
+    }
+
+    // configuration 0 is the firmware's own gains
+    std::vector<ConfigResult> configs(numConfigs);
+    uint32_t gainState = seed;
+    for (uint32_t c = 0; c < numConfigs; c++) {
+        memset(&configs[c], 0, sizeof(configs[c]));
+        configs[c].config = c;
+        for (int i = 0; i < NUM_GAINS; i++) {
+            int32_t base = controlGetGain(i < CONTROL_NUM_GAINS ? CONTROL_HEIGHT : CONTROL_YAW,
+                                          (control_gain_t)(i % CONTROL_NUM_GAINS));
+            configs[c].gains[i] = c == 0 ? base : (int32_t)std::lround(base * gainFactor(gainState, gainRange));
+        }
+    }
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return EXIT_FAILURE;
+    }
+
+    // hand out the flights to at most jobs processes at a time
+    uint32_t numFlights = numConfigs * numRigs;
+    uint32_t started = 0, finished = 0, failed = 0;
+    long running = 0;
+    double flightTime = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (finished < numFlights) {
+        while (running < jobs && started < numFlights) {
+            uint32_t config = started / numRigs, rigIndex = started % numRigs;
+            pid_t pid = fork();
+            if (pid < 0) {
+                perror("fork");
+                return EXIT_FAILURE;
+            }
+            if (pid == 0) {
+                close(fds[0]);
+                flight.config = config;
+                flight.rig = rigIndex;
+                fly(configs[config].gains, seed * 7919 + rigIndex);
+                flight.cpuTime = (double)std::clock() / CLOCKS_PER_SEC;
+                ssize_t written = write(fds[1], &flight, sizeof(flight));  // atomic, under PIPE_BUF
+                _exit(written == sizeof(flight) ? EXIT_SUCCESS : EXIT_FAILURE);
+            }
+            started++;
+            running++;
+        }
+
+        // collect the next finished flight
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            perror("wait");
+            return EXIT_FAILURE;
+        }
+        running--;
+        finished++;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            failed++;
+            continue;
+        }
+        FlightResult r;
+        if (read(fds[0], &r, sizeof(r)) != sizeof(r)) {
+            failed++;
+            continue;
+        }
+        ConfigResult& c = configs[r.config];
+        c.flights++;
+        c.unsettled += !r.isSettled;
+        c.heightSettling += r.heightSettling;
+        c.heightOvershoot += r.heightOvershoot;
+        c.yawSettling += r.yawSettling;
+        c.yawOvershoot += r.yawOvershoot;
+        c.landingTime += r.landingTime;
+        c.score += flightScore(r);
+        flightTime += r.cpuTime;
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (ConfigResult& c : configs) {
+        if (c.flights) {
+            c.heightSettling /= c.flights;
+            c.heightOvershoot /= c.flights;
+            c.yawSettling /= c.flights;
+            c.yawOvershoot /= c.flights;
+            c.landingTime /= c.flights;
+            c.score /= c.flights;
+        } else {
+            c.score = HUGE_VAL;
+        }
+    }
+    ConfigResult defaults = configs[0];
+    std::sort(configs.begin(), configs.end(),
+              [](const ConfigResult& a, const ConfigResult& b) { return a.score < b.score; });
+
+    if (csv) {
+        fprintf(csv, "rank,config,heightP,heightD,heightI,yawP,yawD,yawI,flights,unsettled,"
+                "heightSettling,heightOvershoot,yawSettling,yawOvershoot,landingTime,score\n");
+        for (uint32_t i = 0; i < numConfigs; i++) {
+            const ConfigResult& c = configs[i];
+            fprintf(csv, "%u,%u,%d,%d,%d,%d,%d,%d,%u,%u,%.0f,%.1f,%.0f,%.1f,%.0f,%.0f\n", i + 1, c.config,
+                    c.gains[0], c.gains[1], c.gains[2], c.gains[3], c.gains[4], c.gains[5], c.flights, c.unsettled,
+                    c.heightSettling, c.heightOvershoot, c.yawSettling, c.yawOvershoot, c.landingTime, c.score);
+        }
+        fclose(csv);
+    }
+
+    printf("rank config   height P D I     yaw P D I     unsettled  h settle/over  y settle/over  landing  score\n");
+    for (uint32_t i = 0; i <= numConfigs; i++) {
+        const ConfigResult& c = i < numConfigs ? configs[i] : defaults;
+        if (i >= TOP_CONFIGS && i < numConfigs) {
+            continue;
+        }
+        printf("%-4s %6u  %4d %4d %4d  %4d %4d %4d  %3u/%-3u  %6.0f %5.1f%%  %6.0f %5.1f%%  %7.0f  %6.0f\n",
+               i < numConfigs ? std::to_string(i + 1).c_str() : "def", c.config, c.gains[0], c.gains[1], c.gains[2],
+               c.gains[3], c.gains[4], c.gains[5], c.unsettled, c.flights, c.heightSettling, c.heightOvershoot,
+               c.yawSettling, c.yawOvershoot, c.landingTime, c.score);
+    }
+    printf("%u flights (%u failed) in %.2f s with %ld jobs: %.1f ms of flight each, %.2f times as fast as one "
+           "after another, %.0f %% of linear\n",
+           numFlights, failed, wall, jobs, flightTime / numFlights * 1000, flightTime / wall,
+           flightTime / wall / jobs * 100);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,781 @@
+// ************************************************************
+// halHost.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: The hardware interface of hal.h on a PC, in virtual time.
+// Explaination: See halHost.h. Every timed thing the board does is an event
+// with the cycle it is due at. Moving time on fires the events which are due,
+// in order, and then takes the pending interrupts while they are unmasked.
+// Interrupt handlers read the timer too, which moves time on again, so events
+// can become due while a handler runs; they are fired then but their
+// interrupts wait until it returns, as on the board. The run is ended from
+// inside the firmware's loop with longjmp, which is safe as the frames it
+// leaves are the firmware's C functions and this file's, none of which own
+// anything.
+// ************************************************************
+
+#include <csetjmp>
+#include <cstring>
+
+#include "halHost.h"
+#include "../buttons4.h"
+#include "../display.h"
+
+#define NEVER UINT64_MAX
+#define PWM_DIVIDER 4
+#define ADC_CONVERSION_CYCLES 20  // 1 us at 1 Msps
+#define ADC_MAX 4095
+#define UART_FIFO_SIZE 16
+#define UART_TX_TRIGGER 2  // transmit interrupt as the FIFO drains to 1/8 full
+#define UART_RX_QUEUE_SIZE 4096  // characters sent by the tool, waiting to arrive
+#define UART_BITS_PER_CHAR 10  // 8 data bits with a start and stop bit
+
+// Timed things, in the order they fire when due together
+enum {
+    EVENT_PLANT = 0,
+    EVENT_TICK,
+    EVENT_ADC,
+    EVENT_PWM_ZERO_MAIN,  // start of a period, where the width is latched
+    EVENT_PWM_ZERO_TAIL,
+    EVENT_PWM_LOAD_MAIN,  // middle of a period, where the interrupt is raised
+    EVENT_PWM_LOAD_TAIL,
+    EVENT_UART_TX,  // a character has been sent
+    EVENT_UART_RX,  // a character has arrived
+    EVENT_AT,  // halHostAt(..)
+    NUM_EVENTS
+};
+
+// Interrupts, in priority order
+enum {
+    INT_TICK = 0,
+    INT_ENCODER,
+    INT_YAW_REF,
+    INT_BUTTONS,
+    INT_UART,
+    INT_ADC,
+    INT_PWM_MAIN,
+    INT_PWM_TAIL,
+    NUM_INTS
+};
+
+// Small fixed size queue of characters
+template <int SIZE>
+struct CharQueue {
+    char chars[SIZE];
+    uint32_t head;
+    uint32_t tail;
+
+    uint32_t count(void) const { return head - tail; }
+    bool push(char c)
+    {
+        if (count() >= SIZE) {
+            return false;
+        }
+        chars[head++ % SIZE] = c;
+        return true;
+    }
+    char pop(void) { return chars[tail++ % SIZE]; }
+};
+
+static jmp_buf runEnd;
+static bool isRunning = false;
+static bool isStopRequested = false;
+static hal_host_stop_t stopReason;
+static uint64_t now = 0;  // cycles since the start of the run
+static uint64_t endTime = NEVER;
+static uint64_t events[NUM_EVENTS] = {NEVER, NEVER, NEVER, NEVER, NEVER, NEVER, NEVER, NEVER, NEVER, NEVER};
+static bool isFiring = false;
+
+// interrupts
+static hal_handler_t handlers[NUM_INTS];
+static bool isEnabled[NUM_INTS];
+static bool isMasked = false;  // PRIMASK is clear out of reset
+static bool isInInterrupt = false;
+static uint64_t interruptsTaken = 0;
+
+// plant
+static hal_host_plant_t plant = 0;
+static void* plantContext = 0;
+static uint64_t plantPeriod = 0;
+static hal_host_plant_t atCallback = 0;
+static void* atContext = 0;
+
+// timer, SysTick and cycle counter
+static uint32_t timerLoad = 0;
+static uint64_t timerStart = 0;
+static uint64_t cyclesStart = 0;
+static uint64_t tickPeriod = 0;
+static bool isTickPending = false;
+
+// ADC
+static uint32_t adcInput = 0;
+static hal_host_adc_source_t adcSource = 0;
+static void* adcSourceContext = 0;
+static uint32_t adcResult = 0;
+static bool isAdcDone = false;
+
+// PWM
+static uint32_t pwmPeriod = 0;  // counts
+static uint64_t pwmCycles = 0;  // cycles per period
+static uint32_t pwmWidth[HAL_PWM_NUM_CHANNELS];  // set by the firmware
+static uint32_t pwmLatched[HAL_PWM_NUM_CHANNELS];  // on the pin this period
+static bool isPwmOn[HAL_PWM_NUM_CHANNELS];
+static bool isPwmPending[HAL_PWM_NUM_CHANNELS];
+
+// encoder, in quadrature phases 00, B, AB, A going clockwise. From the pins read at
+// start up, quadEncoderIntHandler() counts this order up.
+static const uint32_t encoderLevels[4] = {0, HAL_ENCODER_B, HAL_ENCODER_A | HAL_ENCODER_B, HAL_ENCODER_A};
+static uint32_t encoderPhase = 0;
+static int32_t encoderQueued = 0;  // edges waiting to be taken
+static uint32_t encoderStatus = 0;
+
+// yaw reference
+static bool isYawRefPending = false;
+
+// buttons, pins start at their released levels
+static uint32_t buttonLevels = (UP_BUT_NORMAL << UP) | (DOWN_BUT_NORMAL << DOWN) | (LEFT_BUT_NORMAL << LEFT) |
+                               (RIGHT_BUT_NORMAL << RIGHT) | (SW1_NORMAL << SW1) | (SW2_NORMAL << SW2);
+static uint32_t buttonStatus = 0;
+
+// UART
+static uint64_t uartCharCycles = 0;
+static CharQueue<UART_FIFO_SIZE> txFifo;
+static CharQueue<UART_FIFO_SIZE> rxFifo;
+static CharQueue<UART_RX_QUEUE_SIZE> rxWaiting;
+static bool isUartTxIntEnabled = false;
+static bool isUartTxPending = false;
+static bool isUartRxPending = false;
+static hal_host_uart_sink_t uartSink = 0;
+static void* uartSinkContext = 0;
+
+// OLED
+static char oled[DISPLAY_NUM_LINES][DISPLAY_CHAR_WIDTH + 1];
+
+
+// Return true if interrupt source has something for its handler.
+static bool isPending(int source)
+{
+    switch (source) {
+    case INT_TICK:
+        return isTickPending;
+    case INT_ENCODER:
+        return encoderStatus || encoderQueued;
+    case INT_YAW_REF:
+        return isYawRefPending;
+    case INT_BUTTONS:
+        return buttonStatus != 0;
+    case INT_UART:
+        return (isUartTxPending && isUartTxIntEnabled) || isUartRxPending;
+    case INT_ADC:
+        return isAdcDone;
+    case INT_PWM_MAIN:
+    case INT_PWM_TAIL:
+        return isPwmPending[source - INT_PWM_MAIN];
+    }
+    return false;
+}
+
+
+// Move the next queued encoder edge onto the pins.
+static void encoderTakeEdge(void)
+{
+    uint32_t before = encoderLevels[encoderPhase];
+
+    if (encoderQueued > 0) {
+        encoderPhase = (encoderPhase + 1) % 4;
+        encoderQueued--;
+    } else {
+        encoderPhase = (encoderPhase + 3) % 4;
+        encoderQueued++;
+    }
+    encoderStatus |= before ^ encoderLevels[encoderPhase];
+}
+
+
+static void runHandler(int source)
+{
+    isInInterrupt = true;
+    interruptsTaken++;
+    now += HAL_HOST_ISR_CYCLES;
+    handlers[source]();
+    isInInterrupt = false;
+}
+
+
+// Take the pending interrupts, highest priority first, until none are left.
+static void takeInterrupts(void)
+{
+    bool isTaken = true;
+
+    while (isTaken && !isMasked && !isInInterrupt) {
+        isTaken = false;
+        for (int source = 0; source < NUM_INTS && !isTaken; source++) {
+            if (!isEnabled[source] || !handlers[source] || !isPending(source)) {
+                continue;
+            }
+            if (source == INT_TICK) {
+                isTickPending = false;  // cleared by the hardware on entry
+            } else if (source == INT_ENCODER && !encoderStatus) {
+                encoderTakeEdge();
+            }
+            runHandler(source);
+            isTaken = true;
+        }
+    }
+}
+
+
+// Put a character from the receive queue into the FIFO, or lose it if the FIFO is full.
+static void uartArrive(void)
+{
+    char c = rxWaiting.pop();
+
+    if (rxFifo.push(c)) {
+        isUartRxPending = true;
+    }
+    events[EVENT_UART_RX] = rxWaiting.count() ? events[EVENT_UART_RX] + uartCharCycles : NEVER;
+}
+
+
+// Finish sending a character and start the next.
+static void uartSent(void)
+{
+    char c = txFifo.pop();
+
+    if (uartSink) {
+        uartSink(uartSinkContext, c);
+    }
+    if (txFifo.count() == UART_TX_TRIGGER) {
+        isUartTxPending = true;
+    }
+    events[EVENT_UART_TX] = txFifo.count() ? events[EVENT_UART_TX] + uartCharCycles : NEVER;
+}
+
+
+static void fire(int event)
+{
+    uint64_t at = events[event];
+
+    switch (event) {
+    case EVENT_PLANT:
+        events[event] = at + plantPeriod;
+        plant(plantContext);
+        break;
+    case EVENT_TICK:
+        events[event] = at + tickPeriod;
+        isTickPending = true;
+        break;
+    case EVENT_ADC:
+        events[event] = NEVER;
+        adcResult = adcSource ? adcSource(adcSourceContext) : adcInput;
+        isAdcDone = true;
+        break;
+    case EVENT_PWM_ZERO_MAIN:
+    case EVENT_PWM_ZERO_TAIL:
+        events[event] = at + pwmCycles;
+        pwmLatched[event - EVENT_PWM_ZERO_MAIN] = pwmWidth[event - EVENT_PWM_ZERO_MAIN];
+        break;
+    case EVENT_PWM_LOAD_MAIN:
+    case EVENT_PWM_LOAD_TAIL:
+        events[event] = at + pwmCycles;
+        isPwmPending[event - EVENT_PWM_LOAD_MAIN] = true;
+        break;
+    case EVENT_UART_TX:
+        uartSent();
+        break;
+    case EVENT_UART_RX:
+        uartArrive();
+        break;
+    case EVENT_AT:
+        events[event] = NEVER;
+        atCallback(atContext);
+        break;
+    }
+}
+
+
+// Return the event due next.
+static int nextEvent(void)
+{
+    int next = 0;
+
+    for (int event = 1; event < NUM_EVENTS; event++) {
+        if (events[event] < events[next]) {
+            next = event;
+        }
+    }
+    return next;
+}
+
+
+// Move virtual time on by cycles, firing the events which fall due and taking
+// the interrupts they raise.
+static void advance(uint64_t cycles)
+{
+    now += cycles;
+
+    // a handler run from here moves time on as well, the loop picks up its events
+    if (!isFiring) {
+        isFiring = true;
+        int event = nextEvent();
+        while (events[event] <= now) {
+            fire(event);
+            event = nextEvent();
+        }
+        isFiring = false;
+    }
+    takeInterrupts();
+
+    if (isRunning && (now >= endTime || isStopRequested)) {
+        stopReason = isStopRequested ? HAL_HOST_STOP_REQUESTED : HAL_HOST_STOP_TIME;
+        longjmp(runEnd, 1);
+    }
+}
+
+
+//
+// hal.h
+//
+
+
+void halSystemInit(void)
+{
+}
+
+
+uint32_t halClockGet(void)
+{
+    return HAL_HOST_CLOCK;
+}
+
+
+void halSystemReset(void)
+{
+    stopReason = HAL_HOST_STOP_RESET;
+    longjmp(runEnd, 1);
+}
+
+
+bool halInterruptsDisable(void)
+{
+    bool wasMasked = isMasked;
+
+    isMasked = true;
+    return wasMasked;
+}
+
+
+void halInterruptsEnable(void)
+{
+    isMasked = false;
+    takeInterrupts();
+}
+
+
+void halCyclesInit(void)
+{
+    cyclesStart = now;
+}
+
+
+uint32_t halCycles(void)
+{
+    advance(HAL_HOST_READ_CYCLES);
+    return (uint32_t)(now - cyclesStart);
+}
+
+
+void halTimerInit(uint32_t load)
+{
+    timerLoad = load;
+    timerStart = now;
+}
+
+
+uint32_t halTimerGet(void)
+{
+    advance(HAL_HOST_READ_CYCLES);
+    return timerLoad - (uint32_t)((now - timerStart) % ((uint64_t)timerLoad + 1));
+}
+
+
+// Skip the busy wait to the next event, or to its end if that is sooner.
+void halTimerIdle(uint32_t ticks)
+{
+    uint64_t next = events[nextEvent()];
+    uint64_t skip = next > now ? next - now : 0;
+
+    if (skip > ticks) {
+        skip = ticks;
+    }
+    advance(skip);
+}
+
+
+void halTickInit(uint32_t rate, hal_handler_t handler)
+{
+    handlers[INT_TICK] = handler;
+    isEnabled[INT_TICK] = true;
+    tickPeriod = HAL_HOST_CLOCK / rate;
+    events[EVENT_TICK] = now + tickPeriod;
+}
+
+
+void halAdcInit(hal_handler_t handler)
+{
+    handlers[INT_ADC] = handler;
+    isEnabled[INT_ADC] = true;
+}
+
+
+void halAdcTrigger(void)
+{
+    events[EVENT_ADC] = now + ADC_CONVERSION_CYCLES;
+}
+
+
+uint32_t halAdcRead(void)
+{
+    isAdcDone = false;
+    return adcResult;
+}
+
+
+uint32_t halPwmInit(uint32_t channel, uint32_t frequency, hal_handler_t handler)
+{
+    pwmPeriod = HAL_HOST_CLOCK / PWM_DIVIDER / frequency;
+    pwmCycles = (uint64_t)pwmPeriod * PWM_DIVIDER;
+    handlers[INT_PWM_MAIN + channel] = handler;
+    isEnabled[INT_PWM_MAIN + channel] = true;
+    pwmWidth[channel] = 0;
+    isPwmOn[channel] = false;
+    events[EVENT_PWM_ZERO_MAIN + channel] = now + pwmCycles;
+    events[EVENT_PWM_LOAD_MAIN + channel] = now + pwmCycles / 2;
+    return pwmPeriod;
+}
+
+
+void halPwmIntClear(uint32_t channel)
+{
+    isPwmPending[channel] = false;
+}
+
+
+void halPwmSetWidth(uint32_t channel, uint32_t width)
+{
+    pwmWidth[channel] = width;
+}
+
+
+void halPwmSetOutput(uint32_t channel, bool isOn)
+{
+    isPwmOn[channel] = isOn;
+}
+
+
+uint32_t halEncoderInit(hal_handler_t handler)
+{
+    handlers[INT_ENCODER] = handler;
+    isEnabled[INT_ENCODER] = true;
+    return encoderLevels[encoderPhase];
+}
+
+
+uint32_t halEncoderIntStatus(void)
+{
+    uint32_t status = encoderStatus;
+
+    encoderStatus = 0;
+    return status;
+}
+
+
+void halYawRefInit(hal_handler_t handler)
+{
+    handlers[INT_YAW_REF] = handler;
+}
+
+
+void halYawRefEnable(void)
+{
+    isEnabled[INT_YAW_REF] = true;
+}
+
+
+void halYawRefDisable(void)
+{
+    isEnabled[INT_YAW_REF] = false;
+    isYawRefPending = false;
+}
+
+
+void halButtonsInit(hal_handler_t handler)
+{
+    handlers[INT_BUTTONS] = handler;
+    isEnabled[INT_BUTTONS] = true;
+}
+
+
+uint32_t halButtonsIntStatus(void)
+{
+    uint32_t status = buttonStatus;
+
+    buttonStatus = 0;
+    return status;
+}
+
+
+uint32_t halButtonsRead(void)
+{
+    return buttonLevels;
+}
+
+
+void halUartInit(uint32_t baud, hal_handler_t handler)
+{
+    handlers[INT_UART] = handler;
+    isEnabled[INT_UART] = true;
+    isUartTxIntEnabled = true;
+    uartCharCycles = (uint64_t)HAL_HOST_CLOCK * UART_BITS_PER_CHAR / baud;
+}
+
+
+uint32_t halUartIntStatus(void)
+{
+    uint32_t status = (isUartTxPending ? HAL_UART_INT_TX : 0) | (isUartRxPending ? HAL_UART_INT_RX : 0);
+
+    isUartTxPending = false;
+    isUartRxPending = false;
+    return status;
+}
+
+
+void halUartSetTxInt(bool isEnabled)
+{
+    isUartTxIntEnabled = isEnabled;
+}
+
+
+bool halUartSpaceAvail(void)
+{
+    return txFifo.count() < UART_FIFO_SIZE;
+}
+
+
+void halUartPut(char c)
+{
+    if (!txFifo.count()) {
+        events[EVENT_UART_TX] = now + uartCharCycles;
+    }
+    txFifo.push(c);
+}
+
+
+bool halUartCharsAvail(void)
+{
+    return rxFifo.count() != 0;
+}
+
+
+char halUartGet(void)
+{
+    return rxFifo.pop();
+}
+
+
+void halOledInit(void)
+{
+    memset(oled, ' ', sizeof(oled));
+    for (int row = 0; row < DISPLAY_NUM_LINES; row++) {
+        oled[row][DISPLAY_CHAR_WIDTH] = '\0';
+    }
+}
+
+
+void halOledDraw(const char* str, uint32_t col, uint32_t row)
+{
+    for (; *str && row < DISPLAY_NUM_LINES && col < DISPLAY_CHAR_WIDTH; str++, col++) {
+        oled[row][col] = *str;
+    }
+}
+
+
+//
+// halHost.h
+//
+
+
+hal_host_stop_t halHostRun(int (*entry)(void), double seconds)
+{
+    endTime = now + (uint64_t)(seconds * HAL_HOST_CLOCK);
+    if (setjmp(runEnd) == 0) {
+        isRunning = true;
+        entry();
+        stopReason = HAL_HOST_STOP_RETURNED;
+    }
+    isRunning = false;
+    isInInterrupt = false;
+    return stopReason;
+}
+
+
+void halHostStop(void)
+{
+    isStopRequested = true;
+}
+
+
+void halHostSetPlant(uint32_t periodUs, hal_host_plant_t update, void* context)
+{
+    plant = update;
+    plantContext = context;
+    plantPeriod = (uint64_t)periodUs * (HAL_HOST_CLOCK / 1000000);
+    events[EVENT_PLANT] = update ? now + plantPeriod : NEVER;
+}
+
+
+void halHostAt(uint64_t cycle, hal_host_plant_t callback, void* context)
+{
+    atCallback = callback;
+    atContext = context;
+    events[EVENT_AT] = callback ? cycle : NEVER;
+}
+
+
+uint64_t halHostCycles(void)
+{
+    return now;
+}
+
+
+uint64_t halHostTimerStart(void)
+{
+    return timerStart;
+}
+
+
+double halHostSeconds(void)
+{
+    return (double)now / HAL_HOST_CLOCK;
+}
+
+
+void halHostBurn(uint32_t cycles)
+{
+    advance(cycles);
+}
+
+
+void halHostSetAdc(uint32_t value)
+{
+    adcInput = value > ADC_MAX ? ADC_MAX : value;
+}
+
+
+void halHostSetAdcSource(hal_host_adc_source_t source, void* context)
+{
+    adcSource = source;
+    adcSourceContext = context;
+}
+
+
+void halHostEncoderMove(int32_t edges)
+{
+    encoderQueued += edges;
+}
+
+
+void halHostEncoderEdge(uint32_t pins)
+{
+    uint32_t levels = encoderLevels[encoderPhase] ^ pins;
+
+    for (uint32_t phase = 0; phase < 4; phase++) {
+        if (encoderLevels[phase] == levels) {
+            encoderPhase = phase;
+        }
+    }
+    encoderStatus |= pins;
+}
+
+
+void halHostYawRefPass(void)
+{
+    if (isEnabled[INT_YAW_REF]) {
+        isYawRefPending = true;
+    }
+}
+
+
+void halHostSetButton(uint32_t button, bool isHigh)
+{
+    uint32_t bit = 1 << button;
+
+    if (((buttonLevels & bit) != 0) != isHigh) {
+        buttonLevels ^= bit;
+        buttonStatus |= bit;
+    }
+}
+
+
+void halHostUartReceive(const char* data, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        if (!rxWaiting.count()) {
+            events[EVENT_UART_RX] = now + uartCharCycles;
+        }
+        rxWaiting.push(data[i]);
+    }
+}
+
+
+void halHostUartArrive(char c)
+{
+    if (rxFifo.push(c)) {
+        isUartRxPending = true;
+    }
+}
+
+
+uint32_t halHostPwmPeriod(void)
+{
+    return pwmPeriod;
+}
+
+
+uint32_t halHostPwmWidth(uint32_t channel)
+{
+    return pwmLatched[channel];
+}
+
+
+bool halHostPwmIsOn(uint32_t channel)
+{
+    return isPwmOn[channel];
+}
+
+
+double halHostPwmDuty(uint32_t channel)
+{
+    return isPwmOn[channel] && pwmPeriod ? (double)pwmLatched[channel] / pwmPeriod : 0;
+}
+
+
+void halHostSetUartSink(hal_host_uart_sink_t sink, void* context)
+{
+    uartSink = sink;
+    uartSinkContext = context;
+}
+
+
+const char* halHostOledLine(uint32_t row)
+{
+    return row < DISPLAY_NUM_LINES ? oled[row] : "";
+}
+
+
+uint64_t halHostInterrupts(void)
+{
+    return interruptsTaken;
+}
@@ -0,0 +1,146 @@
+// ************************************************************
+// halHost.h
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Run the firmware on a PC, with the rig and the operator simulated
+// by the host tool.
+// Explaination: halHost.cpp implements hal.h in virtual time, counted in
+// cycles of the board's 20 MHz clock. Time only moves on when the firmware
+// reads the timer or the cycle counter (HAL_HOST_READ_CYCLES per read), when
+// it busy waits (straight to the next event), or when a tool charges it for
+// work with halHostBurn(..). So a run gives the same results every time, and
+// runs much faster than real time, but the processor load it shows is only
+// what was charged. The peripherals raise their interrupts at the times the
+// board would: SysTick, ADC conversions, PWM periods (the width set in the
+// period interrupt is latched at the next period), UART characters at the
+// baud rate, encoder edges, the yaw reference and the buttons. Interrupts are
+// taken between reads of the timer while they are unmasked, one at a time.
+//
+// The tool builds main.c with main renamed to firmwareMain (see Makefile) and
+// calls halHostRun(..), which returns when the time is up. The world outside
+// the board is a plant function called every plant period, which reads the
+// outputs and drives the inputs below. Module state is static, so a process
+// can only run the firmware once.
+// ************************************************************
+
+#ifndef HALHOST_H_
+#define HALHOST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HAL_HOST_CLOCK 20000000  // Hz, as the board
+#define HAL_HOST_READ_CYCLES 20  // charged for each read of the timer or cycle counter
+#define HAL_HOST_ISR_CYCLES 24  // charged for entering and leaving an interrupt
+
+// Why halHostRun(..) returned
+typedef enum {
+    HAL_HOST_STOP_TIME = 0,  // the time was up
+    HAL_HOST_STOP_REQUESTED,  // halHostStop() was called
+    HAL_HOST_STOP_RESET,  // the firmware called halSystemReset()
+    HAL_HOST_STOP_RETURNED  // the entry function returned
+} hal_host_stop_t;
+
+typedef void (*hal_host_plant_t)(void* context);
+typedef void (*hal_host_uart_sink_t)(void* context, char c);
+typedef uint32_t (*hal_host_adc_source_t)(void* context);
+
+
+// The firmware's main(), renamed when main.c is built for the host.
+int firmwareMain(void);
+
+
+// Running
+
+// Run entry, normally firmwareMain, until seconds of virtual time have passed.
+hal_host_stop_t halHostRun(int (*entry)(void), double seconds);
+
+// End the run at the next read of the timer. Can be called by the plant.
+void halHostStop(void);
+
+// Call plant every periodUs of virtual time, from the start of the run.
+void halHostSetPlant(uint32_t periodUs, hal_host_plant_t plant, void* context);
+
+// Call callback once when the virtual time reaches cycle, in place of any call
+// still waiting. An input raised from it is taken at the first point the
+// firmware could take one on or after cycle, so a recorded input can be
+// raised at the time its interrupt was taken.
+void halHostAt(uint64_t cycle, hal_host_plant_t callback, void* context);
+
+// Return the virtual time since the start of the run.
+uint64_t halHostCycles(void);
+double halHostSeconds(void);
+
+// Return the virtual time at which the firmware started the timer.
+uint64_t halHostTimerStart(void);
+
+// Charge cycles of processor time, as if the code calling it took that long.
+void halHostBurn(uint32_t cycles);
+
+
+// Inputs
+
+// Set the value the next ADC conversions return, 0 to 4095.
+void halHostSetAdc(uint32_t value);
+
+// Take the result of each ADC conversion from source instead, or from
+// halHostSetAdc(..) again if source is 0.
+void halHostSetAdcSource(hal_host_adc_source_t source, void* context);
+
+// Turn the encoder by edges, positive clockwise, which the firmware counts up as
+// positive yaw. Each edge is one interrupt, queued until the firmware has taken
+// the one before.
+void halHostEncoderMove(int32_t edges);
+
+// Make an edge now on each encoder channel in pins (HAL_ENCODER_A and B bits),
+// as a recording saw it, rather than turning the encoder.
+void halHostEncoderEdge(uint32_t pins);
+
+// Pass the yaw reference, a falling edge on its pin.
+void halHostYawRefPass(void);
+
+// Set the pin of a button (butNames) high or low.
+void halHostSetButton(uint32_t button, bool isHigh);
+
+// Send characters to the firmware's UART. They arrive at the baud rate.
+void halHostUartReceive(const char* data, uint32_t length);
+
+// Put a character straight into the UART's receive FIFO, as a recording saw it arrive.
+void halHostUartArrive(char c);
+
+
+// Outputs
+
+// Return the PWM period in counts, and the width latched for the current period.
+uint32_t halHostPwmPeriod(void);
+uint32_t halHostPwmWidth(uint32_t channel);
+
+// Return true if the output of a PWM channel is on.
+bool halHostPwmIsOn(uint32_t channel);
+
+// Return the duty cycle on the pin, from 0 to 1. Zero while the output is off.
+double halHostPwmDuty(uint32_t channel);
+
+// Call sink with each character as the UART finishes sending it.
+void halHostSetUartSink(hal_host_uart_sink_t sink, void* context);
+
+// Return a row of the OLED display, DISPLAY_CHAR_WIDTH characters.
+const char* halHostOledLine(uint32_t row);
+
+// Return the number of interrupts taken.
+uint64_t halHostInterrupts(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HALHOST_H_ */
@@ -0,0 +1,67 @@
+// ************************************************************
+// ustdlib.c
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: The parts of TivaWare's ustdlib the firmware uses, on the host.
+// Explaination: The firmware only uses %c, %d, %i, %s, %u, %x and %X with an
+// optional zero flag and width, which vsnprintf formats the same way, except
+// that TivaWare pads a string on the right. The format is copied with a '-'
+// flag added to each %s, then passed on to vsnprintf.
+// ************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "utils/ustdlib.h"
+
+#define FORMAT_LENGTH 256  // longest format the firmware uses, with room for the flags
+
+
+// As TivaWare's uvsnprintf(..): vsnprintf, except that %s pads on the right.
+int uvsnprintf(char* buffer, size_t size, const char* format, va_list args)
+{
+    char hostFormat[FORMAT_LENGTH];
+    size_t length = 0;
+    const char* c = format;
+
+    while (*c && length < FORMAT_LENGTH - 2) {
+        if (*c != '%') {
+            hostFormat[length++] = *c++;
+            continue;
+        }
+
+        // copy the conversion, adding the flag if it turns out to be a string
+        const char* start = c++;
+        while (*c == '0' || (*c >= '1' && *c <= '9')) {
+            c++;
+        }
+        if (*c == 's' && c - start > 1 && length + (c - start) + 2 < FORMAT_LENGTH) {
+            hostFormat[length++] = '%';
+            hostFormat[length++] = '-';
+            start++;
+        }
+        while (start <= c && *start && length < FORMAT_LENGTH - 1) {
+            hostFormat[length++] = *start++;
+        }
+        if (*c) {
+            c++;
+        }
+    }
+    hostFormat[length] = '\0';
+
+    return vsnprintf(buffer, size, hostFormat, args);
+}
+
+
+// As TivaWare's usnprintf(..).
+int usnprintf(char* buffer, size_t size, const char* format, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, format);
+    length = uvsnprintf(buffer, size, format, args);
+    va_end(args);
+    return length;
+}
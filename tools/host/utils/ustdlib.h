@@ -0,0 +1,33 @@
+// ************************************************************
+// ustdlib.h
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: The parts of TivaWare's utils/ustdlib.h the firmware uses, for
+// building the firmware modules on the host.
+// Explaination: Found before TivaWare's header through the include path of
+// tools/Makefile. See ustdlib.c.
+// ************************************************************
+
+#ifndef USTDLIB_H_
+#define USTDLIB_H_
+
+#include <stdarg.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// As TivaWare's uvsnprintf(..): vsnprintf, except that %s pads on the right.
+int uvsnprintf(char* buffer, size_t size, const char* format, va_list args);
+
+// As TivaWare's usnprintf(..).
+int usnprintf(char* buffer, size_t size, const char* format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USTDLIB_H_ */
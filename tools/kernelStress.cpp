@@ -0,0 +1,215 @@
+// ************************************************************
+// kernelStress.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Check that the scheduler sheds load when it is overloaded, and
+// recovers once the load goes away.
+// Explaination: kernel.c is run on the host backend of the HAL with a task
+// table like flying mode's: a control task at the full rate which is never
+// shed, and sheddable display and telemetry tasks. The tasks charge the
+// virtual time they would take with halHostBurn(..). For OVERLOAD_START to
+// OVERLOAD_END the display task takes longer than a whole frame. Each run is
+// forked, as the kernel's state is static, once with shedding off and once
+// with the policy set by the S command. Checks that
+//   - control runs in every frame, with its full rate deltaTime, in both runs
+//   - with shedding on, the level goes up to the maximum during the overload,
+//     and overrun frames drop to about 1 in 2^level
+//   - the level comes back down to 0 once the load goes away
+// Prints the shed level once a second. Returns non zero if any check fails.
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "halHost.h"
+#include "../kernel.h"
+#include "../timerer.h"
+
+#define BASE_FREQ 100  // Hz, as TASK_BASE_FREQ
+#define FRAME_CYCLES (HAL_HOST_CLOCK / BASE_FREQ)
+#define RUN_SECONDS 7
+#define OVERLOAD_START 1.0  // s
+#define OVERLOAD_END 2.0
+#define RECOVER_FRAMES 50
+#define CONTROL_CYCLES (FRAME_CYCLES / 10)
+#define DISPLAY_CYCLES (FRAME_CYCLES / 5)
+#define OVERLOAD_CYCLES (FRAME_CYCLES * 5 / 4)  // the display task alone overruns the frame
+#define TELEMETRY_CYCLES (FRAME_CYCLES / 10)
+
+// What one run saw, sent back from the forked child
+struct Result {
+    uint32_t controlRuns;
+    uint32_t badDeltas;  // control runs whose deltaTime was not the frame time
+    uint32_t overloadFrames;  // frames between OVERLOAD_START and OVERLOAD_END
+    uint32_t overloadMisses;  // of which overran
+    uint32_t overloadLevel;  // shed level in the last overloaded frame
+    uint32_t levelAt[RUN_SECONDS + 1];  // shed level at the start of each second
+    kernel_shed_stats_t stats;
+    uint32_t frames;
+};
+
+static Result result;
+static uint32_t maxShedLevel;
+static uint32_t missesAtStart;
+static bool isOverloadCounted = false;
+static int32_t lastSecond = -1;
+static int failures = 0;
+
+
+static bool isOverloaded(void)
+{
+    double now = halHostSeconds();
+    return now >= OVERLOAD_START && now < OVERLOAD_END;
+}
+
+
+static void controlTask(state_t* state, uint32_t deltaTime)
+{
+    kernel_shed_stats_t stats;
+    kernelGetShedStats(&stats);
+
+    int32_t second = (int32_t)halHostSeconds();
+    if (second != lastSecond && second <= RUN_SECONDS) {
+        result.levelAt[second] = stats.level;
+        lastSecond = second;
+    }
+    if (halHostSeconds() < OVERLOAD_START) {
+        missesAtStart = stats.deadlineMisses;
+    } else if (isOverloaded()) {
+        result.overloadFrames++;
+        result.overloadLevel = stats.level;
+    } else if (!isOverloadCounted) {
+        result.overloadMisses = stats.deadlineMisses - missesAtStart;
+        isOverloadCounted = true;
+    }
+
+    result.controlRuns++;
+    if (deltaTime != 1000 / BASE_FREQ) {
+        result.badDeltas++;
+    }
+    halHostBurn(CONTROL_CYCLES);
+}
+
+
+static void displayTask(state_t* state, uint32_t deltaTime)
+{
+    halHostBurn(isOverloaded() ? OVERLOAD_CYCLES : DISPLAY_CYCLES);
+}
+
+
+static void telemetryTask(state_t* state, uint32_t deltaTime)
+{
+    halHostBurn(TELEMETRY_CYCLES);
+}
+
+
+static int schedulerMain(void)
+{
+    timererInit();
+    kernelSetShedPolicy(maxShedLevel, RECOVER_FRAMES);
+
+    task_t tasks[] = {
+        {controlTask, 100, false},
+        {displayTask, 100, true},
+        {telemetryTask, 50, true},
+        {0}
+    };
+    state_t sharedState = {.heliMode = STATE_FLYING};
+
+    runTasks(tasks, &sharedState, BASE_FREQ);
+    return 0;
+}
+
+
+// Run the scheduler in a child process and return what it saw.
+static Result runForked(uint32_t maxLevel)
+{
+    int fds[2];
+    Result got = {};
+
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        exit(EXIT_FAILURE);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        maxShedLevel = maxLevel;
+        halHostRun(schedulerMain, RUN_SECONDS);
+        kernelGetShedStats(&result.stats);
+        kernel_load_t load;
+        kernelGetLoad(STATE_FLYING, &load);
+        result.frames = load.frames;
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == sizeof(result) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    close(fds[1]);
+    ssize_t length = read(fds[0], &got, sizeof(got));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (length != sizeof(got) || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        fprintf(stderr, "run with shed level %u failed\n", maxLevel);
+        exit(EXIT_FAILURE);
+    }
+    return got;
+}
+
+
+static void check(bool isOk, const char* what)
+{
+    if (!isOk) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+
+static void print(const char* name, const Result& r)
+{
+    printf("%-12s frames %u, control runs %u, overrun frames %u (%u of %u in the overload), shed runs %u, level by second",
+           name, r.frames, r.controlRuns, r.stats.deadlineMisses, r.overloadMisses, r.overloadFrames, r.stats.shedRuns);
+    for (int second = 0; second < RUN_SECONDS; second++) {
+        printf(" %u", r.levelAt[second]);
+    }
+    printf("\n");
+}
+
+
+int main(void)
+{
+    Result off = runForked(0);
+    Result on = runForked(KERNEL_MAX_SHED_LEVEL);
+    print("shedding off", off);
+    print("shedding on", on);
+
+    // control keeps its rate whatever happens to the other tasks
+    // (the run can end after control in the last frame, before the frame is counted)
+    check(off.controlRuns - off.frames <= 1 && on.controlRuns - on.frames <= 1, "control ran in every frame");
+    check(off.badDeltas == 0 && on.badDeltas == 0, "control deltaTime was the frame time");
+
+    // without shedding every overloaded frame overruns
+    check(off.stats.shedRuns == 0 && off.stats.maxLevel == 0, "nothing shed with shedding off");
+    check(off.overloadMisses + 1 >= off.overloadFrames, "every overloaded frame overruns with shedding off");
+
+    // with it, the level climbs and only about 1 in 2^level frames overrun
+    check(on.stats.maxLevel == KERNEL_MAX_SHED_LEVEL, "shed level reached the maximum");
+    check(on.overloadLevel == KERNEL_MAX_SHED_LEVEL, "shed level held during the overload");
+    check(on.overloadMisses * 4 < off.overloadMisses, "shedding cut the overrun frames by 4 times or more");
+    check(on.stats.shedRuns > 0, "sheddable tasks were shed");
+
+    // and recovers once the load goes away
+    check(on.levelAt[RUN_SECONDS - 1] == 0, "shed level came back to 0");
+    check(on.stats.level == 0, "shed level is 0 at the end");
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("all checks passed\n");
+    return EXIT_SUCCESS;
+}
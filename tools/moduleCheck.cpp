@@ -0,0 +1,542 @@
+// ************************************************************
+// moduleCheck.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Check the hardware-free firmware modules on the host.
+// Explaination: Each check drives a module with known inputs and compares
+// what it does against a direct model of what it should do. Returns non zero
+// if any check fails.
+//   pwmDither: the average pulse width the generator outputs converges on the
+//   target, with the width halved and doubled again as in up/down count mode.
+//   stepAnalysis: a ramp and an overshooting response give the metrics worked
+//   out by hand.
+//   trajectory: for the height and yaw limits in control.c, steps of every size
+//   and targets changed mid move never exceed the velocity or acceleration
+//   limit, never pass the target, and arrive close to the minimum time.
+//   windowStats: the mean and variance of random samples with random durations
+//   match a direct two pass computation over the same time window.
+//   landingController: a suite of noisy landings is run through the windowed
+//   detector and the consecutive in-band tick counter it replaced, which is
+//   kept here as it was. The windowed detector must land sooner on average and
+//   never before the heli has actually settled.
+//   lineFormat: random layouts and values give the same output and length as
+//   snprintf, truncated or not, and the layouts in main.c are timed against
+//   vsnprintf. uvsnprintf itself is not available on the host. For the
+//   conversions lineFormat supports it matches snprintf, except that a %s field
+//   is padded on the right, which is "%-Ns" to snprintf.
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <climits>
+#include <string>
+#include <deque>
+#include <chrono>
+
+#include "../pwmDither.h"
+#include "../stepAnalysis.h"
+#include "../lineFormat.h"
+#include "../trajectory.h"
+#include "../landingController.h"
+
+#define PWM_PERIOD 20000  // counts, the 20 MHz clock / 4 / 250 Hz as in pwmInit(..)
+#define PWM_PERIODS 2048  // periods averaged for each duty cycle
+#define DUTY_PRECISION 1000  // as control.c passes duty cycles
+#define DUTY_STEP 7  // duty cycles checked, in 1/DUTY_PRECISION %
+#define PRECISION 1000  // as control.h
+#define CONTROL_PERIOD 10  // ms between trajectory updates, the 100 Hz control rate
+#define TRAJECTORY_SLACK 2  // updates lost to rounding and to the velocity changing once per update
+#define WINDOW_TRIALS 200
+#define WINDOW_SAMPLES 2000
+#define LANDING_PERIOD 10  // ms, landing runs in the 100 Hz main task
+#define LANDING_SEEDS 20  // landings for each noise level
+#define LANDING_MAX_TIME 10000  // ms, longer than the detectors' time out
+#define OLD_STABILITY_TIME 500  // ms, STABILITY_TIME_MAIN of the replaced detector
+#define OLD_TIME_OUT 7500  // ms
+#define YAW_BAND 2  // degrees, YAW_STABILITY_ERROR
+#define HEIGHT_BAND 1  // %, HEIGHT_STABILITY_ERROR
+#define FORMAT_TRIALS 20000
+#define FORMAT_TIMING_LINES 200000
+#define MAX_LINE 48
+
+static int failures = 0;
+static uint32_t randomState = 1;
+
+
+static void check(bool isOk, const char* what)
+{
+    if (!isOk) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+
+// Repeatable pseudo random numbers, so a failure can be reproduced.
+static uint32_t nextRandom(void)
+{
+    randomState = randomState * 1103515245 + 12345;
+    return randomState >> 16;
+}
+
+
+// The width the generator outputs for a PWMPulseWidthSet(..) width in up/down mode.
+static uint32_t upDownWidth(uint32_t width)
+{
+    return width / 2 * 2;
+}
+
+
+// For each duty cycle, the average width over PWM_PERIODS periods is compared with
+// the exact width. Truncating to whole counts, as before dithering, is shown for
+// comparison.
+static void checkPwmDither(void)
+{
+    double maxError = 0, maxTruncatedError = 0, sumError = 0;
+    uint32_t numDuties = 0;
+
+    for (uint32_t duty = 5 * DUTY_PRECISION; duty <= 95 * DUTY_PRECISION; duty += DUTY_STEP) {
+        uint32_t target = (uint64_t)PWM_PERIOD * duty * PWM_DITHER_ONE / 100 / DUTY_PRECISION;
+        double exact = (double)PWM_PERIOD * duty / 100 / DUTY_PRECISION;
+        pwm_dither_t dither = {0, 0};
+        uint64_t total = 0;
+
+        pwmDitherSetTarget(&dither, target);
+        for (uint32_t i = 0; i < PWM_PERIODS; i++) {
+            uint32_t width = pwmDitherNext(&dither);
+            check(width % PWM_WIDTH_STEP == 0, "whole width steps");
+            total += upDownWidth(width);
+        }
+
+        double error = fabs((double)total / PWM_PERIODS - exact);
+        double truncatedError = fabs(upDownWidth(target / PWM_DITHER_ONE) - exact);
+        maxError = error > maxError ? error : maxError;
+        maxTruncatedError = truncatedError > maxTruncatedError ? truncatedError : maxTruncatedError;
+        sumError += error;
+        numDuties++;
+    }
+
+    // the carried remainder is under one step, and the target is truncated to 1/PWM_DITHER_ONE
+    check(maxError <= (double)PWM_WIDTH_STEP / PWM_PERIODS + 1.0 / PWM_DITHER_ONE, "average width converges");
+    printf("pwmDither: %u duty cycles over %d periods, mean error %.4f counts, max %.4f counts (%.5f %% duty), "
+           "truncated max %.2f counts\n", numDuties, PWM_PERIODS, sumError / numDuties, maxError,
+           maxError * 100 / PWM_PERIOD, maxTruncatedError);
+}
+
+
+// Feed a 0 to 10 % step, sampled every 10 ms: a ramp to 10 % over 1 s, or a ramp to
+// 12 % over 1.2 s that falls back to 10 % over the next 0.4 s.
+static bool analyseStep(bool isOvershooting, step_metrics_t* metrics)
+{
+    step_analysis_t analysis;
+    bool isComplete = false;
+
+    stepAnalysisReset(&analysis, 0);
+    for (uint32_t time = 0; time <= STEP_TIME_OUT && !isComplete; time += 10) {
+        int32_t measured = time * 10;
+        if (!isOvershooting && time > 1000)
+            measured = 10000;
+        if (isOvershooting && time > 1200)
+            measured = time < 1600 ? 12000 - (time - 1200) * 5 : 10000;
+        isComplete = stepAnalysisUpdate(&analysis, 10, measured, 1000 + time, metrics);
+    }
+    return isComplete;
+}
+
+
+static void checkStepAnalysis(void)
+{
+    step_metrics_t ramp, overshoot;
+
+    // 10 % at 100 ms and 90 % at 900 ms; last outside the 9.5 to 10.5 % band at 940 ms;
+    // the error is the -1.5 % summed over the end of the ramp, over the 200 samples in band
+    check(analyseStep(false, &ramp) && ramp.startTime == 1000 && ramp.stepSize == 10 && ramp.riseTime == 800 &&
+          ramp.overshoot == 0 && ramp.settlingTime == 940 && ramp.steadyStateError == -7, "ramp step metrics");
+    // peak of 12 % is 20 % over; last outside the band at 1000 ms rising and 1490 ms falling
+    check(analyseStep(true, &overshoot) && overshoot.riseTime == 800 && overshoot.overshoot == 20 &&
+          overshoot.settlingTime == 1490, "overshooting step metrics");
+    printf("stepAnalysis: ramp rise %u ms, settling %u ms, error %d; overshoot %d %%, settling %u ms\n",
+           ramp.riseTime, ramp.settlingTime, ramp.steadyStateError, overshoot.overshoot, overshoot.settlingTime);
+}
+
+
+// Gaussian noise with a standard deviation of one.
+static double nextGaussian(void)
+{
+    double u = (nextRandom() + 1.0) / 65537.0, v = (nextRandom() + 1.0) / 65537.0;
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+
+static void checkWindowStats(void)
+{
+    double worstMean = 0, worstVariance = 0;
+
+    for (uint32_t trial = 0; trial < WINDOW_TRIALS; trial++) {
+        uint32_t windowTime = trial % 2 ? 300 : 1000;
+        int32_t scale = trial % 3 == 0 ? 1 << 24 : trial % 3 == 1 ? 200000 : 3;
+        window_stats_t window;
+        std::deque<std::pair<int32_t, uint32_t> > samples;  // value, duration
+        uint32_t totalTime = 0;
+
+        windowStatsInit(&window, windowTime);
+        for (uint32_t i = 0; i < WINDOW_SAMPLES; i++) {
+            int32_t sample = (int32_t)(((int64_t)(nextRandom() % 20001) - 10000) * scale / 10000);
+            uint32_t duration = 1 + nextRandom() % 50;
+            windowStatsAdd(&window, sample, duration);
+
+            // the same window: the fewest newest samples which cover windowTime, at most 64
+            samples.push_back(std::make_pair(sample, duration));
+            totalTime += duration;
+            while (samples.size() > WINDOW_STATS_MAX_SAMPLES ||
+                    (samples.size() > 1 && totalTime - samples.front().second >= windowTime)) {
+                totalTime -= samples.front().second;
+                samples.pop_front();
+            }
+
+            double mean = 0, variance = 0;
+            for (size_t j = 0; j < samples.size(); j++)
+                mean += samples[j].first;
+            mean /= samples.size();
+            for (size_t j = 0; j < samples.size(); j++)
+                variance += (samples[j].first - mean) * (samples[j].first - mean);
+            variance /= samples.size();
+
+            double meanError = fabs(windowStatsMean(&window) - mean);
+            double varianceError = fabs((double)windowStatsVariance(&window) - variance);
+            worstMean = meanError > worstMean ? meanError : worstMean;
+            worstVariance = varianceError > worstVariance ? varianceError : worstVariance;
+            check(windowStatsIsFull(&window) == (totalTime >= windowTime), "window full");
+        }
+    }
+    // both are rounded once, the variance to within one unit of the exact value
+    check(worstMean < 1 && worstVariance < 1 + 1e-9 * (1 << 24) * (1 << 24), "window mean and variance");
+    printf("windowStats: %d windows, worst mean error %.3f, worst variance error %.3f\n", WINDOW_TRIALS, worstMean,
+           worstVariance);
+}
+
+
+// The detector replaced by the windowed one: stable after OLD_STABILITY_TIME of
+// consecutive ticks with the height under 1 % and the yaw in band.
+struct TickCountDetector {
+    uint32_t stabilityCounter;
+    uint32_t landingTime;
+
+    bool isStable(int32_t yawDegrees, int32_t heightPercentage)
+    {
+        if (heightPercentage <= HEIGHT_BAND * PRECISION) {
+            int32_t yaw = abs(yawDegrees) % (360 * PRECISION);
+            if (yaw <= YAW_BAND * PRECISION || yaw >= (360 - YAW_BAND) * PRECISION)
+                stabilityCounter++;
+            else
+                stabilityCounter = 0;
+            if (++landingTime >= OLD_TIME_OUT / LANDING_PERIOD)
+                return true;
+        } else {
+            stabilityCounter = 0;
+        }
+        return stabilityCounter >= OLD_STABILITY_TIME / LANDING_PERIOD;
+    }
+};
+
+
+// One landing from when the height target is set to 0: the height decays to the
+// ground and the yaw rings down about a whole rotation, each with sensor noise,
+// and the yaw with occasional single bad samples. Returns the ms each detector
+// took, and the ms after which the noise free height and yaw stayed in band.
+static void runLanding(double heightNoise, double yawNoise, double spikeChance, uint32_t* oldTime,
+                       uint32_t* newTime, uint32_t* settledTime)
+{
+    state_t state = {STATE_DESCENDING, 0, 360, 0, 0};
+    landing_controller_t landing;
+    TickCountDetector old = {0, 0};
+    double startHeight = 5 + nextRandom() % 10, startYaw = (double)(nextRandom() % 800) / 100 - 4;
+    double heightTau = 300 + nextRandom() % 400, yawTau = 200 + nextRandom() % 500;
+
+    landingControllerReset(&landing);
+    *oldTime = *newTime = *settledTime = 0;
+    for (uint32_t time = LANDING_PERIOD; time <= LANDING_MAX_TIME && (!*oldTime || !*newTime);
+            time += LANDING_PERIOD) {
+        double height = startHeight * exp(-(double)time / heightTau);
+        double yaw = startYaw * exp(-(double)time / yawTau) * cos(time / 150.0);
+        if (height > HEIGHT_BAND || fabs(yaw) > YAW_BAND)
+            *settledTime = time;
+
+        double measuredYaw = 360 + yaw + yawNoise * nextGaussian();
+        if (nextRandom() % 1000 < spikeChance * 1000)
+            measuredYaw += nextRandom() % 2 ? 3 : -3;
+        int32_t heightPercentage = (int32_t)((height + heightNoise * nextGaussian()) * PRECISION);
+        int32_t yawDegrees = (int32_t)(measuredYaw * PRECISION);
+
+        if (!*oldTime && old.isStable(yawDegrees, heightPercentage))
+            *oldTime = time;
+        if (!*newTime && landingControllerIsStable(&landing, &state, LANDING_PERIOD, yawDegrees, heightPercentage))
+            *newTime = time;
+    }
+}
+
+
+static void checkLandingDetector(void)
+{
+    const double heightNoises[] = {0.1, 0.3, 0.5};  // % standard deviation
+    const double yawNoises[] = {0.2, 0.5, 0.8};  // degrees
+    const double spikeChances[] = {0, 0.02, 0.05};  // of a 3 degree bad sample each tick
+    uint64_t oldTotal = 0, newTotal = 0;
+    uint32_t landings = 0, oldTimeOuts = 0, newTimeOuts = 0, early = 0;
+
+    for (size_t h = 0; h < sizeof(heightNoises) / sizeof(heightNoises[0]); h++) {
+        for (size_t y = 0; y < sizeof(yawNoises) / sizeof(yawNoises[0]); y++) {
+            for (size_t c = 0; c < sizeof(spikeChances) / sizeof(spikeChances[0]); c++) {
+                for (int seed = 0; seed < LANDING_SEEDS; seed++) {
+                    uint32_t oldTime, newTime, settledTime;
+                    runLanding(heightNoises[h], yawNoises[y], spikeChances[c], &oldTime, &newTime, &settledTime);
+                    oldTotal += oldTime;
+                    newTotal += newTime;
+                    oldTimeOuts += oldTime >= OLD_TIME_OUT;
+                    newTimeOuts += newTime >= OLD_TIME_OUT;
+                    early += newTime <= settledTime;
+                    landings++;
+                }
+            }
+        }
+    }
+
+    double oldMean = (double)oldTotal / landings, newMean = (double)newTotal / landings;
+    check(newMean < oldMean, "windowed detector lands sooner");
+    check(early == 0, "windowed detector waits for the heli to settle");
+    printf("landingController: %u landings, mean %.0f ms (%u timed out), tick counter %.0f ms (%u timed out), "
+           "%.0f %% sooner\n", landings, newMean, newTimeOuts, oldMean, oldTimeOuts, (1 - newMean / oldMean) * 100);
+}
+
+
+struct TrajectoryLimits {
+    const char* name;
+    int32_t maxVelocity;  // per second, scaled by PRECISION
+    int32_t maxAcceleration;
+    int32_t largestStep;
+};
+
+
+// Move from rest at 0 to target and back, returning the worst time taken over the
+// minimum time for the limits, in updates. Any limit broken is a failure.
+static double runTrajectory(const TrajectoryLimits& limits, int32_t target, int32_t changeAt, double* worstRatio)
+{
+    trajectory_t trajectory;
+    double worstExtra = 0;
+    int32_t velocityStep = limits.maxAcceleration * CONTROL_PERIOD / 1000;
+    int32_t positionStep = limits.maxVelocity * CONTROL_PERIOD / 1000 + 1;
+
+    trajectoryInit(&trajectory, limits.maxVelocity, limits.maxAcceleration);
+    for (int leg = 0; leg < 2; leg++) {
+        int32_t start = trajectory.position;
+        int32_t goal = leg == 0 ? target : 0;
+        uint32_t updates = 0;
+        bool isOk = true;
+
+        // a target changed part way through the first leg, when changeAt is set
+        int32_t moving = changeAt ? -goal / 2 : goal;
+        while (!trajectoryIsDone(&trajectory, goal) && updates < 100000) {
+            int32_t wanted = changeAt && leg == 0 && updates < (uint32_t)changeAt ? moving : goal;
+            int32_t lastPosition = trajectory.position, lastVelocity = trajectory.velocity;
+            trajectoryUpdate(&trajectory, wanted, CONTROL_PERIOD);
+            updates++;
+
+            isOk &= abs(trajectory.velocity) <= limits.maxVelocity;
+            isOk &= abs(trajectory.velocity - lastVelocity) <= velocityStep;
+            isOk &= abs(trajectory.position - lastPosition) <= positionStep;
+            if (!changeAt || leg) {
+                // from rest, the reference never passes the goal
+                isOk &= goal >= start ? trajectory.position <= goal : trajectory.position >= goal;
+            }
+        }
+        check(isOk && trajectoryIsDone(&trajectory, goal), limits.name);
+
+        if (!changeAt || leg) {
+            // accelerate, cruise, decelerate, or a triangle if the cruise speed is never reached
+            double distance = fabs((double)goal - start);
+            double v = limits.maxVelocity, a = limits.maxAcceleration;
+            double minimum = distance >= v * v / a ? distance / v + v / a : 2 * sqrt(distance / a);
+            double extra = updates - minimum * 1000 / CONTROL_PERIOD;
+            worstExtra = extra > worstExtra ? extra : worstExtra;
+            double ratio = updates * CONTROL_PERIOD / 1000.0 / minimum;
+            *worstRatio = ratio > *worstRatio ? ratio : *worstRatio;
+        }
+    }
+    return worstExtra;
+}
+
+
+static void checkTrajectory(void)
+{
+    // HEIGHT_ and YAW_MAX_VELOCITY and _ACCELERATION in control.c
+    const TrajectoryLimits limits[] = {
+        {"height trajectory limits", 30 * PRECISION, 60 * PRECISION, 100 * PRECISION},
+        {"yaw trajectory limits", 90 * PRECISION, 180 * PRECISION, 360 * PRECISION},
+    };
+
+    for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+        const TrajectoryLimits& l = limits[i];
+        double worstExtra = 0, worstRatio = 0;
+        uint32_t steps = 0;
+
+        for (int32_t target = -l.largestStep; target <= l.largestStep; target += 97) {
+            if (!target)
+                continue;
+            double extra = runTrajectory(l, target, 0, &worstRatio);
+            worstExtra = extra > worstExtra ? extra : worstExtra;
+            runTrajectory(l, target, 1 + nextRandom() % 150, &worstRatio);
+            steps++;
+        }
+        check(worstExtra <= TRAJECTORY_SLACK, "trajectory close to minimum time");
+        printf("trajectory: %u %s steps, at most %.1f updates (%.0f %%) over the minimum time\n", steps,
+               i ? "yaw" : "height", worstExtra, (worstRatio - 1) * 100);
+    }
+}
+
+
+static int applyFormat(const line_format_t* format, char* str, uint32_t size, ...)
+{
+    va_list args;
+    va_start(args, size);
+    int length = lineFormatApply(format, str, size, args);
+    va_end(args);
+    return length;
+}
+
+
+static int32_t randomValue(void)
+{
+    const int32_t extremes[] = {0, -1, 9, 10, -10, 99999, INT32_MAX, INT32_MIN};
+    uint32_t kind = nextRandom() % 4;
+
+    if (kind == 0)
+        return extremes[nextRandom() % (sizeof(extremes) / sizeof(extremes[0]))];
+    if (kind == 1)
+        return (int32_t)(nextRandom() % 2000) - 1000;
+    return (int32_t)(nextRandom() << 16 ^ nextRandom());
+}
+
+
+// A random layout of literals and conversions, and the same layout for snprintf.
+// Conversions are integer ones, apart from a %s in the middle when hasString.
+static void randomFormat(bool hasString, std::string& format, std::string& reference)
+{
+    const char* literals[] = {"ALT ", " [", "] ", "%%", "x", " = ", ", T = ", "\n"};
+    const char integers[] = {'d', 'i', 'u', 'c'};
+
+    format.clear();
+    reference.clear();
+    for (int i = 0; i < 3; i++) {
+        const char* literal = literals[nextRandom() % (sizeof(literals) / sizeof(literals[0]))];
+        format += literal;
+        reference += literal;
+
+        char type = hasString && i == 1 ? 's' : integers[nextRandom() % sizeof(integers)];
+        std::string flags;
+        if (type != 'c' && nextRandom() % 2) {
+            if (type != 's' && nextRandom() % 2)
+                flags += '0';
+            flags += std::to_string(nextRandom() % 12);
+        }
+        format += "%" + flags + type;
+        reference += (type == 's' ? "%-" : "%") + flags + type;
+    }
+}
+
+
+static void checkLineFormat(void)
+{
+    const char* strings[] = {"", "Flying", "Calibrate Yaw", "a longer string than the line"};
+    std::string format, reference;
+    line_format_t compiled;
+    char line[MAX_LINE], expected[MAX_LINE];
+    uint32_t mismatches = 0;
+
+    for (uint32_t trial = 0; trial < FORMAT_TRIALS; trial++) {
+        bool hasString = trial % 2;
+        randomFormat(hasString, format, reference);
+        if (!lineFormatCompile(&compiled, format.c_str())) {
+            check(false, "random layout compiles");
+            continue;
+        }
+        int32_t a = randomValue(), b = randomValue(), c = randomValue();
+        const char* s = strings[nextRandom() % (sizeof(strings) / sizeof(strings[0]))];
+        uint32_t size = trial % 4 ? MAX_LINE : 1 + nextRandom() % (MAX_LINE - 1);  // some truncated
+        int length, expectedLength;
+
+        if (hasString) {
+            length = applyFormat(&compiled, line, size, a, s, b);
+            expectedLength = snprintf(expected, size, reference.c_str(), a, s, b);
+        } else {
+            length = applyFormat(&compiled, line, size, a, b, c);
+            expectedLength = snprintf(expected, size, reference.c_str(), a, b, c);
+        }
+        if (length != expectedLength || strcmp(line, expected) != 0) {
+            if (!mismatches++)
+                printf("\"%s\" gave \"%s\" (%d), expected \"%s\" (%d)\n", format.c_str(), line, length,
+                       expected, expectedLength);
+        }
+    }
+    check(mismatches == 0, "lineFormat output matches snprintf");
+    check(!lineFormatCompile(&compiled, "%x") && !compiled.isCompiled, "unsupported conversion rejected");
+    check(!lineFormatCompile(&compiled, "%d%d%d%d%d%d%d%d%d%d%d%d%d") && !compiled.isCompiled,
+          "too many segments rejected");
+    printf("lineFormat: %u random layouts, %u mismatches\n", FORMAT_TRIALS, mismatches);
+}
+
+
+static int referenceFormat(char* str, uint32_t size, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(str, size, format, args);
+    va_end(args);
+    return length;
+}
+
+
+// Time the status block layouts of main.c both ways, in ns per line.
+static void timeLineFormat(void)
+{
+    const char* layouts[] = {"Height = %4d%%", "M = %2d, T = %2d", "\nALT %d [%d] %%\n", "YAW %d [%d] deg\n"};
+    const uint32_t numLayouts = sizeof(layouts) / sizeof(layouts[0]);
+    line_format_t compiled[numLayouts];
+    char line[MAX_LINE];
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < numLayouts; i++)
+        lineFormatCompile(&compiled[i], layouts[i]);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < FORMAT_TIMING_LINES; i++)
+        total += applyFormat(&compiled[i % numLayouts], line, MAX_LINE, (int32_t)i % 100, -(int32_t)i % 360);
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < FORMAT_TIMING_LINES; i++)
+        total -= referenceFormat(line, MAX_LINE, layouts[i % numLayouts], (int32_t)i % 100, -(int32_t)i % 360);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    check(total == 0, "timed lines match");
+    printf("lineFormat: %.1f ns per line, vsnprintf %.1f ns per line\n",
+           std::chrono::duration<double, std::nano>(middle - start).count() / FORMAT_TIMING_LINES,
+           std::chrono::duration<double, std::nano>(end - middle).count() / FORMAT_TIMING_LINES);
+}
+
+
+int main(void)
+{
+    checkPwmDither();
+    checkStepAnalysis();
+    checkTrajectory();
+    checkWindowStats();
+    checkLandingDetector();
+    checkLineFormat();
+    timeLineFormat();
+
+    printf(failures ? "%d checks failed\n" : "all checks passed\n", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+// ************************************************************
+// recordDecode.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Turn a capture of the sensor recording into a CSV timeline.
+// Explaination: Reads the raw UART bytes from the file given, or stdin, and
+// prints one line per sample, encoder reading, event and gap, as
+// time (ms since the recording started), kind, value:
+//   start      a new recording
+//   encoder    the encoder count when the packet was built
+//   adc        an ADC sample. Samples are only sent with the time of their
+//              packet, so they are spaced back from it at the sample rate.
+//   edge       an encoder edge, value is the HAL_ENCODER_A and B bits
+//   yawref     the yaw reference was seen
+//   button     a button pin edge, value is the button << 1 | the pin is high
+//   uart       a character was received, value is its code
+//   gap        packets were lost before this time, value is how many
+//   dropped    samples and events the firmware had no room for before this time
+// The decoder statistics are printed to stderr at the end.
+//   recordDecode capture.bin > flight.csv
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "recordDecoder.h"
+
+#define SAMPLE_RATE 160  // Hz, ADC_SAMPLE_RATE in height.h
+#define US_PER_MS 1000
+
+static const char* eventNames[] = {"yawref", "button", "edge", "uart"};
+
+
+int main(int argc, char** argv)
+{
+    FILE* input = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    FrameDecoder frames;
+    RecordDecoder decoder;
+    RecordPacket record;
+    int c;
+
+    if (!input) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    printf("time_ms,kind,value\n");
+    while ((c = fgetc(input)) != EOF) {
+        if (!frames.addByte((uint8_t)c) || !decoder.decode(frames.packet(), record)) {
+            continue;
+        }
+
+        if (record.isStart) {
+            printf("%u.000,start,%u\n", record.time, decoder.recordings);
+        }
+        if (record.lostBefore) {
+            printf("%u.000,gap,%u\n", record.time, record.lostBefore);
+        }
+        if (record.dropped) {
+            printf("%u.000,dropped,%u\n", record.time, record.dropped);
+        }
+
+        size_t n = record.samples.size();
+        for (size_t i = 0; i < n; i++) {
+            int64_t time = (int64_t)record.time * US_PER_MS - (int64_t)(n - 1 - i) * US_PER_MS * US_PER_MS / SAMPLE_RATE;
+            printf("%.3f,adc,%d\n", (double)time / US_PER_MS, record.samples[i]);
+        }
+        for (size_t i = 0; i < record.events.size(); i++) {
+            const RecordEvent& event = record.events[i];
+            const char* name = event.type < sizeof(eventNames) / sizeof(eventNames[0]) ? eventNames[event.type] : "unknown";
+            printf("%.3f,%s,%u\n", (double)event.time / US_PER_MS, name, event.data);
+        }
+        printf("%u.000,encoder,%d\n", record.time, record.encoderCount);
+    }
+
+    fprintf(stderr, "%u packets, %u recordings, %u CRC errors, %u framing errors, %u lost, %u malformed\n",
+            decoder.packets, decoder.recordings, frames.crcErrors, frames.framingErrors,
+            decoder.lostPackets, decoder.malformedPackets);
+    if (input != stdin) {
+        fclose(input);
+    }
+    return EXIT_SUCCESS;
+}
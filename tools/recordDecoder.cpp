@@ -0,0 +1,105 @@
+// ************************************************************
+// recordDecoder.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Decode the sensor recording sent by the helicopter in record mode.
+// Explaination: See recordDecoder.h.
+// ************************************************************
+
+#include "recordDecoder.h"
+
+#define TICKS_PER_US (RECORDER_TICKS_PER_MS / 1000)
+#define MAX_ITEMS 255  // more samples or events than any packet can hold
+
+
+RecordDecoder::RecordDecoder()
+    : packets(0), recordings(0), lostPackets(0), malformedPackets(0),
+      hasStarted(false), nextSequence(0), lastSample(0), lastCount(0)
+{
+}
+
+
+// Decode one packet from a FrameDecoder. Returns false for other packets and
+// malformed packets.
+bool RecordDecoder::decode(const std::vector<uint8_t>& packet, RecordPacket& record)
+{
+    size_t index = 2;
+    int32_t time, countChange, numSamples, numEvents, dropped;
+
+    if (packet.size() < 2 || (packet[0] != RECORDER_PACKET && packet[0] != RECORDER_START_PACKET)) {
+        return false;
+    }
+    if (!decoderReadVarint(packet, index, time) || !decoderReadVarint(packet, index, countChange) ||
+            !decoderReadVarint(packet, index, numSamples) || numSamples < 0 || numSamples > MAX_ITEMS) {
+        malformedPackets++;
+        return false;
+    }
+
+    record.sequence = packet[1];
+    record.time = (uint32_t)time;
+    record.isStart = packet[0] == RECORDER_START_PACKET;
+    record.lostBefore = 0;
+    record.samples.clear();
+    record.events.clear();
+
+    // a new recording, or a gap after which the firmware starts the changes from 0 again
+    if (record.isStart) {
+        recordings++;
+        lastSample = 0;
+        lastCount = 0;
+    } else if (hasStarted && record.sequence != nextSequence) {
+        record.lostBefore = (uint8_t)(record.sequence - nextSequence);
+        lostPackets += record.lostBefore;
+        lastSample = 0;
+        lastCount = 0;
+    }
+
+    int32_t sample = lastSample;
+    for (int32_t i = 0; i < numSamples; i++) {
+        int32_t change;
+        if (!decoderReadVarint(packet, index, change)) {
+            malformedPackets++;
+            return false;
+        }
+        sample += change;
+        record.samples.push_back(sample);
+    }
+
+    if (!decoderReadVarint(packet, index, numEvents) || numEvents < 0 || numEvents > MAX_ITEMS) {
+        malformedPackets++;
+        return false;
+    }
+    for (int32_t i = 0; i < numEvents; i++) {
+        RecordEvent event;
+        int32_t offset;
+        if (index + 2 > packet.size()) {
+            malformedPackets++;
+            return false;
+        }
+        event.type = packet[index++];
+        event.data = packet[index++];
+        if (!decoderReadVarint(packet, index, offset)) {
+            malformedPackets++;
+            return false;
+        }
+        event.ticks = (int64_t)record.time * RECORDER_TICKS_PER_MS + offset;
+        event.time = event.ticks / TICKS_PER_US;
+        record.events.push_back(event);
+    }
+    if (!decoderReadVarint(packet, index, dropped) || index != packet.size()) {
+        malformedPackets++;
+        return false;
+    }
+
+    // only take on the new values once the whole packet is known to be good
+    record.dropped = (uint32_t)dropped;
+    record.encoderCount = lastCount + countChange;
+    lastCount = record.encoderCount;
+    lastSample = sample;
+    hasStarted = true;
+    nextSequence = (uint8_t)(record.sequence + 1);
+    packets++;
+    return true;
+}
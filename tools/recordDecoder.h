@@ -0,0 +1,70 @@
+// ************************************************************
+// recordDecoder.h
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Decode the sensor recording sent by the helicopter in record mode.
+// Explaination: Recording packets are framed like the telemetry, so a
+// FrameDecoder (see telemetryDecoder.h) splits the stream and RecordDecoder
+// turns each recording packet back into absolute ADC samples, the encoder count
+// and events timed to the tick, see recorderPacket.h for the layout. After a lost packet the
+// firmware sends the next changes from 0 again, so decoding carries on with
+// only the lost packet's samples and events missing.
+// ************************************************************
+
+#ifndef RECORDDECODER_H_
+#define RECORDDECODER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "telemetryDecoder.h"
+#include "../recorderPacket.h"
+
+
+// An event from a recording.
+struct RecordEvent {
+    uint8_t type;  // recorder_event_t
+    uint8_t data;
+    int64_t ticks;  // timer ticks since the recording started, RECORDER_TICKS_PER_MS per ms
+    int64_t time;  // us since the recording started, rounded down
+};
+
+
+// The contents of one recording packet.
+struct RecordPacket {
+    uint8_t sequence;
+    uint32_t time;  // ms since the recording started
+    bool isStart;  // the first packet of a recording
+    uint32_t lostBefore;  // packets lost just before this one
+    int32_t encoderCount;
+    std::vector<int32_t> samples;  // ADC samples since the last packet, oldest first
+    std::vector<RecordEvent> events;  // oldest first
+    uint32_t dropped;  // samples and events the firmware had no room for since the last packet
+};
+
+
+// Rebuilds the recording from the packets of one stream.
+class RecordDecoder {
+public:
+    RecordDecoder();
+
+    // Decode one packet from a FrameDecoder. Returns false for other packets and
+    // malformed packets.
+    bool decode(const std::vector<uint8_t>& packet, RecordPacket& record);
+
+    uint32_t packets;  // decoded
+    uint32_t recordings;  // started
+    uint32_t lostPackets;  // missing from the sequence
+    uint32_t malformedPackets;
+
+private:
+    bool hasStarted;
+    uint8_t nextSequence;
+    int32_t lastSample;
+    int32_t lastCount;
+};
+
+
+#endif /* RECORDDECODER_H_ */
@@ -0,0 +1,347 @@
+// ************************************************************
+// replay.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Replay a sensor recording through the firmware, or make one by
+// flying the simulated rig.
+// Explaination: Built against a firmware build with RECORDER_FROM_RESET and a
+// UART_BAUD_RATE of 115200 (see Makefile), so that the recording starts at
+// reset and the firmware is the same one the board recorded with.
+//
+// To replay, the recording is decoded and fed to the unmodified firmware on the
+// host HAL (halHost.cpp): each ADC conversion returns the next recorded sample,
+// and each event is raised at the cycle its interrupt was taken, which is its
+// stamp less the cycles of entering the interrupt and reading the timer (the
+// stamp is the interrupt's first read). On the same firmware every input is
+// then taken at the point it was recorded, so the outputs are the same to the
+// bit; inputs raised after their time mean the firmware has changed. The run
+// ends at the recording's last packet, past which the inputs are unknown.
+//
+// To record (-r), the firmware flies RigModel from reset, as rigSim does, with
+// the commands given as "seconds:command" or a short flight, and the UART
+// output is saved as the recording.
+//
+// Either way the control outputs are written with -o as CSV: the width latched
+// for each PWM channel, in counts, and whether the output is on, at each 1 ms
+// plant step where they changed and at the end. replayDiff compares two.
+//   replay [-o outputs.csv] recording.bin
+//   replay -r recording.bin [-o outputs.csv] [-t seconds] [-s seed] [seconds:command ...]
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+#include "halHost.h"
+#include "rigModel.h"
+#include "recordDecoder.h"
+
+#define PLANT_PERIOD_US 1000  // the same when recording and replaying, as the plant ends idle waits
+#define TAKE_CYCLES (HAL_HOST_ISR_CYCLES + HAL_HOST_READ_CYCLES)  // from taking an interrupt to its stamp
+#define RIG_SPREAD 0.1
+#define MAX_COMMANDS 32
+#define COMMAND_LENGTH 32
+
+struct Command {
+    double time;
+    char text[COMMAND_LENGTH];
+    bool isSent;
+};
+
+struct Input {
+    int64_t ticks;  // since the timer started
+    uint8_t type;  // recorder_event_t
+    uint8_t data;
+};
+
+// take off, turn and land, if no commands are given
+static const char* defaultFlight[] = {
+    "1:M F", "8:H 50", "14:Y 90", "18:Y -45", "22:H 20", "26:M L"
+};
+
+static Command commands[MAX_COMMANDS];
+static int numCommands = 0;
+
+static FILE* outputs = 0;
+static uint32_t lastWidth[HAL_PWM_NUM_CHANNELS];
+static bool wasOn[HAL_PWM_NUM_CHANNELS];
+static bool isLogged = false;
+static uint32_t outputChanges = 0;
+
+static std::vector<uint16_t> samples;
+static size_t nextSample = 0;
+static uint32_t samplesShort = 0;  // conversions after the recorded samples ran out
+static std::vector<Input> inputs;
+static size_t nextInput = 0;
+static uint32_t inputsLate = 0;
+static bool isStarted = false;
+
+
+// Write the outputs if they changed since the last row, or always if isEnd.
+static void logOutputs(bool isEnd)
+{
+    bool isChanged = !isLogged;
+
+    for (uint32_t channel = 0; channel < HAL_PWM_NUM_CHANNELS; channel++) {
+        isChanged |= halHostPwmWidth(channel) != lastWidth[channel] || halHostPwmIsOn(channel) != wasOn[channel];
+        lastWidth[channel] = halHostPwmWidth(channel);
+        wasOn[channel] = halHostPwmIsOn(channel);
+    }
+    if (outputs && (isChanged || isEnd)) {
+        fprintf(outputs, "%.3f,%u,%d,%u,%d\n", halHostSeconds(), lastWidth[HAL_PWM_MAIN], wasOn[HAL_PWM_MAIN],
+                lastWidth[HAL_PWM_TAIL], wasOn[HAL_PWM_TAIL]);
+    }
+    outputChanges += isChanged && isLogged;
+    isLogged = true;
+}
+
+
+//
+// Recording
+//
+
+
+static bool addCommand(const char* arg)
+{
+    const char* colon = strchr(arg, ':');
+    if (!colon || numCommands >= MAX_COMMANDS) {
+        fprintf(stderr, "command %s has no time, or there are too many\n", arg);
+        return false;
+    }
+    Command& command = commands[numCommands++];
+    command.time = atof(arg);
+    snprintf(command.text, sizeof(command.text), "%s\r", colon + 1);
+    command.isSent = false;
+    return true;
+}
+
+
+static void saveChar(void* context, char c)
+{
+    fputc(c, (FILE*)context);
+}
+
+
+// After each step of the rig: type the commands which are due, and log the outputs.
+static void operatorUpdate(void*)
+{
+    for (int i = 0; i < numCommands; i++) {
+        if (!commands[i].isSent && halHostSeconds() >= commands[i].time) {
+            halHostUartReceive(commands[i].text, strlen(commands[i].text));
+            commands[i].isSent = true;
+        }
+    }
+    logOutputs(false);
+}
+
+
+static int record(const char* path, double seconds, uint32_t seed)
+{
+    FILE* recording = fopen(path, "wb");
+    if (!recording) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+
+    RigParams params = seed ? rigRandomParams(rigDefaultParams(), RIG_SPREAD, seed) : rigDefaultParams();
+    RigModel model(params, seed);
+    RigPlant plant(model);
+
+    halHostSetUartSink(saveChar, recording);
+    plant.attach(PLANT_PERIOD_US, operatorUpdate, 0);
+    hal_host_stop_t stop = halHostRun(firmwareMain, seconds);
+    logOutputs(true);
+    fclose(recording);
+
+    fprintf(stderr, "recorded %.3f s to %s, %u output changes, rig at height %.1f %% and yaw %.1f deg\n",
+            halHostSeconds(), path, outputChanges, model.height(), model.yaw());
+    return stop == HAL_HOST_STOP_TIME ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+//
+// Replaying
+//
+
+
+// Decode the first recording in path into samples and inputs. Returns the time of
+// its last packet in ms, or 0 if it can't be replayed.
+static uint32_t load(const char* path)
+{
+    FILE* recording = fopen(path, "rb");
+    FrameDecoder frames;
+    RecordDecoder decoder;
+    RecordPacket record;
+    uint32_t endTime = 0, dropped = 0;
+    int c;
+
+    if (!recording) {
+        perror(path);
+        return 0;
+    }
+    while ((c = fgetc(recording)) != EOF) {
+        if (!frames.addByte((uint8_t)c) || !decoder.decode(frames.packet(), record)) {
+            continue;
+        }
+        if (decoder.packets == 1 && (!record.isStart || record.time == 0)) {
+            fprintf(stderr, "%s was not recorded from reset, build the firmware with RECORDER_FROM_RESET\n", path);
+            fclose(recording);
+            return 0;
+        }
+        if (record.isStart && decoder.packets > 1) {
+            break;  // the next recording
+        }
+        samples.insert(samples.end(), record.samples.begin(), record.samples.end());
+        for (const RecordEvent& event : record.events) {
+            inputs.push_back({event.ticks, event.type, event.data});
+        }
+        dropped += record.dropped;
+        endTime = record.time;
+    }
+    fclose(recording);
+
+    fprintf(stderr, "%s: %.3f s, %zu samples, %zu events, %u packets lost, %u inputs dropped\n", path,
+            endTime / 1000.0, samples.size(), inputs.size(), decoder.lostPackets, dropped);
+    if (decoder.lostPackets || dropped || frames.crcErrors || decoder.malformedPackets) {
+        fprintf(stderr, "the recording has gaps, so the replay will not be exact\n");
+    }
+    return endTime;
+}
+
+
+static uint32_t nextAdc(void*)
+{
+    if (nextSample < samples.size()) {
+        return samples[nextSample++];
+    }
+    samplesShort++;
+    return samples.empty() ? 0 : samples.back();
+}
+
+
+static uint64_t takenAt(const Input& input)
+{
+    return halHostTimerStart() + input.ticks - TAKE_CYCLES;
+}
+
+
+// Raise the inputs which are due, and wait for the next.
+static void raiseInputs(void*)
+{
+    while (nextInput < inputs.size() && takenAt(inputs[nextInput]) <= halHostCycles()) {
+        const Input& input = inputs[nextInput++];
+
+        inputsLate += takenAt(input) != halHostCycles();
+        switch (input.type) {
+        case RECORDER_EV_YAW_REF:
+            halHostYawRefPass();
+            break;
+        case RECORDER_EV_BUTTON:
+            halHostSetButton(input.data >> 1, input.data & 1);
+            break;
+        case RECORDER_EV_ENCODER:
+            halHostEncoderEdge(input.data);
+            break;
+        case RECORDER_EV_UART:
+            halHostUartArrive((char)input.data);
+            break;
+        }
+    }
+    if (nextInput < inputs.size()) {
+        halHostAt(takenAt(inputs[nextInput]), raiseInputs, 0);
+    }
+}
+
+
+// Each plant step: log the outputs, and start raising inputs once the timer has started.
+static void replayUpdate(void*)
+{
+    if (!isStarted) {
+        isStarted = true;
+        raiseInputs(0);
+    }
+    logOutputs(false);
+}
+
+
+static int replay(const char* path)
+{
+    uint32_t endTime = load(path);
+    if (!endTime) {
+        return EXIT_FAILURE;
+    }
+
+    halHostSetAdcSource(nextAdc, 0);
+    halHostSetPlant(PLANT_PERIOD_US, replayUpdate, 0);
+    hal_host_stop_t stop = halHostRun(firmwareMain, endTime / 1000.0);
+    logOutputs(true);
+
+    fprintf(stderr, "replayed %.3f s, %zu of %zu samples and %zu of %zu events, %u events late, "
+            "%u conversions past the samples, %u output changes\n", halHostSeconds(), nextSample,
+            samples.size(), nextInput, inputs.size(), inputsLate, samplesShort, outputChanges);
+    return stop == HAL_HOST_STOP_TIME ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+static int usage(void)
+{
+    fprintf(stderr, "usage: replay [-o outputs.csv] recording.bin\n"
+            "       replay -r recording.bin [-o outputs.csv] [-t seconds] [-s seed] [seconds:command ...]\n");
+    return EXIT_FAILURE;
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* recordPath = 0;
+    double seconds = 30;
+    uint32_t seed = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "r:o:t:s:")) != -1) {
+        if (option == 'r') {
+            recordPath = optarg;
+        } else if (option == 'o') {
+            outputs = fopen(optarg, "w");
+            if (!outputs) {
+                perror(optarg);
+                return EXIT_FAILURE;
+            }
+            fprintf(outputs, "time,mainWidth,mainOn,tailWidth,tailOn\n");
+        } else if (option == 't') {
+            seconds = atof(optarg);
+        } else if (option == 's') {
+            seed = (uint32_t)strtoul(optarg, 0, 10);
+        } else {
+            return usage();
+        }
+    }
+    if (!recordPath && optind != argc - 1) {
+        return usage();
+    }
+
+    int result;
+    if (recordPath) {
+        for (int i = optind; i < argc; i++) {
+            if (!addCommand(argv[i])) {
+                return EXIT_FAILURE;
+            }
+        }
+        if (optind == argc) {
+            for (const char* command : defaultFlight) {
+                addCommand(command);
+            }
+        }
+        result = record(recordPath, seconds, seed);
+    } else {
+        result = replay(argv[optind]);
+    }
+    if (outputs) {
+        fclose(outputs);
+    }
+    return result;
+}
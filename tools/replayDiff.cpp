@@ -0,0 +1,152 @@
+// ************************************************************
+// replayDiff.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Show where two firmware versions diverge on the same recording.
+// Explaination: Reads two output logs written by replay -o, for example from
+// replaying one recording with the old and the new firmware. Each log holds
+// the outputs from the time of each row until the next, so the two are
+// compared at every time either changes, up to the end of the shorter. Prints
+// the first time they differ, with the outputs of each around it, how long in
+// all they differ and the largest width differences. Returns non zero if they
+// differ.
+//   replayDiff old.csv new.csv
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+#define CONTEXT_ROWS 4  // of each log shown on either side of the divergence
+
+struct OutputRow {
+    double time;  // s
+    unsigned mainWidth, tailWidth;
+    int mainOn, tailOn;
+
+    bool operator==(const OutputRow& other) const
+    {
+        return mainWidth == other.mainWidth && tailWidth == other.tailWidth && mainOn == other.mainOn &&
+               tailOn == other.tailOn;
+    }
+};
+
+
+static bool load(const char* path, std::vector<OutputRow>& rows)
+{
+    FILE* file = fopen(path, "r");
+    char line[128];
+    OutputRow row;
+
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "%lf,%u,%d,%u,%d", &row.time, &row.mainWidth, &row.mainOn, &row.tailWidth,
+                   &row.tailOn) == 5) {
+            rows.push_back(row);
+        }
+    }
+    fclose(file);
+    if (rows.empty()) {
+        fprintf(stderr, "%s has no outputs\n", path);
+        return false;
+    }
+    return true;
+}
+
+
+// Move row on to the row in effect at time, the last at or before it.
+static size_t rowAt(const std::vector<OutputRow>& rows, double time, size_t row = 0)
+{
+    while (row + 1 < rows.size() && rows[row + 1].time <= time) {
+        row++;
+    }
+    return row;
+}
+
+
+static unsigned apart(unsigned x, unsigned y)
+{
+    return x > y ? x - y : y - x;
+}
+
+
+static void printRows(const char* name, const std::vector<OutputRow>& rows, size_t at)
+{
+    size_t first = at > CONTEXT_ROWS ? at - CONTEXT_ROWS : 0;
+
+    printf("%s:\n", name);
+    for (size_t i = first; i < rows.size() && i <= at + CONTEXT_ROWS; i++) {
+        const OutputRow& row = rows[i];
+        printf("  %s %9.3f s  main %5u %-3s  tail %5u %-3s\n", i == at ? ">" : " ", row.time, row.mainWidth,
+               row.mainOn ? "on" : "off", row.tailWidth, row.tailOn ? "on" : "off");
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    std::vector<OutputRow> a, b;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: replayDiff old.csv new.csv\n");
+        return EXIT_FAILURE;
+    }
+    if (!load(argv[1], a) || !load(argv[2], b)) {
+        return EXIT_FAILURE;
+    }
+
+    // every time either log changes, in order, up to the end of the shorter
+    double end = a.back().time < b.back().time ? a.back().time : b.back().time;
+    std::vector<double> times;
+    size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        double time = j == b.size() || (i < a.size() && a[i].time <= b[j].time) ? a[i].time : b[j].time;
+        if (time > end) {
+            break;
+        }
+        times.push_back(time);
+        while (i < a.size() && a[i].time == time) {
+            i++;
+        }
+        while (j < b.size() && b[j].time == time) {
+            j++;
+        }
+    }
+
+    double firstDiverged = -1, divergedFor = 0;
+    unsigned maxMain = 0, maxTail = 0;
+    i = 0;
+    j = 0;
+    for (size_t k = 0; k < times.size(); k++) {
+        i = rowAt(a, times[k], i);
+        j = rowAt(b, times[k], j);
+        const OutputRow& rowA = a[i];
+        const OutputRow& rowB = b[j];
+        if (rowA == rowB) {
+            continue;
+        }
+        if (firstDiverged < 0) {
+            firstDiverged = times[k];
+        }
+        divergedFor += (k + 1 < times.size() ? times[k + 1] : end) - times[k];
+        maxMain = std::max(maxMain, apart(rowA.mainWidth, rowB.mainWidth));
+        maxTail = std::max(maxTail, apart(rowA.tailWidth, rowB.tailWidth));
+    }
+
+    if (firstDiverged < 0) {
+        printf("identical over %.3f s, %zu output changes\n", end, times.size());
+        return EXIT_SUCCESS;
+    }
+    printf("diverged at %.3f s\n", firstDiverged);
+    printRows(argv[1], a, rowAt(a, firstDiverged));
+    printRows(argv[2], b, rowAt(b, firstDiverged));
+    printf("different for %.3f s of %.3f s, widths up to %u counts apart on the main rotor and %u on the tail\n",
+           divergedFor, end, maxMain, maxTail);
+    return EXIT_FAILURE;
+}
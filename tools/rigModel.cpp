@@ -0,0 +1,224 @@
+// ************************************************************
+// rigModel.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: A physics model of the helicopter rig, to close the control loop
+// against on the host.
+// Explaination: See rigModel.h. The model is stepped with explicit Euler, which
+// is accurate enough at the 1 ms plant period against lags of 100 ms or more.
+// ************************************************************
+
+#include "rigModel.h"
+
+#include <cmath>
+
+#define STOPPED_RATE 1e-3  // %/s or deg/s, slow enough for static friction to hold
+#define ADC_FULL_HEIGHT (4095 * 0.8 / 3.3)  // counts, as MEAN_RANGE in height.c
+
+
+static const RigParams defaultParams = {
+    0.35,  // mainLag
+    0.15,  // tailLag
+    33,  // hoverDuty, CONTROL_PARAM_MAIN_OFFSET
+    0.2,  // gravSlope, CONTROL_PARAM_GRAV_OFFSET
+    4,  // lift
+    1.5,  // heightDrag
+    2,  // heightStiction
+    4,  // yawThrust
+    0.8,  // torqueRatio, CONTROL_PARAM_TORQUE_CONST
+    1.5,  // yawDrag
+    5,  // yawStiction
+    2000,  // adcLanded
+    ADC_FULL_HEIGHT,  // adcRange
+    0.03,  // adcBend
+    4,  // adcNoise
+    40,  // yawReference
+    112 * 4  // countsPerRotation, as yaw.c
+};
+
+
+// xorshift64*, so that runs can be repeated from their seed.
+static uint64_t nextRandom(uint64_t& state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+
+// Return a uniform random number from 0 to 1.
+static double uniform(uint64_t& state)
+{
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+static uint64_t seedState(uint32_t seed)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ seed;
+    nextRandom(state);
+    return state;
+}
+
+
+RigParams rigDefaultParams(void)
+{
+    return defaultParams;
+}
+
+
+RigParams rigRandomParams(const RigParams& base, double spread, uint32_t seed)
+{
+    uint64_t state = seedState(seed);
+    RigParams p = base;
+    double* constants[] = {
+        &p.mainLag, &p.tailLag, &p.hoverDuty, &p.gravSlope, &p.lift, &p.heightDrag, &p.heightStiction,
+        &p.yawThrust, &p.torqueRatio, &p.yawDrag, &p.yawStiction, &p.adcLanded, &p.adcRange, &p.adcBend, &p.adcNoise
+    };
+
+    for (double* constant : constants) {
+        *constant *= 1 + spread * (2 * uniform(state) - 1);
+    }
+    p.yawReference = 360 * uniform(state);
+    return p;
+}
+
+
+RigModel::RigModel(const RigParams& params, uint32_t seed)
+    : p(params), noiseState(seedState(seed)), heightPercent(0), climbRate(0),
+      yawDegrees(0), yawRate(0), mainPercent(0), tailPercent(0)
+{
+}
+
+
+// Return a normally distributed random number, with a standard deviation of 1.
+double RigModel::noise(void)
+{
+    double u = uniform(noiseState);
+    double v = uniform(noiseState);
+    return std::sqrt(-2 * std::log(1 - u)) * std::cos(2 * M_PI * v);
+}
+
+
+// Move one axis on by dt with acceleration force, less friction. Static
+// friction holds the axis until the force overcomes it.
+static void moveAxis(double dt, double force, double drag, double stiction, double& position, double& rate)
+{
+    if (std::fabs(rate) < STOPPED_RATE) {
+        if (std::fabs(force) <= stiction) {
+            rate = 0;
+            return;
+        }
+        force -= std::copysign(stiction, force);
+    } else {
+        force -= std::copysign(stiction, rate);
+    }
+    double newRate = rate + (force - drag * rate) * dt;
+
+    // stop at a reversal for one step, so that friction never pushes the axis back
+    if (newRate * rate < 0) {
+        newRate = 0;
+    }
+    position += (rate + newRate) / 2 * dt;
+    rate = newRate;
+}
+
+
+void RigModel::step(double dt, double mainDuty, double tailDuty)
+{
+    mainPercent += (mainDuty - mainPercent) * dt / p.mainLag;
+    tailPercent += (tailDuty - tailPercent) * dt / p.tailLag;
+
+    // the main rotor lifts against gravity, and the stand pulls down harder with height
+    double climbForce = p.lift * (mainPercent - p.hoverDuty - p.gravSlope * heightPercent);
+    moveAxis(dt, climbForce, p.heightDrag, p.heightStiction, heightPercent, climbRate);
+    if (heightPercent < 0) {
+        // landed on the base
+        heightPercent = 0;
+        climbRate = 0;
+    } else if (heightPercent > 100) {
+        // at the top of the stand
+        heightPercent = 100;
+        climbRate = 0;
+    }
+
+    // the tail rotor turns the heli clockwise, against the main rotor's torque
+    double turnForce = p.yawThrust * (tailPercent - p.torqueRatio * mainPercent);
+    moveAxis(dt, turnForce, p.yawDrag, p.yawStiction, yawDegrees, yawRate);
+}
+
+
+// Return the ADC counts below the landed reading at the current height.
+double RigModel::adcDrop(void) const
+{
+    double x = heightPercent / 100;
+    return p.adcRange * (x + p.adcBend * 4 * x * (1 - x));
+}
+
+
+double RigModel::sensedHeight(void) const
+{
+    return adcDrop() / ADC_FULL_HEIGHT * 100;
+}
+
+
+uint32_t RigModel::adc(void)
+{
+    double value = p.adcLanded - adcDrop() + p.adcNoise * noise();
+
+    if (value < 0) {
+        return 0;
+    }
+    return value > 4095 ? 4095 : (uint32_t)std::lround(value);
+}
+
+
+int32_t RigModel::encoderCount(void) const
+{
+    return (int32_t)std::floor(yawDegrees * p.countsPerRotation / 360);
+}
+
+
+RigPlant::RigPlant(RigModel& model)
+    : model(model), referencePasses(0), period(0), lastCount(0), observer(0), observerContext(0)
+{
+}
+
+
+void RigPlant::attach(uint32_t periodUs, hal_host_plant_t observer, void* context)
+{
+    this->observer = observer;
+    observerContext = context;
+    period = periodUs / 1e6;
+    lastCount = model.encoderCount();
+    halHostSetAdc(model.adc());
+    halHostSetPlant(periodUs, update, this);
+}
+
+
+void RigPlant::update(void* context)
+{
+    RigPlant* plant = (RigPlant*)context;
+    RigModel& model = plant->model;
+    double referenceTurns = std::floor((model.yaw() - model.params().yawReference) / 360);
+
+    model.step(plant->period, halHostPwmDuty(HAL_PWM_MAIN) * 100, halHostPwmDuty(HAL_PWM_TAIL) * 100);
+
+    halHostSetAdc(model.adc());
+    int32_t count = model.encoderCount();
+    if (count != plant->lastCount) {
+        halHostEncoderMove(count - plant->lastCount);
+        plant->lastCount = count;
+    }
+    if (std::floor((model.yaw() - model.params().yawReference) / 360) != referenceTurns) {
+        halHostYawRefPass();
+        plant->referencePasses++;
+    }
+
+    if (plant->observer) {
+        plant->observer(plant->observerContext);
+    }
+}
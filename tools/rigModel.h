@@ -0,0 +1,117 @@
+// ************************************************************
+// rigModel.h
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: A physics model of the helicopter rig, to close the control loop
+// against on the host.
+// Explaination: RigModel steps the rig in time with the rotor duty cycles as
+// inputs. Each rotor's speed lags its duty cycle (first order), and thrust goes
+// with the speed. The main rotor lifts against gravity and the stand, which
+// pulls down harder the higher the heli is, and its torque turns the heli
+// against the tail rotor. Both axes have viscous and static friction. The
+// height sensor is non-linear and noisy, and the yaw is only seen as whole
+// encoder counts.
+//
+// RigPlant connects a model to the host HAL (halHost.h) as its plant: every
+// plant period it reads the PWM duty cycles, steps the model and drives the
+// ADC value, the encoder edges and the yaw reference pin. The default
+// parameters give the hover point the controller's default constants assume
+// (CONTROL_PARAM_MAIN_OFFSET and so on in control.c).
+// ************************************************************
+
+#ifndef RIGMODEL_H_
+#define RIGMODEL_H_
+
+#include <cstdint>
+
+#include "halHost.h"
+
+
+// The constants of one rig. Percentages are of the full height or duty cycle.
+struct RigParams {
+    double mainLag;  // s, time constant of the main rotor speed
+    double tailLag;  // s
+    double hoverDuty;  // %, main rotor speed which holds the heli at zero height
+    double gravSlope;  // % speed more to hold each % of height, the stand pulling harder
+    double lift;  // %/s^2 of height for each % of speed above what holds the heli
+    double heightDrag;  // 1/s, viscous friction of the stand
+    double heightStiction;  // %/s^2, static friction of the stand
+    double yawThrust;  // deg/s^2 for each % of tail rotor speed
+    double torqueRatio;  // main rotor torque, as the tail speed which balances 1 % of main speed
+    double yawDrag;  // 1/s
+    double yawStiction;  // deg/s^2
+    double adcLanded;  // ADC counts at zero height
+    double adcRange;  // counts from zero to full height, the sensor's 0.8 V
+    double adcBend;  // non-linearity, fraction of adcRange at half height
+    double adcNoise;  // counts, standard deviation
+    double yawReference;  // deg, where the reference pin is, from the starting yaw
+    uint32_t countsPerRotation;  // encoder counts, both edges of both channels
+};
+
+// The rig the controller was tuned on.
+RigParams rigDefaultParams(void);
+
+// A rig with each constant of base moved by up to spread (0.1 = 10 %) either way,
+// and the yaw reference anywhere. The same seed gives the same rig.
+RigParams rigRandomParams(const RigParams& base, double spread, uint32_t seed);
+
+
+// The rig's motion, stepped by the caller.
+class RigModel {
+public:
+    RigModel(const RigParams& params, uint32_t seed);
+
+    // Move on by dt seconds with the rotors at these duty cycles, in %. Zero for off.
+    void step(double dt, double mainDuty, double tailDuty);
+
+    // Return what the sensors read now.
+    uint32_t adc(void);  // with a new noise sample each call
+    int32_t encoderCount(void) const;
+
+    double height(void) const { return heightPercent; }  // %, 0 landed
+
+    // Return the height the firmware would see without the sensor noise: the
+    // reading on the scale of height.c, 0.8 V from landed to full height.
+    double sensedHeight(void) const;
+    double yaw(void) const { return yawDegrees; }  // deg, from the starting yaw, clockwise
+    double mainSpeed(void) const { return mainPercent; }  // %
+    double tailSpeed(void) const { return tailPercent; }  // %
+    const RigParams& params(void) const { return p; }
+
+private:
+    RigParams p;
+    uint64_t noiseState;
+    double heightPercent, climbRate;
+    double yawDegrees, yawRate;
+    double mainPercent, tailPercent;
+
+    double noise(void);
+    double adcDrop(void) const;
+};
+
+
+// Drives the host HAL from a RigModel. Only one can be attached at a time.
+class RigPlant {
+public:
+    explicit RigPlant(RigModel& model);
+
+    // Make this the HAL's plant, stepping every periodUs of virtual time. observer,
+    // if given, is called after each step, to watch the rig or act as the operator.
+    void attach(uint32_t periodUs, hal_host_plant_t observer = 0, void* context = 0);
+
+    RigModel& model;
+    uint32_t referencePasses;  // since attached
+
+private:
+    double period;  // s
+    int32_t lastCount;
+    hal_host_plant_t observer;
+    void* observerContext;
+
+    static void update(void* context);
+};
+
+
+#endif /* RIGMODEL_H_ */
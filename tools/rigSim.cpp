@@ -0,0 +1,161 @@
+// ************************************************************
+// rigSim.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Fly the whole firmware against a simulated rig, faster than real
+// time.
+// Explaination: main.c and every module run on the host backend of the HAL
+// (halHost.cpp), closing the loop through RigModel (rigModel.h): the model
+// reads the PWM duty cycles and drives the ADC, the encoder and the yaw
+// reference. Commands are typed into the UART at the given times, as
+// "seconds:command". With none given, it takes off, steps the height and yaw
+// a few times and lands again. Prints the flight every 10 ms as CSV with -o,
+// the firmware's UART output with -u, and a summary to stderr: the end state,
+// and the simulated seconds run per second of wall time.
+//   rigSim [-t seconds] [-s seed] [-o flight.csv] [-u] [seconds:command ...]
+// A seed other than 0 flies a random rig, each constant 10 % either way of
+// the default. Returns non zero if the firmware reset itself or stopped early.
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <unistd.h>
+
+#include "halHost.h"
+#include "rigModel.h"
+
+#define PLANT_PERIOD_US 1000
+#define LOG_PERIOD 10  // plant periods between CSV rows
+#define RIG_SPREAD 0.1
+#define MAX_COMMANDS 32
+#define COMMAND_LENGTH 32
+
+struct Command {
+    double time;
+    char text[COMMAND_LENGTH];
+    bool isSent;
+};
+
+// take off, move about and land, if no commands are given
+static const char* defaultFlight[] = {
+    "1:M F", "12:H 50", "20:Y 90", "28:H 20", "36:Y -45", "44:M L"
+};
+
+static Command commands[MAX_COMMANDS];
+static int numCommands = 0;
+static FILE* csv = 0;
+static uint32_t plantSteps = 0;
+static RigModel* rig = 0;
+
+
+static void printChar(void*, char c)
+{
+    if (c != '\r') {
+        putchar(c);
+    }
+}
+
+
+static bool addCommand(const char* arg)
+{
+    const char* colon = strchr(arg, ':');
+    if (!colon || numCommands >= MAX_COMMANDS) {
+        fprintf(stderr, "command %s has no time, or there are too many\n", arg);
+        return false;
+    }
+    Command& command = commands[numCommands++];
+    command.time = atof(arg);
+    snprintf(command.text, sizeof(command.text), "%s\r", colon + 1);
+    command.isSent = false;
+    return true;
+}
+
+
+// After each step of the rig: type the commands which are due, and log the flight.
+static void operatorUpdate(void*)
+{
+    for (int i = 0; i < numCommands; i++) {
+        if (!commands[i].isSent && halHostSeconds() >= commands[i].time) {
+            halHostUartReceive(commands[i].text, strlen(commands[i].text));
+            commands[i].isSent = true;
+        }
+    }
+
+    if (csv && plantSteps++ % LOG_PERIOD == 0) {
+        fprintf(csv, "%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f\n", halHostSeconds(), rig->height(), rig->yaw(),
+                halHostPwmDuty(HAL_PWM_MAIN) * 100, halHostPwmDuty(HAL_PWM_TAIL) * 100,
+                rig->mainSpeed(), rig->tailSpeed());
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    double seconds = 60;
+    uint32_t seed = 0;
+    bool isUartShown = false;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:s:o:u")) != -1) {
+        if (option == 't') {
+            seconds = atof(optarg);
+        } else if (option == 's') {
+            seed = (uint32_t)strtoul(optarg, 0, 10);
+        } else if (option == 'o') {
+            csv = fopen(optarg, "w");
+            if (!csv) {
+                perror(optarg);
+                return EXIT_FAILURE;
+            }
+            fprintf(csv, "time,height,yaw,mainDuty,tailDuty,mainSpeed,tailSpeed\n");
+        } else if (option == 'u') {
+            isUartShown = true;
+        } else {
+            fprintf(stderr, "usage: rigSim [-t seconds] [-s seed] [-o flight.csv] [-u] [seconds:command ...]\n");
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        if (!addCommand(argv[i])) {
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind == argc) {
+        for (const char* command : defaultFlight) {
+            addCommand(command);
+        }
+    }
+
+    RigParams params = seed ? rigRandomParams(rigDefaultParams(), RIG_SPREAD, seed) : rigDefaultParams();
+    RigModel model(params, seed);
+    RigPlant plant(model);
+    rig = &model;
+
+    if (isUartShown) {
+        halHostSetUartSink(printChar, 0);
+    }
+    plant.attach(PLANT_PERIOD_US, operatorUpdate, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    hal_host_stop_t stop = halHostRun(firmwareMain, seconds);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fflush(stdout);
+    if (csv) {
+        fclose(csv);
+    }
+
+    fprintf(stderr, "\nstopped at %.3f s: %s\n", halHostSeconds(),
+            stop == HAL_HOST_STOP_TIME ? "time up" : stop == HAL_HOST_STOP_RESET ? "reset" : "returned");
+    fprintf(stderr, "rig: height %.1f %%, yaw %.1f deg, rotors %.1f %% and %.1f %%, %u reference passes\n",
+            model.height(), model.yaw(), model.mainSpeed(), model.tailSpeed(), plant.referencePasses);
+    for (uint32_t row = 0; row < 4; row++) {
+        fprintf(stderr, "oled |%s|\n", halHostOledLine(row));
+    }
+    fprintf(stderr, "simulated %.1f s in %.3f s, %.0f simulated seconds per second, %llu interrupts\n",
+            halHostSeconds(), wall, halHostSeconds() / wall, (unsigned long long)halHostInterrupts());
+    return stop == HAL_HOST_STOP_TIME ? EXIT_SUCCESS : EXIT_FAILURE;
+}
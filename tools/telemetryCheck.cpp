@@ -0,0 +1,285 @@
+// ************************************************************
+// telemetryCheck.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Check the host decoders against the firmware telemetry encoder, and
+// work out the packet rate each baud rate can carry.
+// Explaination: A simulated flight is encoded with telemetryPacket.c, exactly
+// as telemetryUpdate(..) does, framed, and decoded again byte by byte. Packets
+// the UART had no room for are skipped without being committed, and some sent
+// packets are corrupted, to check that the decoder never reports a wrong state
+// and resyncs at the next key frame. Recording packets are built with
+// recorderPacket.c, as recorderUpdate(..) builds them, and framed, and some
+// are dropped to check that decoding carries on after the gap. Returns non
+// zero if any check fails.
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+
+#include "telemetryDecoder.h"
+#include "recordDecoder.h"
+
+#define FLIGHT_TICKS 20000  // 200 s at the 100 Hz control rate
+#define CONTROL_RATE 100  // Hz
+#define SKIP_ONE_IN 37  // packets the UART had no room for
+#define CORRUPT_ONE_IN 101  // packets damaged on the wire
+#define BITS_PER_BYTE 10  // 8 data bits with a start and stop bit
+#define RECORD_PACKETS 2000  // 100 s at 20 Hz
+#define RECORD_DROP_ONE_IN 23
+#define ADC_MAX 4095
+
+static int failures = 0;
+static uint32_t randomState = 1;
+
+
+static void check(bool isOk, const char* what)
+{
+    if (!isOk) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+
+// Repeatable pseudo random numbers, so a failure can be reproduced.
+static uint32_t nextRandom(void)
+{
+    randomState = randomState * 1103515245 + 12345;
+    return randomState >> 16;
+}
+
+
+// The state of a helicopter taking off, turning and landing, with some sensor noise.
+static void simulateFlight(uint32_t tick, int32_t* fields)
+{
+    uint32_t phase = tick * 4 / FLIGHT_TICKS;  // landed, climbing, turning, landing
+
+    fields[TELEMETRY_FIELD_MODE] = phase == 0 ? 0 : phase == 3 ? 3 : 2;
+    fields[TELEMETRY_FIELD_TARGET_HEIGHT] = phase == 0 || phase == 3 ? 0 : 50;
+    fields[TELEMETRY_FIELD_HEIGHT] = phase == 0 ? 0 : (int32_t)(tick % 1000) - 300 + (int32_t)(nextRandom() % 5);
+    fields[TELEMETRY_FIELD_TARGET_YAW] = phase == 2 ? -180 : 0;
+    fields[TELEMETRY_FIELD_YAW] = phase == 2 ? -(int32_t)(tick % 3600) : (int32_t)(nextRandom() % 3) - 1;
+    fields[TELEMETRY_FIELD_MAIN_DUTY] = phase == 0 ? 0 : 40 + (int32_t)(nextRandom() % 3);
+    fields[TELEMETRY_FIELD_TAIL_DUTY] = phase == 0 ? 0 : 30 + (int32_t)(nextRandom() % 3);
+}
+
+
+// The CRC is CRC-16/CCITT-FALSE, which has a published check value.
+static void checkCrc(void)
+{
+    const char* text = "123456789";
+    check(decoderCrc16((const uint8_t*)text, strlen(text)) == 0x29B1, "CRC check value");
+}
+
+
+// Varints written by the firmware read back the same, including the extremes.
+static void checkVarints(void)
+{
+    const int32_t values[] = {0, 1, -1, 63, -64, 64, -65, 8191, -8192, 1000000, INT32_MAX, INT32_MIN};
+    uint8_t bytes[TELEMETRY_MAX_VARINT_LENGTH];
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint32_t length = telemetryWriteVarint(bytes, values[i]);
+        std::vector<uint8_t> data(bytes, bytes + length);
+        size_t index = 0;
+        int32_t value = 0;
+        check(decoderReadVarint(data, index, value) && value == values[i] && index == length, "varint round trip");
+    }
+}
+
+
+// Encode and decode a whole flight, returning the mean framed packet length.
+static double checkFlight(bool hasLosses)
+{
+    telemetry_encoder_t encoder;
+    FrameDecoder frames;
+    TelemetryDecoder decoder;
+    TelemetryState state;
+    uint8_t raw[TELEMETRY_MAX_PACKET_LENGTH];
+    uint8_t framed[TELEMETRY_MAX_FRAMED_LENGTH];
+    int32_t fields[TELEMETRY_NUM_FIELDS];
+    uint32_t sent = 0, corrupted = 0, sinceCorrupted = 0;
+    uint64_t bytes = 0;
+
+    memset(&encoder, 0, sizeof(encoder));
+    telemetryEncoderReset(&encoder);
+
+    // start with the end of a frame, as when the decoder is started during a flight
+    frames.addByte(0x55);
+    frames.addByte(0x12);
+    frames.addByte(0);
+
+    for (uint32_t tick = 0; tick < FLIGHT_TICKS; tick++) {
+        simulateFlight(tick, fields);
+
+        uint32_t length = telemetryEncodeState(&encoder, fields, raw);
+        check(length <= TELEMETRY_MAX_PACKET_LENGTH, "packet length");
+        uint32_t framedLength = telemetryFrame(raw, length, framed);
+        check(framedLength > 0 && memchr(framed, 0, framedLength - 1) == 0 && framed[framedLength - 1] == 0,
+              "a single zero delimiter");
+
+        // as telemetryUpdate(..): a packet which didn't fit isn't committed
+        if (hasLosses && nextRandom() % SKIP_ONE_IN == 0) {
+            continue;
+        }
+        telemetryEncoderCommit(&encoder, fields);
+        sent++;
+        bytes += framedLength;
+
+        bool isCorrupted = hasLosses && nextRandom() % CORRUPT_ONE_IN == 0;
+        if (isCorrupted) {
+            framed[nextRandom() % (framedLength - 1)] ^= 1 << (nextRandom() % 8);
+            corrupted++;
+            sinceCorrupted = 0;
+        }
+
+        bool hasState = false;
+        for (uint32_t i = 0; i < framedLength; i++) {
+            if (frames.addByte(framed[i]) && decoder.decode(frames.packet(), state)) {
+                hasState = true;
+            }
+        }
+
+        if (hasState) {
+            check(memcmp(state.fields, fields, sizeof(fields)) == 0, "decoded state matches");
+        } else if (!isCorrupted) {
+            // a delta frame after a lost packet is only dropped until the next key frame
+            check(corrupted > 0 && sinceCorrupted < TELEMETRY_KEY_FRAME_INTERVAL, "resync at the next key frame");
+        }
+        sinceCorrupted++;
+    }
+
+    if (!hasLosses) {
+        check(decoder.states == sent && decoder.lostPackets == 0, "lossless stream");
+    }
+    printf("%s: %u sent, %u corrupted, %u decoded, %u CRC errors, %u framing errors, %u lost, %u unsynced\n",
+           hasLosses ? "lossy flight" : "flight", sent, corrupted, decoder.states, frames.crcErrors,
+           frames.framingErrors, decoder.lostPackets, decoder.unsyncedPackets);
+    return (double)bytes / sent;
+}
+
+
+// Build one recording packet with recorderPacket.c, as recorderUpdate(..) does, and frame it.
+static uint32_t buildRecordPacket(recorder_encoder_t* encoder, uint32_t time, int32_t count,
+                                  const uint16_t* samples, uint32_t numSamples,
+                                  const recorder_packet_event_t* events, uint32_t numEvents,
+                                  uint32_t dropped, uint8_t* framed)
+{
+    uint8_t packet[TELEMETRY_MAX_PACKET_LENGTH];
+    uint32_t length = recorderEncodePacket(encoder, time, count, samples, numSamples, events, numEvents,
+                                           dropped, packet);
+    return telemetryFrame(packet, length, framed);
+}
+
+
+// Record and decode random sensor inputs, dropping some packets as the firmware
+// does when the UART queue is full.
+static void checkRecording(void)
+{
+    FrameDecoder frames;
+    RecordDecoder decoder;
+    RecordPacket record;
+    recorder_encoder_t encoder;
+    uint8_t framed[TELEMETRY_MAX_FRAMED_LENGTH];
+    int32_t count = 0;
+    uint32_t dropped = 0;
+
+    recorderEncoderReset(&encoder);
+    for (uint32_t i = 0; i < RECORD_PACKETS; i++) {
+        uint32_t time = i * 50 + 7;
+        uint16_t samples[RECORDER_MAX_SAMPLES];
+        recorder_packet_event_t events[RECORDER_MAX_EVENTS];
+        uint32_t numSamples = i ? nextRandom() % (RECORDER_MAX_SAMPLES + 1) : 0;
+        uint32_t numEvents = i ? nextRandom() % (RECORDER_MAX_EVENTS + 1) : 0;
+        uint32_t lost = nextRandom() % 4 == 0 ? nextRandom() % 100 : 0;
+
+        count += (int32_t)(nextRandom() % 201) - 100;
+        for (uint32_t j = 0; j < numSamples; j++) {
+            samples[j] = nextRandom() % (ADC_MAX + 1);
+        }
+        for (uint32_t j = 0; j < numEvents; j++) {
+            events[j].type = nextRandom() % (RECORDER_EV_UART + 1);
+            events[j].data = nextRandom() % 256;
+            events[j].offset = (int32_t)(nextRandom() % 20000) - (int32_t)(nextRandom() % 50) * RECORDER_TICKS_PER_MS;
+        }
+        uint32_t framedLength = buildRecordPacket(&encoder, time, count, samples, numSamples, events, numEvents,
+                                                  lost, framed);
+        check(framedLength > 0, "recording packet fits");
+
+        // as recorderUpdate(..): a lost packet can't be resent, so the next starts from 0
+        if (i && nextRandom() % RECORD_DROP_ONE_IN == 0) {
+            dropped++;
+            recorderEncoderLost(&encoder);
+            continue;
+        }
+
+        bool isDecoded = false;
+        for (uint32_t j = 0; j < framedLength; j++) {
+            if (frames.addByte(framed[j]) && decoder.decode(frames.packet(), record)) {
+                isDecoded = true;
+            }
+        }
+        check(isDecoded && record.encoderCount == count && record.samples.size() == numSamples &&
+              record.events.size() == numEvents && record.time == time && record.dropped == lost &&
+              record.isStart == (i == 0), "recording packet decoded");
+        for (uint32_t j = 0; isDecoded && j < numSamples && j < record.samples.size(); j++) {
+            check(record.samples[j] == samples[j], "recorded sample matches");
+        }
+        for (uint32_t j = 0; isDecoded && j < numEvents && j < record.events.size(); j++) {
+            check(record.events[j].ticks == (int64_t)time * RECORDER_TICKS_PER_MS + events[j].offset &&
+                  record.events[j].type == events[j].type && record.events[j].data == events[j].data,
+                  "recorded event matches");
+        }
+    }
+
+    // the longest packet: every number at its widest
+    uint16_t samples[RECORDER_MAX_SAMPLES];
+    recorder_packet_event_t events[RECORDER_MAX_EVENTS];
+    for (uint32_t j = 0; j < RECORDER_MAX_SAMPLES; j++) {
+        samples[j] = j % 2 ? ADC_MAX : 0;
+    }
+    for (uint32_t j = 0; j < RECORDER_MAX_EVENTS; j++) {
+        events[j].type = RECORDER_EV_UART;
+        events[j].data = 0xFF;
+        events[j].offset = INT32_MIN;
+    }
+    recorderEncoderLost(&encoder);
+    check(buildRecordPacket(&encoder, UINT32_MAX, INT32_MIN, samples, RECORDER_MAX_SAMPLES, events,
+                            RECORDER_MAX_EVENTS, UINT32_MAX, framed) > 0, "longest recording packet fits");
+
+    check(decoder.lostPackets == dropped && decoder.recordings == 1, "recording gaps counted");
+    printf("recording: %u packets, %u dropped, %u decoded, %u lost\n", RECORD_PACKETS, dropped,
+           decoder.packets, decoder.lostPackets);
+}
+
+
+// The packet rate the UART can carry for the mean packet length.
+static void reportThroughput(double meanLength)
+{
+    const uint32_t baudRates[] = {9600, 115200};
+
+    printf("mean framed packet: %.2f bytes\n", meanLength);
+    for (size_t i = 0; i < sizeof(baudRates) / sizeof(baudRates[0]); i++) {
+        double rate = baudRates[i] / BITS_PER_BYTE / meanLength;
+        printf("%6u baud: %.0f packets/s, %s the %d Hz control rate\n", baudRates[i], rate,
+               rate >= CONTROL_RATE ? "keeps up with" : "falls behind", CONTROL_RATE);
+    }
+}
+
+
+int main(void)
+{
+    checkCrc();
+    checkVarints();
+    reportThroughput(checkFlight(false));
+    checkFlight(true);
+    checkRecording();
+
+    printf(failures ? "%d checks failed\n" : "all checks passed\n", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,52 @@
+// ************************************************************
+// telemetryDecode.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Turn a capture of the binary telemetry into CSV.
+// Explaination: Reads the raw UART bytes from the file given, or stdin, and
+// prints one line per decoded state. Height and yaw are printed to one
+// decimal place. The decoder statistics are printed to stderr at the end.
+//   telemetryDecode capture.bin > flight.csv
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "telemetryDecoder.h"
+
+
+int main(int argc, char** argv)
+{
+    FILE* input = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    FrameDecoder frames;
+    TelemetryDecoder decoder;
+    TelemetryState state;
+    int c;
+
+    if (!input) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    printf("sequence,mode,target_height,height,target_yaw,yaw,main_duty,tail_duty\n");
+    while ((c = fgetc(input)) != EOF) {
+        if (!frames.addByte((uint8_t)c) || !decoder.decode(frames.packet(), state)) {
+            continue;
+        }
+        const int32_t* f = state.fields;
+        printf("%u,%d,%d,%.1f,%d,%.1f,%d,%d\n", state.sequence, f[TELEMETRY_FIELD_MODE],
+               f[TELEMETRY_FIELD_TARGET_HEIGHT], (double)f[TELEMETRY_FIELD_HEIGHT] / TELEMETRY_PRECISION,
+               f[TELEMETRY_FIELD_TARGET_YAW], (double)f[TELEMETRY_FIELD_YAW] / TELEMETRY_PRECISION,
+               f[TELEMETRY_FIELD_MAIN_DUTY], f[TELEMETRY_FIELD_TAIL_DUTY]);
+    }
+
+    fprintf(stderr, "%u states, %u CRC errors, %u framing errors, %u lost, %u unsynced, %u malformed\n",
+            decoder.states, frames.crcErrors, frames.framingErrors, decoder.lostPackets,
+            decoder.unsyncedPackets, decoder.malformedPackets);
+    if (input != stdin) {
+        fclose(input);
+    }
+    return EXIT_SUCCESS;
+}
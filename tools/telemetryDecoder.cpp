@@ -0,0 +1,194 @@
+// ************************************************************
+// telemetryDecoder.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Decode the binary telemetry sent by the helicopter over UART.
+// Explaination: See telemetryDecoder.h.
+// ************************************************************
+
+#include "telemetryDecoder.h"
+
+#define CRC_INITIAL 0xFFFF
+#define CRC_POLYNOMIAL 0x1021
+#define CRC_LENGTH 2
+#define COBS_MAX_CODE 0xFF
+
+
+// CRC-16 (CCITT) over length bytes of data, as added to every packet.
+uint16_t decoderCrc16(const uint8_t* data, size_t length)
+{
+    uint16_t crc = CRC_INITIAL;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ CRC_POLYNOMIAL) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+
+// Read a zigzag varint from data at index, moving index past it. Returns false if
+// the varint runs past the end of data or is longer than 5 bytes.
+bool decoderReadVarint(const std::vector<uint8_t>& data, size_t& index, int32_t& value)
+{
+    uint32_t zigzag = 0;
+
+    for (int i = 0; i < TELEMETRY_MAX_VARINT_LENGTH; i++) {
+        if (index >= data.size()) {
+            return false;
+        }
+        uint8_t byte = data[index++];
+        zigzag |= (uint32_t)(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            value = (int32_t)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+            return true;
+        }
+    }
+    return false;
+}
+
+
+FrameDecoder::FrameDecoder()
+    : packets(0), crcErrors(0), framingErrors(0)
+{
+    // room for the longest frame, so that decoding a long stream never allocates
+    frame.reserve(TELEMETRY_MAX_FRAMED_LENGTH + 1);
+    payload.reserve(TELEMETRY_MAX_FRAMED_LENGTH);
+}
+
+
+// Add one received byte. Returns true if it completed a packet with a valid
+// CRC, which is then in packet() without the CRC.
+bool FrameDecoder::addByte(uint8_t byte)
+{
+    if (byte != 0) {
+        // a frame longer than the firmware can send has lost its delimiter
+        if (frame.size() < TELEMETRY_MAX_FRAMED_LENGTH) {
+            frame.push_back(byte);
+        } else if (frame.size() == TELEMETRY_MAX_FRAMED_LENGTH) {
+            framingErrors++;
+            frame.push_back(byte);
+        }
+        return false;
+    }
+
+    if (frame.empty()) {
+        return false;
+    }
+    if (frame.size() > TELEMETRY_MAX_FRAMED_LENGTH) {
+        frame.clear();
+        return false;
+    }
+
+    // undo the COBS framing, each code is followed by code - 1 data bytes and then a
+    // zero, except for the last block and blocks of the maximum length
+    payload.clear();
+    size_t i = 0;
+    bool isValid = true;
+    while (i < frame.size()) {
+        uint8_t code = frame[i++];
+        if (i + code - 1 > frame.size()) {
+            isValid = false;
+            break;
+        }
+        payload.insert(payload.end(), frame.begin() + i, frame.begin() + i + code - 1);
+        i += code - 1;
+        if (code != COBS_MAX_CODE && i < frame.size()) {
+            payload.push_back(0);
+        }
+    }
+    frame.clear();
+
+    if (!isValid || payload.size() < CRC_LENGTH) {
+        framingErrors++;
+        return false;
+    }
+
+    size_t length = payload.size() - CRC_LENGTH;
+    uint16_t crc = (uint16_t)(payload[length] << 8 | payload[length + 1]);
+    if (decoderCrc16(payload.data(), length) != crc) {
+        crcErrors++;
+        return false;
+    }
+    payload.resize(length);
+    packets++;
+    return true;
+}
+
+
+TelemetryDecoder::TelemetryDecoder()
+    : states(0), lostPackets(0), malformedPackets(0), unsyncedPackets(0),
+      isSynced(false), nextSequence(0), fields()
+{
+}
+
+
+// Decode one packet from a FrameDecoder. Returns true if state now holds the
+// full state. Returns false for other packets, malformed packets and delta
+// frames which can't be applied because a packet was lost, until the next key frame.
+bool TelemetryDecoder::decode(const std::vector<uint8_t>& packet, TelemetryState& state)
+{
+    int32_t decoded[TELEMETRY_NUM_FIELDS];
+    size_t index = 2;
+
+    if (packet.size() < 2 || (packet[0] != TELEMETRY_KEY_FRAME && packet[0] != TELEMETRY_DELTA_FRAME)) {
+        return false;
+    }
+    bool isKeyFrame = packet[0] == TELEMETRY_KEY_FRAME;
+    uint8_t sequence = packet[1];
+
+    if (isSynced && sequence != nextSequence) {
+        lostPackets += (uint8_t)(sequence - nextSequence);
+        isSynced = false;
+    }
+    nextSequence = (uint8_t)(sequence + 1);
+
+    if (isKeyFrame) {
+        for (int i = 0; i < TELEMETRY_NUM_FIELDS; i++) {
+            if (!decoderReadVarint(packet, index, decoded[i])) {
+                malformedPackets++;
+                isSynced = false;
+                return false;
+            }
+        }
+    } else {
+        if (!isSynced) {
+            unsyncedPackets++;
+            return false;
+        }
+        if (index >= packet.size()) {
+            malformedPackets++;
+            isSynced = false;
+            return false;
+        }
+        uint8_t mask = packet[index++];
+        for (int i = 0; i < TELEMETRY_NUM_FIELDS; i++) {
+            int32_t change = 0;
+            if ((mask & (1 << i)) && !decoderReadVarint(packet, index, change)) {
+                malformedPackets++;
+                isSynced = false;
+                return false;
+            }
+            decoded[i] = (int32_t)((uint32_t)fields[i] + (uint32_t)change);
+        }
+    }
+    if (index != packet.size()) {
+        malformedPackets++;
+        isSynced = false;
+        return false;
+    }
+
+    isSynced = true;
+    states++;
+    state.sequence = sequence;
+    state.isKeyFrame = isKeyFrame;
+    for (int i = 0; i < TELEMETRY_NUM_FIELDS; i++) {
+        fields[i] = decoded[i];
+        state.fields[i] = decoded[i];
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+// ************************************************************
+// telemetryDecoder.h
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Decode the binary telemetry sent by the helicopter over UART.
+// Explaination: FrameDecoder splits the received bytes into packets, undoing
+// the COBS framing and checking the CRC-16. TelemetryDecoder then rebuilds the
+// full state from the key and delta frames, see telemetryPacket.h. This is
+// written independently of the firmware encoder so that telemetryCheck.cpp can
+// check one against the other.
+// ************************************************************
+
+#ifndef TELEMETRYDECODER_H_
+#define TELEMETRYDECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../telemetryPacket.h"
+
+
+// CRC-16 (CCITT) over length bytes of data, as added to every packet.
+uint16_t decoderCrc16(const uint8_t* data, size_t length);
+
+
+// Read a zigzag varint from data at index, moving index past it. Returns false if
+// the varint runs past the end of data or is longer than 5 bytes.
+bool decoderReadVarint(const std::vector<uint8_t>& data, size_t& index, int32_t& value);
+
+
+// Splits a stream of bytes into packets. A partly received frame at the start of
+// the stream fails its CRC and is dropped.
+class FrameDecoder {
+public:
+    FrameDecoder();
+
+    // Add one received byte. Returns true if it completed a packet with a valid
+    // CRC, which is then in packet() without the CRC.
+    bool addByte(uint8_t byte);
+
+    const std::vector<uint8_t>& packet() const { return payload; }
+
+    uint32_t packets;  // with a valid CRC
+    uint32_t crcErrors;
+    uint32_t framingErrors;  // broken COBS or too long
+
+private:
+    std::vector<uint8_t> frame;
+    std::vector<uint8_t> payload;
+};
+
+
+// The state carried by a telemetry packet.
+struct TelemetryState {
+    uint8_t sequence;
+    bool isKeyFrame;
+    int32_t fields[TELEMETRY_NUM_FIELDS];  // in telemetry_field_t order
+};
+
+
+// Rebuilds the state from the packets of one telemetry stream.
+class TelemetryDecoder {
+public:
+    TelemetryDecoder();
+
+    // Decode one packet from a FrameDecoder. Returns true if state now holds the
+    // full state. Returns false for other packets, malformed packets and delta
+    // frames which can't be applied because a packet was lost, until the next key frame.
+    bool decode(const std::vector<uint8_t>& packet, TelemetryState& state);
+
+    uint32_t states;  // decoded
+    uint32_t lostPackets;  // missing from the sequence
+    uint32_t malformedPackets;
+    uint32_t unsyncedPackets;  // delta frames dropped while waiting for a key frame
+
+private:
+    bool isSynced;
+    uint8_t nextSequence;
+    int32_t fields[TELEMETRY_NUM_FIELDS];
+};
+
+
+#endif /* TELEMETRYDECODER_H_ */
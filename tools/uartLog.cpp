@@ -0,0 +1,298 @@
+// ************************************************************
+// uartLog.cpp
+// Helicopter project, host tools
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Record the UART stream of the helicopter as a time-indexed log and
+// measure the step responses of the height and yaw while it runs.
+// Explaination: Reads a serial device, a pty, a capture file or stdin, and
+// parses the bytes as they arrive into fixed buffers, with no allocation per
+// line or packet, so memory stays the same for any length of session. Text mode
+// takes the ALT and YAW lines of the status block (4 Hz). Binary mode (-b)
+// takes the telemetry states of the T B command (100 Hz while flying). Each
+// sample is written to stdout as
+//   time_ms,flying,target_height,height,target_yaw,yaw
+// Steps are measured while flying with the firmware's stepAnalysis.c and printed
+// to stderr as each completes, with a summary at the end or on Ctrl-C.
+// Time is the host clock when reading a device or pipe. A capture read from a
+// regular file has no arrival times, so time moves on by the nominal period of
+// each sample instead: 250 ms per status block, or 10 ms per telemetry state
+// (50 ms while landed).
+//   uartLog /dev/ttyACM0 > session.csv
+//   uartLog -b -s 115200 /dev/ttyACM0 > session.csv
+// ************************************************************
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "telemetryDecoder.h"
+#include "../stepAnalysis.h"
+
+#define LINE_LENGTH 64  // longer than any line the firmware sends
+#define READ_LENGTH 256
+#define TEXT_PERIOD 250  // ms between status blocks
+#define FLYING_PERIOD 10  // ms between telemetry states while flying
+#define LANDED_PERIOD 50  // ms between telemetry states otherwise
+#define MODE_FLYING 2  // STATE_FLYING in stateInfo.h
+#define NUM_AXES 2
+
+static const char* axisNames[NUM_AXES] = {"height", "yaw"};
+static const char* axisUnits[NUM_AXES] = {"%", "deg"};
+
+// Running totals of the completed steps on one axis
+struct StepSummary {
+    uint32_t steps;
+    uint64_t riseTime;
+    int64_t overshoot;
+    uint64_t settlingTime;
+    int64_t absError;
+};
+
+static volatile sig_atomic_t isStopping = 0;
+static bool isFile = false;
+static uint32_t nominalTime = 0;  // ms, for captures read from a file
+static bool wasFlying = false;
+static step_analysis_t analyses[NUM_AXES];
+static StepSummary summaries[NUM_AXES];
+
+
+static void stop(int)
+{
+    isStopping = 1;
+}
+
+
+// Milliseconds on the host clock since the first call.
+static uint32_t hostTime(void)
+{
+    static struct timespec start;
+    static bool isStarted = false;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (!isStarted) {
+        start = now;
+        isStarted = true;
+    }
+    return (uint32_t)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+}
+
+
+// Raw mode at baud for a serial device. Pipes, ptys in raw mode and files are left alone.
+static bool setBaud(int fd, uint32_t baud)
+{
+    struct termios tty;
+    speed_t speed = baud == 115200 ? B115200 : baud == 57600 ? B57600 : baud == 38400 ? B38400 :
+                    baud == 19200 ? B19200 : B9600;
+
+    if (tcgetattr(fd, &tty) != 0) {
+        return true;  // not a terminal
+    }
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tty) == 0;
+}
+
+
+static void addStep(int axis, const step_metrics_t& m)
+{
+    StepSummary& s = summaries[axis];
+
+    s.steps++;
+    s.riseTime += m.riseTime;
+    s.overshoot += m.overshoot;
+    s.settlingTime += m.settlingTime;
+    s.absError += llabs(m.steadyStateError);
+    fprintf(stderr, "%s step %+d %s at %.3f s: rise %u ms, overshoot %d %%, settling %u ms, error %.3f %s\n",
+            axisNames[axis], m.stepSize, axisUnits[axis], m.startTime / 1000.0, m.riseTime, m.overshoot,
+            m.settlingTime, (double)m.steadyStateError / STEP_PRECISION, axisUnits[axis]);
+}
+
+
+// Log one sample, measurements scaled by STEP_PRECISION, and analyse it while flying.
+static void addSample(uint32_t period, bool isFlying, const int32_t* targets, const int32_t* measured)
+{
+    uint32_t time = isFile ? (nominalTime += period) : hostTime();
+    step_metrics_t metrics;
+
+    printf("%u,%d,%d,%.1f,%d,%.1f\n", time, isFlying, targets[0], (double)measured[0] / STEP_PRECISION,
+           targets[1], (double)measured[1] / STEP_PRECISION);
+
+    // as stepResponseReset(..), the targets are ramped in the other modes, which are not steps
+    for (int axis = 0; axis < NUM_AXES; axis++) {
+        if (isFlying && !wasFlying) {
+            stepAnalysisReset(&analyses[axis], targets[axis]);
+        }
+        if (isFlying && stepAnalysisUpdate(&analyses[axis], targets[axis], measured[axis], time, &metrics)) {
+            addStep(axis, metrics);
+        }
+    }
+    wasFlying = isFlying;
+}
+
+
+// Parses the status block lines of the text stream.
+class TextParser {
+public:
+    TextParser() : length(0), isOverlong(false), hasHeight(false), isFlying(false), targets(), measured() {}
+
+    void addByte(uint8_t byte)
+    {
+        if (byte != '\n' && byte != '\r') {
+            if (length < LINE_LENGTH - 1) {
+                line[length++] = (char)byte;
+            } else {
+                isOverlong = true;
+            }
+            return;
+        }
+        line[length] = '\0';
+        if (length && !isOverlong) {
+            parseLine();
+        }
+        length = 0;
+        isOverlong = false;
+    }
+
+private:
+    void parseLine(void)
+    {
+        int target, value;
+
+        if (sscanf(line, "ALT %d [%d]", &target, &value) == 2) {
+            targets[0] = target;
+            measured[0] = value * STEP_PRECISION;
+            hasHeight = true;
+        } else if (sscanf(line, "YAW %d [%d]", &target, &value) == 2 && hasHeight) {
+            targets[1] = target;
+            measured[1] = value * STEP_PRECISION;
+            hasHeight = false;
+            // the mode line follows, so this block is taken with the mode of the last one
+            addSample(TEXT_PERIOD, isFlying, targets, measured);
+        } else if (strncmp(line, "MODE ", 5) == 0) {
+            isFlying = strcmp(line + 5, "Flying") == 0;
+        }
+    }
+
+    char line[LINE_LENGTH];
+    uint32_t length;
+    bool isOverlong;
+    bool hasHeight;
+    bool isFlying;
+    int32_t targets[NUM_AXES];
+    int32_t measured[NUM_AXES];
+};
+
+
+// Decodes the binary telemetry states.
+class BinaryParser {
+public:
+    void addByte(uint8_t byte)
+    {
+        if (!frames.addByte(byte) || !decoder.decode(frames.packet(), state)) {
+            return;
+        }
+        const int32_t* f = state.fields;
+        bool isFlying = f[TELEMETRY_FIELD_MODE] == MODE_FLYING;
+        int32_t targets[NUM_AXES] = {f[TELEMETRY_FIELD_TARGET_HEIGHT], f[TELEMETRY_FIELD_TARGET_YAW]};
+        int32_t measured[NUM_AXES] = {f[TELEMETRY_FIELD_HEIGHT] * (STEP_PRECISION / TELEMETRY_PRECISION),
+                                      f[TELEMETRY_FIELD_YAW] * (STEP_PRECISION / TELEMETRY_PRECISION)};
+        addSample(isFlying ? FLYING_PERIOD : LANDED_PERIOD, isFlying, targets, measured);
+    }
+
+    FrameDecoder frames;
+    TelemetryDecoder decoder;
+
+private:
+    TelemetryState state;
+};
+
+
+static void printSummary(void)
+{
+    for (int axis = 0; axis < NUM_AXES; axis++) {
+        const StepSummary& s = summaries[axis];
+        if (!s.steps) {
+            fprintf(stderr, "%s: no steps\n", axisNames[axis]);
+            continue;
+        }
+        fprintf(stderr, "%s: %u steps, mean rise %llu ms, overshoot %lld %%, settling %llu ms, |error| %.3f %s\n",
+                axisNames[axis], s.steps, (unsigned long long)(s.riseTime / s.steps),
+                (long long)(s.overshoot / s.steps), (unsigned long long)(s.settlingTime / s.steps),
+                (double)s.absError / s.steps / STEP_PRECISION, axisUnits[axis]);
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    bool isBinary = false;
+    uint32_t baud = 9600;
+    int option;
+
+    while ((option = getopt(argc, argv, "bs:")) != -1) {
+        if (option == 'b') {
+            isBinary = true;
+        } else if (option == 's') {
+            baud = (uint32_t)strtoul(optarg, 0, 10);
+        } else {
+            fprintf(stderr, "usage: uartLog [-b] [-s baud] [device or file] > log.csv\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    int fd = optind < argc ? open(argv[optind], O_RDONLY | O_NOCTTY) : STDIN_FILENO;
+    struct stat info;
+    if (fd < 0 || !setBaud(fd, baud)) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    isFile = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+
+    // stop cleanly so that a long session still gets its summary
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop;
+    sigaction(SIGINT, &action, 0);
+    sigaction(SIGTERM, &action, 0);
+
+    TextParser text;
+    BinaryParser binary;
+    uint8_t bytes[READ_LENGTH];
+    ssize_t length;
+
+    printf("time_ms,flying,target_height,height,target_yaw,yaw\n");
+    while (!isStopping && (length = read(fd, bytes, sizeof(bytes))) > 0) {
+        for (ssize_t i = 0; i < length; i++) {
+            if (isBinary) {
+                binary.addByte(bytes[i]);
+            } else {
+                text.addByte(bytes[i]);
+            }
+        }
+        if (!isFile) {
+            fflush(stdout);
+        }
+    }
+
+    printSummary();
+    if (isBinary) {
+        fprintf(stderr, "%u states, %u CRC errors, %u framing errors, %u lost\n", binary.decoder.states,
+                binary.frames.crcErrors, binary.frames.framingErrors, binary.decoder.lostPackets);
+    }
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return EXIT_SUCCESS;
+}
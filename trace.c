@@ -0,0 +1,144 @@
+// ************************************************************
+// trace.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Record a timeline of what the firmware did, to see how tasks,
+// interrupts and mode changes interact.
+// Explaination: Events are recorded inline by TRACE(..). This file sends the
+// ring as Chrome trace events. Tasks are shown on thread 0 and interrupts on
+// thread 1, with times in us from the oldest event in the ring.
+// ************************************************************
+
+#include "trace.h"
+#include "uartDisplay.h"
+#include "telemetry.h"
+#include "timerer.h"
+#include "utils/ustdlib.h"
+
+#define TRACE_LINE_LENGTH 112
+#define US_PER_MS 1000
+#define TRACE_TASK_THREAD 0
+#define TRACE_ISR_THREAD 1
+
+#if TRACE_ENABLED
+trace_event_t traceBuffer[TRACE_BUFFER_SIZE];
+uint32_t traceHead = 0;
+volatile bool traceIsFrozen = false;
+#endif
+
+static bool isDumping = false;
+static bool hasSentStart;
+static uint32_t dumpNext;  // index into traceHead numbering of the next event to send
+static uint32_t dumpStartTime;  // cycle count of the oldest event
+static uint32_t dumpLastTime;  // cycle count of the last event sent
+
+
+// Start the cycle counter and begin recording.
+void traceInit(void)
+{
+    halCyclesInit();
+}
+
+
+// Stop recording and send the ring, starting from the next call to traceDumpUpdate(..).
+void traceDumpStart(void)
+{
+#if TRACE_ENABLED
+    traceIsFrozen = true;
+    dumpNext = traceHead > TRACE_BUFFER_SIZE ? traceHead - TRACE_BUFFER_SIZE : 0;
+    dumpStartTime = traceBuffer[dumpNext & (TRACE_BUFFER_SIZE - 1)].time;
+    dumpLastTime = dumpStartTime;
+    hasSentStart = false;
+    isDumping = true;
+#endif
+}
+
+
+// Return true while the ring is being sent, so other UART text can be held back.
+bool traceIsDumping(void)
+{
+    return isDumping;
+}
+
+
+#if TRACE_ENABLED
+
+// Format one event as a Chrome trace event into line.
+static void traceFormatEvent(char* line, const trace_event_t* event)
+{
+    // in tenths of a us, which is enough to see the short interrupts
+    uint32_t cyclesPerUs = timererMsToTicks(1) / US_PER_MS;
+    uint32_t ts = (uint64_t)(event->time - dumpStartTime) * 10 / cyclesPerUs;
+
+    switch (event->type) {
+    case TRACE_TASK_START:
+    case TRACE_TASK_STOP:
+    case TRACE_ISR_ENTER:
+    case TRACE_ISR_EXIT:
+        usnprintf(line, TRACE_LINE_LENGTH,
+                  "{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%u.%u,\"pid\":0,\"tid\":%u},\r\n",
+                  probeGetName(event->id),
+                  (event->type == TRACE_TASK_START || event->type == TRACE_ISR_ENTER) ? "B" : "E",
+                  ts / 10, ts % 10,
+                  (event->type == TRACE_TASK_START || event->type == TRACE_TASK_STOP) ? TRACE_TASK_THREAD : TRACE_ISR_THREAD);
+        break;
+    case TRACE_MODE:
+        usnprintf(line, TRACE_LINE_LENGTH,
+                  "{\"name\":\"mode %u\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%u.%u,\"pid\":0,\"tid\":0,\"args\":{\"event\":%u}},\r\n",
+                  event->id, ts / 10, ts % 10, event->value);
+        break;
+    case TRACE_OUTPUT:
+        usnprintf(line, TRACE_LINE_LENGTH,
+                  "{\"name\":\"%s duty\",\"ph\":\"C\",\"ts\":%u.%u,\"pid\":0,\"args\":{\"duty\":%u}},\r\n",
+                  event->id ? "tail" : "main", ts / 10, ts % 10, event->value);
+        break;
+    default:
+        line[0] = '\0';
+    }
+}
+
+#endif
+
+
+// Task to send as many events as fit in the UART queue. Recording starts again
+// with an empty ring once the whole ring has been sent.
+void traceDumpUpdate(state_t* state, uint32_t deltaTime)
+{
+#if TRACE_ENABLED
+    char line[TRACE_LINE_LENGTH];
+
+    // don't put text into the middle of a binary stream
+    if (!isDumping || telemetryGetMode() != TELEMETRY_TEXT) {
+        return;
+    }
+
+    if (!hasSentStart) {
+        if (!uartSend("[\r\n")) {
+            return;
+        }
+        hasSentStart = true;
+    }
+
+    while (dumpNext < traceHead && uartTxSpace() >= TRACE_LINE_LENGTH) {
+        const trace_event_t* event = &traceBuffer[dumpNext & (TRACE_BUFFER_SIZE - 1)];
+        traceFormatEvent(line, event);
+        uartSend(line);
+        dumpLastTime = event->time;
+        dumpNext++;
+    }
+
+    // finish with an event which has no comma after it
+    if (dumpNext >= traceHead && uartTxSpace() >= TRACE_LINE_LENGTH) {
+        uint32_t ts = (uint64_t)(dumpLastTime - dumpStartTime) * 10 / (timererMsToTicks(1) / US_PER_MS);
+        usnprintf(line, sizeof(line), "{\"name\":\"end\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%u.%u,\"pid\":0,\"tid\":0}]\r\n",
+                  ts / 10, ts % 10);
+        uartSend(line);
+
+        traceHead = 0;
+        isDumping = false;
+        traceIsFrozen = false;
+    }
+#endif
+}
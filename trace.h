@@ -0,0 +1,108 @@
+// ************************************************************
+// trace.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Record a timeline of what the firmware did, to see how tasks,
+// interrupts and mode changes interact.
+// Explaination: TRACE(..) stores an 8 byte event with the DWT cycle count in a
+// RAM ring, so the ring always holds the most recent TRACE_BUFFER_SIZE events.
+// Task and interrupt events use the probe ids of probe.h. traceDumpStart()
+// stops recording and traceDumpUpdate(..) sends the ring over UART in the
+// Chrome trace event format (a JSON array, one event per line), which can be
+// saved to a file and opened in Perfetto or chrome://tracing. At 9600 baud a
+// full dump takes about 15 s. With TRACE_ENABLED set to 0 TRACE(..) compiles
+// to nothing.
+// ************************************************************
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "hal.h"
+#include "stateInfo.h"
+#include "probe.h"
+
+#define TRACE_ENABLED 1  // set to 0 to remove the trace from the build
+#define TRACE_BUFFER_SIZE 256  // events, must be a power of two
+
+// Kinds of trace events.
+typedef enum {
+    TRACE_TASK_START = 0,  // id is the task's probe_id_t
+    TRACE_TASK_STOP,
+    TRACE_ISR_ENTER,  // id is the interrupt's probe_id_t
+    TRACE_ISR_EXIT,
+    TRACE_MODE,  // id is the new heli_state_t, value is the flight_event_t
+    TRACE_OUTPUT  // id is the control_duty_t, value is the duty in %
+} trace_type_t;
+
+
+// One event in the ring.
+typedef struct {
+    uint32_t time;  // DWT cycle count
+    uint8_t type;  // trace_type_t
+    uint8_t id;
+    uint16_t value;
+} trace_event_t;
+
+
+#if TRACE_ENABLED
+
+extern trace_event_t traceBuffer[TRACE_BUFFER_SIZE];
+extern uint32_t traceHead;  // total events recorded, the next goes at traceHead % TRACE_BUFFER_SIZE
+extern volatile bool traceIsFrozen;
+
+// Record an event, see trace_type_t for the meaning of id and value.
+#define TRACE(type, id, value) traceRecord((type), (id), (value))
+
+// Record an event. Kept inline so an event costs a few cycles. Interrupts are masked
+// while a slot is taken, so events from interrupts and tasks never share a slot.
+static inline void traceRecord(trace_type_t type, uint8_t id, uint16_t value)
+{
+    uint32_t time = halCycles();
+    uint32_t slot;
+
+    if (traceIsFrozen) {
+        return;
+    }
+
+    bool prevIntState = halInterruptsDisable();
+    slot = traceHead++ & (TRACE_BUFFER_SIZE - 1);
+    if (!prevIntState) {
+        halInterruptsEnable();
+    }
+
+    traceBuffer[slot].time = time;
+    traceBuffer[slot].type = type;
+    traceBuffer[slot].id = id;
+    traceBuffer[slot].value = value;
+}
+
+#else
+
+#define TRACE(type, id, value)
+
+#endif
+
+
+// Start the cycle counter and begin recording.
+void traceInit(void);
+
+
+// Stop recording and send the ring, starting from the next call to traceDumpUpdate(..).
+void traceDumpStart(void);
+
+
+// Return true while the ring is being sent, so other UART text can be held back.
+bool traceIsDumping(void);
+
+
+// Task to send as many events as fit in the UART queue. Recording starts again
+// with an empty ring once the whole ring has been sent.
+void traceDumpUpdate(state_t* state, uint32_t deltaTime);
+
+
+#endif /* TRACE_H_ */
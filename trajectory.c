@@ -0,0 +1,103 @@
+// ************************************************************
+// trajectory.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Generate smooth references for the controllers from target changes.
+// Explaination: Instead of jumping to a new target, the reference accelerates
+// towards it at the maximum acceleration, cruises at the maximum velocity and
+// decelerates to stop on the target. This is the minimum time path within the
+// limits. The velocity of the reference can be used as feedforward for the
+// derivative term of a PID controller.
+// ************************************************************
+
+#include <stdlib.h>
+
+#include "trajectory.h"
+
+#define MS_TO_SEC 1000  // number of ms in one s
+#define SIGN(n) ((n) < 0 ? -1 : 1)
+
+
+// A helper function. Limit the value n between two lower and upper
+// values (inclusive). Return the limited value.
+static int32_t limit(int32_t n, int32_t lower, int32_t upper)
+{
+    if (n < lower)
+        return lower;
+    else if (n > upper)
+        return upper;
+    return n;
+}
+
+
+// Integer square root, rounded down.
+static uint32_t squareRoot(uint64_t n)
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > n) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+
+// Set the limits of a trajectory and place it at rest at position.
+void trajectoryInit(trajectory_t* trajectory, int32_t maxVelocity, int32_t maxAcceleration)
+{
+    trajectory->maxVelocity = maxVelocity;
+    trajectory->maxAcceleration = maxAcceleration;
+    trajectoryReset(trajectory, 0);
+}
+
+
+// Place the trajectory at rest at position, e.g. when the measurement jumps.
+void trajectoryReset(trajectory_t* trajectory, int32_t position)
+{
+    trajectory->position = position;
+    trajectory->velocity = 0;
+}
+
+
+// Advance the trajectory by deltaTime milliseconds towards target.
+void trajectoryUpdate(trajectory_t* trajectory, int32_t target, uint32_t deltaTime)
+{
+    int32_t error = target - trajectory->position;
+    int32_t velocityStep = trajectory->maxAcceleration * (int32_t)deltaTime / MS_TO_SEC;
+
+    // close enough to stop on the target within this update
+    if (abs(error) <= abs(trajectory->velocity) * (int32_t)deltaTime / MS_TO_SEC + 1 &&
+            abs(trajectory->velocity) <= velocityStep) {
+        trajectory->position = target;
+        trajectory->velocity = 0;
+        return;
+    }
+
+    // the fastest velocity from which we can still stop on the target: v^2 = 2as, less half
+    // a step to allow for the velocity only changing once per update
+    int32_t stoppingVelocity = squareRoot((uint64_t)2 * trajectory->maxAcceleration * abs(error)) - velocityStep / 2;
+    int32_t wantedVelocity = SIGN(error) * limit(stoppingVelocity, 0, trajectory->maxVelocity);
+
+    // change towards the wanted velocity no faster than the acceleration limit
+    trajectory->velocity += limit(wantedVelocity - trajectory->velocity, -velocityStep, velocityStep);
+    trajectory->position += trajectory->velocity * (int32_t)deltaTime / MS_TO_SEC;
+}
+
+
+// Return true if the trajectory is at rest on target.
+bool trajectoryIsDone(trajectory_t* trajectory, int32_t target)
+{
+    return trajectory->position == target && trajectory->velocity == 0;
+}
@@ -0,0 +1,56 @@
+// ************************************************************
+// trajectory.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Generate smooth references for the controllers from target changes.
+// Explaination: Instead of jumping to a new target, the reference accelerates
+// towards it at the maximum acceleration, cruises at the maximum velocity and
+// decelerates to stop on the target. This is the minimum time path within the
+// limits. The velocity of the reference can be used as feedforward for the
+// derivative term of a PID controller. Values are scaled by PRECISION and
+// velocities and accelerations are per second and per second squared.
+// ************************************************************
+
+#ifndef TRAJECTORY_H_
+#define TRAJECTORY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+
+// The state and limits of one reference.
+typedef struct {
+    int32_t position;  // the reference to track
+    int32_t velocity;  // rate of change of the reference, per second
+    int32_t maxVelocity;  // per second
+    int32_t maxAcceleration;  // per second squared
+} trajectory_t;
+
+
+// Set the limits of a trajectory and place it at rest at position.
+void trajectoryInit(trajectory_t* trajectory, int32_t maxVelocity, int32_t maxAcceleration);
+
+
+// Place the trajectory at rest at position, e.g. when the measurement jumps.
+void trajectoryReset(trajectory_t* trajectory, int32_t position);
+
+
+// Advance the trajectory by deltaTime milliseconds towards target.
+void trajectoryUpdate(trajectory_t* trajectory, int32_t target, uint32_t deltaTime);
+
+
+// Return true if the trajectory is at rest on target.
+bool trajectoryIsDone(trajectory_t* trajectory, int32_t target);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRAJECTORY_H_ */
@@ -13,80 +13,178 @@
 #include <stdarg.h>
 #include <string.h>
 
-#include "inc/hw_memmap.h"
-#include "inc/hw_types.h"
-#include "inc/hw_ints.h"
-#include "driverlib/gpio.h"
-#include "driverlib/uart.h"
-#include "driverlib/debug.h"
 #include "stdio.h"
 #include "stdlib.h"
 #include "utils/ustdlib.h"
+#include "hal.h"
 #include "uartDisplay.h"
+#include "timerer.h"
+#include "recorder.h"
 
 
-// USB Serial comms: UART0, Rx:PA0 , Tx:PA1
-#define BAUD_RATE 9600
-#define UART_USB_BASE           UART0_BASE
-#define UART_USB_PERIPH_UART    SYSCTL_PERIPH_UART0
-#define UART_USB_PERIPH_GPIO    SYSCTL_PERIPH_GPIOA
-#define UART_USB_GPIO_BASE      GPIO_PORTA_BASE
-#define UART_USB_GPIO_PIN_RX    GPIO_PIN_0
-#define UART_USB_GPIO_PIN_TX    GPIO_PIN_1
-#define UART_USB_GPIO_PINS      UART_USB_GPIO_PIN_RX | UART_USB_GPIO_PIN_TX
+// Transmit queue. Characters are queued by uartSend and drained into the hardware FIFO
+// by the transmit interrupt so that callers never wait on the baud rate.
+#define UART_TX_BUFFER_SIZE 256  // must be a power of 2
+#define UART_TX_BUFFER_MASK (UART_TX_BUFFER_SIZE - 1)
+
+static char txBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint32_t txHead = 0;  // next free slot, only written by uartSend
+static volatile uint32_t txTail = 0;  // next char to transmit, only written while the tx interrupt is masked
+static uart_tx_stats_t txStats;
+
+// Receive queue. Filled by the receive interrupt and read with uartReadChar.
+#define UART_RX_BUFFER_SIZE 64  // must be a power of 2
+#define UART_RX_BUFFER_MASK (UART_RX_BUFFER_SIZE - 1)
+
+static char rxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint32_t rxHead = 0;  // next free slot, only written by the interrupt
+static volatile uint32_t rxTail = 0;  // next char to read, only written by uartReadChar
+static volatile uint32_t rxDropped = 0;
+
+
+// Move as many queued characters as will fit into the hardware FIFO.
+// Must only be called from the interrupt or with the tx interrupt masked.
+static void uartFillFifo(void)
+{
+    while (txTail != txHead && halUartSpaceAvail()) {
+        halUartPut(txBuffer[txTail]);
+        txTail = (txTail + 1) & UART_TX_BUFFER_MASK;
+    }
+}
+
+
+// Interrupt handler for UART0. Refills the transmit FIFO when it runs low and
+// moves received characters into the receive queue.
+void uartIntHandler(void)
+{
+    uint32_t now = timererGetTicks();
+    uint32_t status = halUartIntStatus();
+
+    if (status & HAL_UART_INT_TX) {
+        uartFillFifo();
+    }
+
+    if (status & HAL_UART_INT_RX) {
+        while (halUartCharsAvail()) {
+            char c = halUartGet();
+            uint32_t next = (rxHead + 1) & UART_RX_BUFFER_MASK;
+
+            recorderAddEvent(RECORDER_EV_UART, c, now);
+
+            if (next == rxTail) {
+                rxDropped++;  // queue full, the reader is not keeping up
+            } else {
+                rxBuffer[rxHead] = c;
+                rxHead = next;
+            }
+        }
+    }
+}
 
 
 // Configure the UART with 8 bits, 1 stop bit, no parity
 void uartInit (void)
 {
-    // reset for good measure
-    SysCtlPeripheralReset(UART_USB_PERIPH_UART);
+    // interrupts when the transmit FIFO runs low so it can be topped up
+    // and when characters are received so they can be queued
+    halUartInit(UART_BAUD_RATE, uartIntHandler);
 
-    // Enable GPIO port A which is used for UART0 pins.
-    SysCtlPeripheralEnable(UART_USB_PERIPH_UART);
-    SysCtlPeripheralEnable(UART_USB_PERIPH_GPIO);
+    uartSend("\n");  // required to start printing to remote interface
+}
 
-    // Select the alternate (UART) function for these pins.
-    GPIOPinTypeUART(UART_USB_GPIO_BASE, UART_USB_GPIO_PINS);
-    UARTConfigSetExpClk(UART_USB_BASE, SysCtlClockGet(), BAUD_RATE,
-                        UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
-                        UART_CONFIG_PAR_NONE);
-    UARTFIFOEnable(UART_USB_BASE);  // use a queue to buffer the sending data
-    UARTEnable(UART_USB_BASE);
 
-    uartSend("\n");  // required to start printing to remote interface
+// Queue a string for transmission via UART0 without blocking.
+// The whole string is dropped if there is not enough room in the transmit queue so that
+// partial lines are never sent. Returns true if the string was queued.
+bool uartSend (char *pucBuffer)
+{
+    return uartSendBytes((const uint8_t*)pucBuffer, strlen(pucBuffer));
 }
 
 
-// Transmit a string via UART0
-// The FIFO is 16 bytes so only send a 16 byte string for optimal performance
-void uartSend (char *pucBuffer)
+// Queue length bytes of binary data for transmission via UART0 without blocking.
+// Behaves as uartSend but the data may contain zero bytes.
+bool uartSendBytes(const uint8_t* data, uint32_t length)
 {
-    // Loop while there are more characters to send.
-    while(*pucBuffer)
-    {
-        // Write the next character to the UART Tx FIFO.
-        UARTCharPut(UART0_BASE, *pucBuffer);
-        pucBuffer++;
+    uint32_t used = (txHead - txTail) & UART_TX_BUFFER_MASK;
+
+    // one slot is always left empty to tell a full queue from an empty one
+    if (length > UART_TX_BUFFER_MASK - used) {
+        txStats.stringsDropped++;
+        txStats.bytesDropped += length;
+        return false;
+    }
+
+    // copy into the queue. Only txHead is shared with the interrupt and it is updated last.
+    uint32_t head = txHead;
+    uint32_t i;
+    for (i = 0; i < length; i++) {
+        txBuffer[head] = data[i];
+        head = (head + 1) & UART_TX_BUFFER_MASK;
+    }
+    txHead = head;
+
+    txStats.bytesQueued += length;
+    if (used + length > txStats.maxQueued) {
+        txStats.maxQueued = used + length;
     }
+
+    // The tx interrupt only fires when the FIFO level crosses the trigger point, so start
+    // the transfer here in case the FIFO is already empty.
+    halUartSetTxInt(false);
+    uartFillFifo();
+    halUartSetTxInt(true);
+    return true;
 }
 
 
-// Print a single formated line to the terminal and truncate if too long.
-// Takes format with arguments (like fprintf) but adds a newline to the end
-// and truncates to UART_LINE_LENGTH. An ellipsis is added to the end if the
-// line is too long. A format string is always required.
-void uartPrintLineWithFormat(const char* format, ...)
+// Return the number of characters which can currently be queued by uartSend.
+// Producers can use this to hold back output rather than have it dropped.
+uint32_t uartTxSpace(void)
 {
-    va_list args;
-    int storedChars;
-    char uartString[UART_LINE_LENGTH + 2];  // +2 for \r and \0
+    return UART_TX_BUFFER_MASK - ((txHead - txTail) & UART_TX_BUFFER_MASK);
+}
 
-    // replace using arguments
-    va_start(args, format);
-    storedChars = uvsnprintf(uartString, UART_LINE_LENGTH, format, args);
-    va_end(arg);
 
+// Return the total number of bytes queued so far, so that the difference across
+// a call shows what a producer actually sent.
+uint32_t uartTxQueued(void)
+{
+    return txStats.bytesQueued;
+}
+
+
+// Read one received character into c without blocking.
+// Returns false if no characters are waiting.
+bool uartReadChar(char* c)
+{
+    if (rxTail == rxHead) {
+        return false;
+    }
+    *c = rxBuffer[rxTail];
+    rxTail = (rxTail + 1) & UART_RX_BUFFER_MASK;
+    return true;
+}
+
+
+// Return the number of received characters dropped because the receive queue was full.
+uint32_t uartRxDropped(void)
+{
+    return rxDropped;
+}
+
+
+// Copy the transmit queue statistics into stats.
+void uartGetTxStats(uart_tx_stats_t* stats)
+{
+    *stats = txStats;
+}
+
+
+// Finish a line of storedChars characters formatted into uartString, which must have
+// room for UART_LINE_LENGTH + 2 characters, and queue it for sending.
+static void uartSendLine(char* uartString, int storedChars)
+{
     // add ellipsis if string too long
     if (storedChars >= UART_LINE_LENGTH) {
         // truncate
@@ -104,3 +202,43 @@ void uartPrintLineWithFormat(const char* format, ...)
 
     uartSend(uartString);
 }
+
+
+// Print a single formated line to the terminal and truncate if too long.
+// Takes format with arguments (like fprintf) but adds a newline to the end
+// and truncates to UART_LINE_LENGTH. An ellipsis is added to the end if the
+// line is too long. A format string is always required.
+void uartPrintLineWithFormat(const char* format, ...)
+{
+    va_list args;
+    int storedChars;
+    char uartString[UART_LINE_LENGTH + 2];  // +2 for \r and \0
+
+    // replace using arguments
+    va_start(args, format);
+    storedChars = uvsnprintf(uartString, UART_LINE_LENGTH, format, args);
+    va_end(args);
+
+    uartSendLine(uartString, storedChars);
+}
+
+
+// As uartPrintLineWithFormat, but with a format compiled by lineFormatCompile(..)
+// so that the format string is not parsed again. A format which failed to compile
+// is formatted with uvsnprintf.
+void uartPrintLineWithCompiled(const line_format_t* format, ...)
+{
+    va_list args;
+    int storedChars;
+    char uartString[UART_LINE_LENGTH + 2];  // +2 for \r and \0
+
+    va_start(args, format);
+    if (format->isCompiled) {
+        storedChars = lineFormatApply(format, uartString, UART_LINE_LENGTH, args);
+    } else {
+        storedChars = uvsnprintf(uartString, UART_LINE_LENGTH, format->format, args);
+    }
+    va_end(args);
+
+    uartSendLine(uartString, storedChars);
+}
@@ -14,21 +14,64 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#include "utils/ustdlib.h"
-#include "driverlib/gpio.h"       // defines for GPIO peripheral
-#include "driverlib/sysctl.h"     // system control functions
-#include "driverlib/systick.h"
-#include "driverlib/interrupt.h"
+#include "lineFormat.h"
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
 
 #define UART_LINE_LENGTH 25  // where should a line be truncated
+#ifndef UART_BAUD_RATE
+#define UART_BAUD_RATE 9600  // 115200 for a recording which can be replayed, see recorder.h
+#endif
+#define UART_CHARS_PER_SECOND (UART_BAUD_RATE / 10)  // 8 data bits with a start and stop bit
+
+
+// Statistics for the transmit queue.
+typedef struct {
+    uint32_t bytesQueued;  // total bytes accepted by uartSend
+    uint32_t bytesDropped;  // total bytes rejected because the queue was full
+    uint32_t stringsDropped;  // number of calls to uartSend which were rejected
+    uint32_t maxQueued;  // high water mark of the queue in bytes
+} uart_tx_stats_t;
+
 
 // Configure the UART with 8 bits, 1 stop bit, no parity
 void uartInit (void);
 
 
-// Transmit a string via UART0
-// The FIFO is 16 bytes so only send a 16 byte string for optimal performance
-void uartSend (char *pucBuffer);
+// Queue a string for transmission via UART0 without blocking.
+// The whole string is dropped if there is not enough room in the transmit queue so that
+// partial lines are never sent. Returns true if the string was queued.
+bool uartSend (char *pucBuffer);
+
+
+// Queue length bytes of binary data for transmission via UART0 without blocking.
+// Behaves as uartSend but the data may contain zero bytes.
+bool uartSendBytes(const uint8_t* data, uint32_t length);
+
+
+// Return the number of characters which can currently be queued by uartSend.
+// Producers can use this to hold back output rather than have it dropped.
+uint32_t uartTxSpace(void);
+
+
+// Return the total number of bytes queued so far, so that the difference across
+// a call shows what a producer actually sent.
+uint32_t uartTxQueued(void);
+
+
+// Read one received character into c without blocking.
+// Returns false if no characters are waiting.
+bool uartReadChar(char* c);
+
+
+// Return the number of received characters dropped because the receive queue was full.
+uint32_t uartRxDropped(void);
+
+
+// Copy the transmit queue statistics into stats.
+void uartGetTxStats(uart_tx_stats_t* stats);
 
 
 // Print a single formated line to the terminal and truncate if too long.
@@ -37,4 +80,14 @@ void uartSend (char *pucBuffer);
 // line is too long. A format string is always required.
 void uartPrintLineWithFormat(const char* format, ...);
 
+
+// As uartPrintLineWithFormat, but with a format compiled by lineFormatCompile(..)
+// so that the format string is not parsed again. A format which failed to compile
+// is formatted with uvsnprintf.
+void uartPrintLineWithCompiled(const line_format_t* format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* UARTDISPLAY_H_ */
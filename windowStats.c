@@ -0,0 +1,101 @@
+// ************************************************************
+// windowStats.c
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Mean and variance of a signal over a sliding window of time.
+// Explaination: Samples are stored with the time they cover. Running sums of
+// the samples and their squares are kept, so adding a sample and dropping the
+// oldest ones is constant time per update at a steady sample rate.
+// ************************************************************
+
+#include "windowStats.h"
+
+
+// Set the length of the window in ms and clear it.
+void windowStatsInit(window_stats_t* window, uint32_t windowTime)
+{
+    window->windowTime = windowTime;
+    windowStatsClear(window);
+}
+
+
+// Remove all samples.
+void windowStatsClear(window_stats_t* window)
+{
+    window->head = 0;
+    window->count = 0;
+    window->totalTime = 0;
+    window->sum = 0;
+    window->sumOfSquares = 0;
+}
+
+
+// Remove the oldest sample from the window and the running sums.
+static void dropOldest(window_stats_t* window)
+{
+    int32_t oldest = window->samples[window->head];
+
+    window->sum -= oldest;
+    window->sumOfSquares -= (int64_t)oldest * oldest;
+    window->totalTime -= window->durations[window->head];
+    window->head = (window->head + 1) % WINDOW_STATS_MAX_SAMPLES;
+    window->count--;
+}
+
+
+// Add a sample covering deltaTime ms, dropping samples which are now older than the window.
+void windowStatsAdd(window_stats_t* window, int32_t sample, uint32_t deltaTime)
+{
+    if (window->count == WINDOW_STATS_MAX_SAMPLES) {
+        dropOldest(window);
+    }
+
+    uint32_t index = (window->head + window->count) % WINDOW_STATS_MAX_SAMPLES;
+    window->samples[index] = sample;
+    window->durations[index] = deltaTime;
+    window->count++;
+    window->totalTime += deltaTime;
+    window->sum += sample;
+    window->sumOfSquares += (int64_t)sample * sample;
+
+    // keep just enough samples to cover the window
+    while (window->count > 1 &&
+            window->totalTime - window->durations[window->head] >= window->windowTime) {
+        dropOldest(window);
+    }
+}
+
+
+// Return true once the samples cover the whole window.
+bool windowStatsIsFull(window_stats_t* window)
+{
+    return window->totalTime >= window->windowTime;
+}
+
+
+// Return the mean of the samples in the window.
+int32_t windowStatsMean(window_stats_t* window)
+{
+    if (window->count == 0) {
+        return 0;
+    }
+    return window->sum / (int32_t)window->count;
+}
+
+
+// Return the variance of the samples in the window (in squared sample units).
+int64_t windowStatsVariance(window_stats_t* window)
+{
+    if (window->count == 0) {
+        return 0;
+    }
+    // n var = sum(x^2) - sum(x)^2 / n. With sum(x) = q n + r, sum(x)^2 / n = q (sum(x) + r) + r^2 / n,
+    // which doesn't overflow, and only the final division rounds. The sums are integers so they
+    // don't drift as samples come and go.
+    int64_t count = window->count;
+    int64_t quotient = window->sum / count;
+    int64_t remainder = window->sum - quotient * count;
+    return (window->sumOfSquares - quotient * (window->sum + remainder) - remainder * remainder / count) / count;
+}
@@ -0,0 +1,67 @@
+// ************************************************************
+// windowStats.h
+// Helicopter project
+// Group: A03 Group 10
+// Last edited: 19-10-2026
+//
+// Purpose: Mean and variance of a signal over a sliding window of time.
+// Explaination: Samples are stored with the time they cover. Running sums of
+// the samples and their squares are kept, so adding a sample and dropping the
+// oldest ones is constant time per update at a steady sample rate.
+// ************************************************************
+
+#ifndef WINDOW_STATS_H_
+#define WINDOW_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {  // also used by the host tools
+#endif
+
+#define WINDOW_STATS_MAX_SAMPLES 64  // enough for the window at the slowest sample rate used
+
+
+// A sliding window. Only use through the functions below.
+typedef struct {
+    int32_t samples[WINDOW_STATS_MAX_SAMPLES];
+    uint16_t durations[WINDOW_STATS_MAX_SAMPLES];  // ms covered by each sample
+    uint32_t head;  // oldest sample
+    uint32_t count;
+    uint32_t windowTime;  // ms the window should cover
+    uint32_t totalTime;  // ms the stored samples cover
+    int64_t sum;
+    int64_t sumOfSquares;
+} window_stats_t;
+
+
+// Set the length of the window in ms and clear it.
+void windowStatsInit(window_stats_t* window, uint32_t windowTime);
+
+
+// Remove all samples.
+void windowStatsClear(window_stats_t* window);
+
+
+// Add a sample covering deltaTime ms, dropping samples which are now older than the window.
+void windowStatsAdd(window_stats_t* window, int32_t sample, uint32_t deltaTime);
+
+
+// Return true once the samples cover the whole window.
+bool windowStatsIsFull(window_stats_t* window);
+
+
+// Return the mean of the samples in the window.
+int32_t windowStatsMean(window_stats_t* window);
+
+
+// Return the variance of the samples in the window (in squared sample units).
+int64_t windowStatsVariance(window_stats_t* window);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WINDOW_STATS_H_ */
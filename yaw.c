@@ -11,18 +11,11 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "inc/hw_memmap.h"
-#include "driverlib/gpio.h"
-#include "driverlib/sysctl.h"
+#include <stdlib.h>
+#include "hal.h"
 #include "quadratureEncoder.h"
-#include "nfclib/types.h"        // recommended by TI when using IntMasterDisable
-#include "driverlib/interrupt.h" // (and other bool type interrupt status functions)
-                                 // useful for porting code between architectures
-
-// Define constants for yaw reference GPIO pin PC4
-#define GPIO_REF_PERIPH         SYSCTL_PERIPH_GPIOC
-#define REF_PORT_BASE           GPIO_PORTC_BASE
-#define REF_PIN                 GPIO_PIN_4
+#include "timerer.h"
+#include "recorder.h"
 
 #define COUNTS_PER_ROTATION (112*4)  // 112 slots and x4 because quadrature encoding used
 #define SIGN(n) ((n) < 0 ? -1 : 1)  // give the sign of a number
@@ -34,12 +27,14 @@ static volatile bool isCalibrated;
 // Resets the yaw to zero when reference point is reached
 void yawRefIntHandler(void)
 {
+    uint32_t now = timererGetTicks();
+
     isCalibrated = true;
     quadEncoderResetCount();
+    recorderAddEvent(RECORDER_EV_YAW_REF, 0, now);
 
     // Reset and disable the interrupt
-    GPIOIntDisable(REF_PORT_BASE, REF_PIN);
-    GPIOIntClear(REF_PORT_BASE, REF_PIN);
+    halYawRefDisable();
 }
 
 
@@ -48,7 +43,7 @@ void yawRefIntHandler(void)
 void yawCalibrate(void)
 {
     isCalibrated = false;
-    GPIOIntEnable(REF_PORT_BASE, REF_PIN);
+    halYawRefEnable();
 }
 
 
@@ -65,16 +60,8 @@ void yawInit(void)
     // Initialize quadrature encoder module
     quadEncoderInit();
 
-    // Enable GPIO peripheral on used port
-    SysCtlPeripheralEnable(GPIO_REF_PERIPH);
-
-    // Configure yaw reference input pin (active LOW)
-    GPIOPadConfigSet(REF_PORT_BASE, REF_PIN, GPIO_STRENGTH_4MA, GPIO_PIN_TYPE_STD_WPU);
-    GPIODirModeSet(REF_PORT_BASE, REF_PIN, GPIO_DIR_MODE_IN);
-
-    // Initialize yaw reference interrupt but do not enable
-    GPIOIntRegister(REF_PORT_BASE, yawRefIntHandler);
-    GPIOIntTypeSet(REF_PORT_BASE, REF_PIN, GPIO_FALLING_EDGE);
+    // Configure yaw reference input pin (active LOW, PC4) and its interrupt but do not enable
+    halYawRefInit(yawRefIntHandler);
 }
 
 
@@ -94,7 +81,7 @@ int32_t yawGetDegrees(int32_t precision)
 void yawClipTo360Degrees(void)
 {
     // Start critical section
-    bool prevIntState = IntMasterDisable();
+    bool prevIntState = halInterruptsDisable();
 
     // Calculate the new encoder value and assign it.
     // If an interrupt to update the encoder count occurs during this time, it will be
@@ -106,5 +93,5 @@ void yawClipTo360Degrees(void)
 
     // Re-enable interrupts if they were enabled before
     if (!prevIntState)
-        IntMasterEnable();
+        halInterruptsEnable();
 }